@@ -0,0 +1,158 @@
+#!/bin/bash
+#
+# Throughput benchmark for sqldata with local PostgreSQL and MySQL/MariaDB instances
+#
+# Starts throwaway database instances in $WORK, generates the synthetic data sets, runs
+# sqldata -cmd=transfer and -cmd=validate for every source/target pair and data set, and
+# appends one CSV line per run to the results file:
+#
+#   commit,date,pair,set,cmd,tables,rows,bytes,elapsed_s,rows_per_s,mb_per_s,cpu_s,peak_rss_mb,failed,rc
+#
+# rows, bytes, CPU time and peak memory are taken from the final -metrics file of each run.
+# With the catalog data set, the catalog index and metadata snapshot phases timed by catalogbench
+# for the same number of tables are added with pair catalog, rows/s is tables/s of the phase.
+# Compare two results files with compare.sh.
+#
+# Usage: ./bench.sh [results_file]
+#
+# Environment (defaults in brackets):
+#   SQLDATA         sqldata executable [../../sqldata/sqldata]
+#   WORK            directory for database instances, logs and metrics [/tmp/sqldata_bench]
+#   PAIRS           source:target pairs [pg:mysql mysql:pg pg:pg mysql:mysql]
+#   SETS            data sets [narrow wide numeric lob catalog]
+#   SESSIONS        concurrent sessions, sqldata -ss option [4]
+#   NARROW_ROWS     rows in the narrow integer table [2000000]
+#   WIDE_ROWS       rows in the wide table with 20 VARCHAR(100) columns [200000]
+#   WIDE_WIDTH      characters stored in each VARCHAR column [100]
+#   NUMERIC_ROWS    rows in the table with DECIMAL, DOUBLE and BIGINT columns [1000000]
+#   LOB_ROWS        rows in the table with a TEXT column [20000]
+#   LOB_BYTES       bytes stored in each TEXT value [65536]
+#   CATALOG_TABLES  tables in the catalog data set, one row each [100000]
+#   GENERATE        set to 0 to reuse data sets generated by a previous run [1]
+#   KEEP            set to 1 to leave the database instances running [0]
+#   PG_BIN, MYSQLD  PostgreSQL bin directory and mysqld executable, found in the PATH by default
+
+cd "$(dirname "$0")"
+
+SQLDATA=${SQLDATA:-../../sqldata/sqldata}
+WORK=${WORK:-/tmp/sqldata_bench}
+PAIRS=${PAIRS:-"pg:mysql mysql:pg pg:pg mysql:mysql"}
+SETS=${SETS:-"narrow wide numeric lob catalog"}
+SESSIONS=${SESSIONS:-4}
+NARROW_ROWS=${NARROW_ROWS:-2000000}
+WIDE_ROWS=${WIDE_ROWS:-200000}
+WIDE_WIDTH=${WIDE_WIDTH:-100}
+NUMERIC_ROWS=${NUMERIC_ROWS:-1000000}
+LOB_ROWS=${LOB_ROWS:-20000}
+LOB_BYTES=${LOB_BYTES:-65536}
+CATALOG_TABLES=${CATALOG_TABLES:-100000}
+GENERATE=${GENERATE:-1}
+KEEP=${KEEP:-0}
+
+case " $SETS " in *" catalog "*) ;; *) CATALOG_TABLES=0 ;; esac
+
+. ./lib.sh
+
+COMMIT=$(git rev-parse --short HEAD 2> /dev/null || echo unknown)
+RESULTS=${1:-results/$(date +%Y%m%d_%H%M%S)_$COMMIT.csv}
+
+if [ ! -x "$SQLDATA" ]; then
+	echo "sqldata executable not found: $SQLDATA (set SQLDATA)"
+	exit 1
+fi
+
+SQLDATA=$(cd "$(dirname "$SQLDATA")" && pwd)/$(basename "$SQLDATA")
+
+mkdir -p "$WORK/runs" "$(dirname "$RESULTS")"
+
+stop()
+{
+	[ $KEEP = 1 ] && return
+	stop_pg
+	stop_mysql
+}
+
+trap stop EXIT
+
+# Start only the instances used by the pairs
+DBMS=$(echo $PAIRS | tr ' :' '\n\n' | sort -u)
+
+for dbms in $DBMS; do
+	echo "Starting $dbms in $WORK/$dbms"
+	start_$dbms || { echo "Failed to start $dbms, see logs in $WORK/$dbms"; exit 1; }
+
+	if [ $GENERATE = 1 ]; then
+		echo "Generating data sets in $dbms"
+		generate $dbms || { echo "Failed to generate data sets in $dbms"; exit 1; }
+	fi
+done
+
+[ -f "$RESULTS" ] || echo "commit,date,pair,set,cmd,tables,rows,bytes,elapsed_s,rows_per_s,mb_per_s,cpu_s,peak_rss_mb,failed,rc" > "$RESULTS"
+
+for pair in $PAIRS; do
+	s=${pair%%:*}
+	t=${pair##*:}
+
+	for set in $SETS; do
+		list="$WORK/runs/$set.txt"
+		tables $set > "$list"
+
+		for cmd in transfer validate; do
+			run="$WORK/runs/$s-$t-$set-$cmd"
+			rm -f "$run.log" "$run.prom"
+
+			opt="-topt=truncate"
+			[ $cmd = validate ] && opt="-vopt=rows"
+
+			echo "Running $cmd of $set from $s to $t"
+
+			start=$(date +%s.%N)
+
+			"$SQLDATA" -sd="$(${s}_conn bench_src)" -td="$(${t}_conn bench_tgt)" -tf="$list" -cmd=$cmd $opt \
+				-ss=$SESSIONS -log="$run.log" -metrics="$run.prom" -metrics_interval=3600 < /dev/null > "$run.out" 2>&1
+			rc=$?
+
+			end=$(date +%s.%N)
+
+			# The metrics file is written on exit, use the wall time if the run failed before writing it
+			elapsed=$(metric "$run.prom" sqldata_elapsed_seconds)
+			[ -z "$elapsed" ] && elapsed=$(awk -v s=$start -v e=$end 'BEGIN { printf "%.3f", e - s }')
+
+			rows=$(metric "$run.prom" sqldata_table_rows_written)
+			bytes=$(metric "$run.prom" sqldata_table_bytes_written)
+
+			# Validation does not write rows, count the rows compared in the source
+			[ $cmd = validate ] && rows=$(rows $set)
+			[ -z "$rows" ] && rows=0
+			[ -z "$bytes" ] && bytes=0
+
+			cpu=$(metric "$run.prom" sqldata_process_cpu_seconds)
+			rss=$(metric "$run.prom" sqldata_process_peak_rss_bytes)
+
+			failed=$(grep -c -E "Data transfer failed|Not Equal|Failed" "$run.log" 2> /dev/null)
+
+			echo "$COMMIT,$(date +%Y-%m-%dT%H:%M:%S),$s-$t,$set,$cmd,$(wc -l < "$list"),${rows%.*},${bytes%.*},$elapsed,$rows,$bytes,${cpu:-0},${rss:-0},${failed:-0},$rc" |
+				awk -F, 'BEGIN { OFS = "," } { e = ($9 > 0) ? $9 : 0.001; $10 = sprintf("%.0f", $10 / e); $11 = sprintf("%.2f", $11 / e / 1048576); $13 = sprintf("%.1f", $13 / 1048576); print }' >> "$RESULTS"
+
+			tail -1 "$RESULTS"
+		done
+	done
+done
+
+# Catalog lookups do not depend on the database, catalogbench fills the catalog lists in memory
+if [ $CATALOG_TABLES -gt 0 ]; then
+	[ -x catalogbench ] || ./build.sh || exit 1
+
+	echo "Running catalog lookups for $CATALOG_TABLES tables"
+
+	./catalogbench -tables=$CATALOG_TABLES -iter=1 -out="$WORK/runs/catalog.tsv" -commit=$COMMIT > "$WORK/runs/catalog.out" 2>&1
+	rc=$?
+
+	awk -F'\t' -v date=$(date +%Y-%m-%dT%H:%M:%S) -v rc=$rc 'NR > 1 {
+		printf "%s,%s,catalog,catalog,%s,%s,%s,0,%.3f,%s,0,0,%.1f,%d,%d\n", $1, date, $4, $2, $2, $5 / 1000, $6, $7 / 1048576, rc != 0, rc }' \
+		"$WORK/runs/catalog.tsv" >> "$RESULTS"
+
+	rm -f "$WORK/runs/catalog.tsv"
+fi
+
+echo "Results written to $RESULTS"
@@ -0,0 +1,21 @@
+#!/bin/bash
+#
+# Build the sqldata micro-benchmarks with the sqldata sources they exercise
+#
+# The include paths are the same as in sqldata/build_all64.sh.
+#
+# Usage: ./build.sh [extra g++ options, for example -g]
+
+cd "$(dirname "$0")"
+
+SRC=../../sqldata
+INC="-I$SRC -I../../sqlcommon -I$SRC/db_api_headers/oraclexe_11_2_0/oci/include -I$SRC/db_api_headers/mysql57/include 
+	-I$SRC/db_api_headers/postgresql90/include -I$SRC/db_api_headers/sybase15_0/OCS-15_0/include -I$SRC/db_api_headers/win_odbc_compat/Include"
+
+# Catalog index and metadata snapshot
+g++ -m64 -O2 "$@" $INC catalogbench.cpp $SRC/sqlapibase.cpp $SRC/sqlstdapi.cpp $SRC/applog.cpp $SRC/os.cpp $SRC/parameters.cpp \
+	$SRC/str.cpp ../../sqlcommon/file.cpp -ldl -lrt -lpthread -o catalogbench || exit 1
+
+# Date and timestamp conversion for PostgreSQL COPY and MySQL LOAD DATA
+g++ -m64 -O2 "$@" $INC convbench.cpp $SRC/sqlapibase.cpp $SRC/applog.cpp $SRC/os.cpp $SRC/parameters.cpp \
+	$SRC/str.cpp ../../sqlcommon/file.cpp -ldl -lrt -lpthread -o convbench || exit 1
@@ -0,0 +1,362 @@
+/**
+ * Copyright (c) 2016 SQLines
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Catalog benchmark: schema read and catalog lookups for a catalog of many small tables
+//
+// catalogbench [-tables=n] [-iter=n] [-out=file] [-commit=id]
+//
+// The catalog lists are filled with the rows ReadSchema gets for the bench_cat_* tables of bench.sh
+// (2 columns, primary key and its index per table), then each phase is timed:
+//
+//   read       append the catalog rows, as the ReadSchema of each API does
+//   lookup     look up the columns, constraint columns and index columns of every table, the first
+//              lookup builds the catalog index
+//   relookup   the same lookups with the index already built
+//   save       write the metadata snapshot
+//   remove     remove every 10th table from the catalog, as for tables changed since the metadata snapshot
+//   reread     look up all tables after the removal, removed tables must not be found
+//   load       read the metadata snapshot and look up all tables
+//
+// One tab-separated record per phase and iteration is appended to the -out file (or printed), tables/s is
+// the number of catalog tables divided by the phase time.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <set>
+
+#if defined(WIN32) || defined(_WIN64)
+#include <windows.h>
+#include <psapi.h>
+#define strncasecmp _strnicmp
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "sqlstdapi.h"
+
+#define CATALOG_SCHEMA		"BENCH"
+
+// Standard output API is used as it does not require a database connection
+class CatalogBench : public SqlStdApi
+{
+	int _tables;
+
+	// Get copy of the string allocated as the catalog rows of APIs
+	static char* Copy(const char *input)
+	{
+		char *out = new char[strlen(input) + 1];
+		strcpy(out, input);
+
+		return out;
+	}
+
+public:
+	CatalogBench(int tables) { _tables = tables; }
+
+	// Append the catalog rows of all tables
+	void Read()
+	{
+		char table[31], cns[31];
+
+		for(int i = 1; i <= _tables; i++)
+		{
+			sprintf(table, "bench_cat_%06d", i);
+			sprintf(cns, "bench_cat_%06d_pkey", i);
+
+			const char *columns[] = { "id", "name" };
+			const char *types[] = { "INT", "VARCHAR" };
+
+			for(int k = 0; k < 2; k++)
+			{
+				_table_columns.push_back(SqlColMeta());
+				SqlColMeta &col = _table_columns.back();
+
+				col.schema = Copy(CATALOG_SCHEMA);
+				col.table = Copy(table);
+				col.column = Copy(columns[k]);
+				col.data_type = Copy(types[k]);
+				col.num = k + 1;
+				col.nullable = (k != 0);
+				col.pk_column = (k == 0);
+			}
+
+			_table_constraints.push_back(SqlConstraints());
+			SqlConstraints &c = _table_constraints.back();
+
+			c.schema = Copy(CATALOG_SCHEMA);
+			c.table = Copy(table);
+			c.constraint = Copy(cns);
+			c.type = 'P';
+
+			_table_cons_columns.push_back(SqlConsColumns());
+			SqlConsColumns &cc = _table_cons_columns.back();
+
+			cc.schema = Copy(CATALOG_SCHEMA);
+			cc.table = Copy(table);
+			cc.constraint = Copy(cns);
+			cc.column = Copy("id");
+
+			_table_indexes.push_back(SqlIndexes());
+			SqlIndexes &idx = _table_indexes.back();
+
+			idx.schema = Copy(CATALOG_SCHEMA);
+			idx.index = Copy(cns);
+			idx.t_schema = Copy(CATALOG_SCHEMA);
+			idx.t_name = Copy(table);
+			idx.unique = true;
+
+			_table_ind_columns.push_back(SqlIndColumns());
+			SqlIndColumns &ic = _table_ind_columns.back();
+
+			ic.schema = Copy(CATALOG_SCHEMA);
+			ic.index = Copy(cns);
+			ic.column = Copy("id");
+		}
+	}
+
+	// Look up all tables as the DDL of each table is generated, returns the number of tables not found, -1 on error
+	int Lookup(int removed_every)
+	{
+		char table[31];
+		int missing = 0;
+
+		for(int i = 1; i <= _tables; i++)
+		{
+			sprintf(table, "bench_cat_%06d", i);
+
+			SqlTableCatalog *catalog = GetCatalogTable(CATALOG_SCHEMA, table);
+			bool removed = (removed_every > 0 && i % removed_every == 0);
+
+			if(catalog == NULL)
+			{
+				if(!removed)
+					return -1;
+
+				missing++;
+				continue;
+			}
+
+			if(removed || catalog->columns.size() != 2 || catalog->constraints.size() != 1 || catalog->indexes.size() != 1)
+				return -1;
+
+			std::vector<SqlConsColumns*> *cns_columns = GetCatalogConstraintColumns(CATALOG_SCHEMA, catalog->constraints[0]->constraint);
+			std::vector<SqlIndColumns*> *ind_columns = GetCatalogIndexColumns(CATALOG_SCHEMA, catalog->indexes[0]->index);
+
+			if(cns_columns == NULL || cns_columns->size() != 1 || ind_columns == NULL || ind_columns->size() != 1)
+				return -1;
+		}
+
+		return missing;
+	}
+
+	// Remove every n-th table
+	void Remove(int every)
+	{
+		std::set<std::string> tables;
+		std::string key;
+		char table[31];
+
+		for(int i = every; i <= _tables; i += every)
+		{
+			sprintf(table, "bench_cat_%06d", i);
+			GetCatalogKey(CATALOG_SCHEMA, table, key);
+			tables.insert(key);
+		}
+
+		RemoveSchemaTables(tables);
+	}
+};
+
+// Get the current time in seconds
+static double GetTime()
+{
+#if defined(WIN32) || defined(_WIN64)
+	LARGE_INTEGER freq, count;
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+
+	return (double)count.QuadPart/(double)freq.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	return (double)tv.tv_sec + (double)tv.tv_usec/1000000.0;
+#endif
+}
+
+// Get peak resident memory of the process in bytes
+static size_t GetPeakRss()
+{
+#if defined(WIN32) || defined(_WIN64)
+	PROCESS_MEMORY_COUNTERS pmc;
+
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return (size_t)pmc.PeakWorkingSetSize;
+
+	return 0;
+#else
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	// Linux reports the maximum resident set size in kilobytes
+	return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+// Get the option value if the argument is -name=value
+static const char* GetOption(const char *arg, const char *name)
+{
+	size_t len = strlen(name);
+
+	if(strncasecmp(arg, name, len) == 0 && arg[len] == '=')
+		return arg + len + 1;
+
+	return NULL;
+}
+
+// Write the record of a phase
+static void Report(FILE *out, const char *commit, int tables, int iter, const char *phase, double start)
+{
+	double time = GetTime() - start;
+
+	if(time <= 0)
+		time = 0.000001;
+
+	fprintf(out, "%s\t%d\t%d\t%s\t%.3f\t%.0f\t%.0f\n", commit, tables, iter, phase, time * 1000.0, (double)tables/time, (double)GetPeakRss());
+	fflush(out);
+}
+
+int main(int argc, char** argv)
+{
+	const char *out_file = NULL, *commit = "";
+	int tables = 100000, iter = 3;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *value = NULL;
+
+		if((value = GetOption(argv[i], "-tables")) != NULL)
+			tables = atoi(value);
+		else
+		if((value = GetOption(argv[i], "-iter")) != NULL)
+			iter = atoi(value);
+		else
+		if((value = GetOption(argv[i], "-out")) != NULL)
+			out_file = value;
+		else
+		if((value = GetOption(argv[i], "-commit")) != NULL)
+			commit = value;
+		else
+		{
+			printf("Usage: catalogbench [-tables=n] [-iter=n] [-out=file] [-commit=id]\n");
+			return -1;
+		}
+	}
+
+	if(tables < 10 || iter < 1)
+	{
+		printf("Usage: catalogbench [-tables=n] [-iter=n] [-out=file] [-commit=id]\n");
+		return -1;
+	}
+
+	FILE *out = stdout;
+	bool header = true;
+
+	if(out_file != NULL)
+	{
+		FILE *exists = fopen(out_file, "r");
+
+		if(exists != NULL)
+		{
+			header = false;
+			fclose(exists);
+		}
+
+		out = fopen(out_file, "a");
+
+		if(out == NULL)
+		{
+			printf("Cannot open %s\n", out_file);
+			return -1;
+		}
+	}
+
+	if(header)
+		fprintf(out, "commit\ttables\titeration\tphase\ttime_ms\ttables_per_sec\tpeak_rss_bytes\n");
+
+	char snapshot[64];
+#if defined(WIN32) || defined(_WIN64)
+	sprintf(snapshot, "catalogbench.%lu.meta", (unsigned long)GetCurrentProcessId());
+#else
+	sprintf(snapshot, "catalogbench.%lu.meta", (unsigned long)getpid());
+#endif
+
+	const int every = 10;
+	int rc = 0;
+
+	for(int k = 1; k <= iter && rc == 0; k++)
+	{
+		CatalogBench *bench = new CatalogBench(tables);
+
+		double start = GetTime();
+		bench->Read();
+		Report(out, commit, tables, k, "read", start);
+
+		start = GetTime();
+		rc = (bench->Lookup(0) == 0) ? 0 : -1;
+		Report(out, commit, tables, k, "lookup", start);
+
+		start = GetTime();
+		rc = (rc == 0 && bench->Lookup(0) == 0) ? 0 : -1;
+		Report(out, commit, tables, k, "relookup", start);
+
+		start = GetTime();
+		rc = (rc == 0 && bench->SaveSchemaCache(snapshot, "bench", "bench") == 0) ? 0 : -1;
+		Report(out, commit, tables, k, "save", start);
+
+		start = GetTime();
+		bench->Remove(every);
+		Report(out, commit, tables, k, "remove", start);
+
+		start = GetTime();
+		rc = (rc == 0 && bench->Lookup(every) == tables/every) ? 0 : -1;
+		Report(out, commit, tables, k, "reread", start);
+
+		std::string fingerprint;
+
+		start = GetTime();
+		rc = (rc == 0 && bench->LoadSchemaCache(snapshot, "bench", fingerprint) == 0 && bench->Lookup(0) == 0) ? 0 : -1;
+		Report(out, commit, tables, k, "load", start);
+
+		remove(snapshot);
+		delete bench;
+	}
+
+	if(rc != 0)
+		printf("Catalog lookup returned wrong objects\n");
+
+	if(out != stdout)
+		fclose(out);
+
+	return rc;
+}
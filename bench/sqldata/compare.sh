@@ -0,0 +1,61 @@
+#!/bin/bash
+#
+# Compare two results files written by bench.sh
+#
+# Prints rows/s, MB/s, CPU time and peak memory of each run in both files and marks runs where
+# rows/s dropped or CPU time or peak memory grew by more than the threshold. Exits with 1 if
+# any run regressed or failed.
+#
+# Usage: ./compare.sh base.csv new.csv [threshold_percent, 10 by default]
+
+if [ $# -lt 2 ]; then
+	echo "Usage: $0 base.csv new.csv [threshold_percent]"
+	exit 2
+fi
+
+awk -F, -v threshold=${3:-10} '
+	FNR == 1 { next }
+	# The last run of each pair, data set and command in the file is used
+	NR == FNR { base[$3","$4","$5] = $0; next }
+	{
+		key = $3","$4","$5
+		order[++n] = key
+		cur[key] = $0
+	}
+	function change(old, new) { return (old > 0) ? (new - old) * 100 / old : 0 }
+	END {
+		printf "%-24s %-9s %12s %12s %8s %9s %9s %8s %9s %9s %8s  %s\n", "pair/set", "cmd", "rows/s", "base", "%", "MB/s", "cpu_s", "%", "rss_mb", "base", "%", ""
+		bad = 0
+
+		for(i = 1; i <= n; i++)
+		{
+			key = order[i]
+
+			if(seen[key]++)
+				continue
+
+			split(cur[key], c, ",")
+			note = ""
+
+			if(!(key in base))
+			{
+				printf "%-24s %-9s %12s %12s %8s %9s %9s %8s %9s %9s %8s  %s\n", c[3]"/"c[4], c[5], c[10], "-", "-", c[11], c[12], "-", c[13], "-", "-", "new"
+				continue
+			}
+
+			split(base[key], b, ",")
+
+			r = change(b[10], c[10]); p = change(b[12], c[12]); m = change(b[13], c[13])
+
+			if(r < -threshold) note = note " rows/s"
+			if(p > threshold) note = note " cpu"
+			if(m > threshold) note = note " rss"
+			if(note != "") note = "REGRESSION:" note
+			if(c[14] > 0 || c[15] != 0) note = note " FAILED"
+			if(note != "") bad = 1
+
+			printf "%-24s %-9s %12s %12s %+7.1f%% %9s %9s %+7.1f%% %9s %9s %+7.1f%%  %s\n", c[3]"/"c[4], c[5], c[10], b[10], r, c[11], c[12], p, c[13], b[13], m, note
+		}
+
+		exit bad
+	}' "$1" "$2"
@@ -0,0 +1,321 @@
+/**
+ * Copyright (c) 2016 SQLines
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Conversion benchmark: date and timestamp columns converted to text for PostgreSQL COPY and MySQL LOAD DATA
+//
+// convbench [-rows=n] [-batch=n] [-iter=n] [-out=file] [-commit=id]
+//
+// A fetched column array of -batch rows is filled with Oracle DATE (7-byte binary) or ODBC SQL_TIMESTAMP_STRUCT
+// values and written as COPY rows -rows/-batch times. Conversion pairs and paths:
+//
+//   ora_date   row          Str::OraDate2Str for each cell inside the row loop, as before the batch conversion
+//              batch        SqlApiBase::OraDatesToStr for the column array, then copy of the text in the row loop
+//   odbc_ts    row_sprintf  Str::SqlTs2Str for each cell with the fraction formatted by sprintf, as before
+//              row          Str::SqlTs2Str for each cell inside the row loop
+//              batch        SqlApiBase::OdbcTimestampsToStr for the column array, then copy of the text in the row loop
+//
+// The output of each path is compared with the batch path, a difference is an error. One tab-separated record
+// per pair, path and iteration is appended to the -out file (or printed), values/s is rows divided by the time.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(WIN32) || defined(_WIN64)
+#include <windows.h>
+#define strncasecmp _strnicmp
+#else
+#include <sys/time.h>
+#endif
+
+#include <sql.h>
+#include "sqlapibase.h"
+#include "str.h"
+
+// Conversion pairs and paths
+#define CONV_ORA_DATE			1
+#define CONV_ODBC_TS			2
+
+#define CONV_PATH_ROW_SPRINTF	1
+#define CONV_PATH_ROW			2
+#define CONV_PATH_BATCH			3
+
+// Get the current time in seconds
+static double GetTime()
+{
+#if defined(WIN32) || defined(_WIN64)
+	LARGE_INTEGER freq, count;
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+
+	return (double)count.QuadPart/(double)freq.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	return (double)tv.tv_sec + (double)tv.tv_usec/1000000.0;
+#endif
+}
+
+// Get the option value if the argument is -name=value
+static const char* GetOption(const char *arg, const char *name)
+{
+	size_t len = strlen(name);
+
+	if(strncasecmp(arg, name, len) == 0 && arg[len] == '=')
+		return arg + len + 1;
+
+	return NULL;
+}
+
+// Fill the column array with distinct date and time values
+static void Fill(SqlCol *col, int pair, size_t rows)
+{
+	for(size_t i = 0; i < rows; i++)
+	{
+		int year = 1900 + (int)(i % 200);
+		int month = 1 + (int)(i % 12);
+		int day = 1 + (int)(i % 28);
+		int hour = (int)(i % 24);
+		int minute = (int)(i % 60);
+		int second = (int)((i / 60) % 60);
+
+		if(pair == CONV_ORA_DATE)
+		{
+			unsigned char *data = (unsigned char*)col->_data + col->_fetch_len * i;
+
+			data[0] = (unsigned char)(year/100 + 100);
+			data[1] = (unsigned char)(year%100 + 100);
+			data[2] = (unsigned char)month;
+			data[3] = (unsigned char)day;
+			data[4] = (unsigned char)(hour + 1);
+			data[5] = (unsigned char)(minute + 1);
+			data[6] = (unsigned char)(second + 1);
+		}
+		else
+		{
+			SQL_TIMESTAMP_STRUCT *ts = (SQL_TIMESTAMP_STRUCT*)col->_data + i;
+
+			ts->year = (SQLSMALLINT)year;
+			ts->month = (SQLUSMALLINT)month;
+			ts->day = (SQLUSMALLINT)day;
+			ts->hour = (SQLUSMALLINT)hour;
+			ts->minute = (SQLUSMALLINT)minute;
+			ts->second = (SQLUSMALLINT)second;
+
+			// Every 4th value without fraction
+			ts->fraction = (i % 4 == 0) ? 0 : (SQLUINTEGER)((i * 7919) % 1000000);
+		}
+	}
+}
+
+// Conversion kernels are protected members of the API base class, no API object is created
+class ConvBench : public SqlApiBase
+{
+public:
+	static size_t Write(SqlCol *col, int pair, int path, size_t rows, char *conv, char *out);
+};
+
+// Write the batch as COPY rows, returns the number of bytes written
+size_t ConvBench::Write(SqlCol *col, int pair, int path, size_t rows, char *conv, char *out)
+{
+	size_t len = (pair == CONV_ORA_DATE) ? SQLDATA_ORA_DATE_STR_LEN : SQLDATA_ODBC_TS_STR_LEN;
+	char *cur = out;
+
+	if(path == CONV_PATH_BATCH)
+	{
+		if(pair == CONV_ORA_DATE)
+			OraDatesToStr(col, rows, conv);
+		else
+			OdbcTimestampsToStr(col, rows, 1, true, conv);
+	}
+
+	for(size_t i = 0; i < rows; i++)
+	{
+		if(path == CONV_PATH_BATCH)
+			memcpy(cur, conv + len * i, len);
+		else
+		if(pair == CONV_ORA_DATE)
+			Str::OraDate2Str((unsigned char*)col->_data + col->_fetch_len * i, cur);
+		else
+		{
+			SQL_TIMESTAMP_STRUCT *ts = (SQL_TIMESTAMP_STRUCT*)col->_data + i;
+			long fraction = (long)ts->fraction;
+
+			if(path == CONV_PATH_ROW_SPRINTF)
+			{
+				Str::SqlTs2Str((short)ts->year, (short)ts->month, (short)ts->day, (short)ts->hour, (short)ts->minute, (short)ts->second, 0, cur);
+
+				if(fraction != 0 && fraction < 1000000)
+					sprintf(cur + 20, "%06ld", fraction);
+			}
+			else
+				Str::SqlTs2Str((short)ts->year, (short)ts->month, (short)ts->day, (short)ts->hour, (short)ts->minute, (short)ts->second, fraction, cur);
+		}
+
+		cur += len;
+		*cur++ = '\n';
+	}
+
+	return (size_t)(cur - out);
+}
+
+int main(int argc, char** argv)
+{
+	const char *out_file = NULL, *commit = "";
+	int rows = 10000000, batch = 10000, iter = 3;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *value = NULL;
+
+		if((value = GetOption(argv[i], "-rows")) != NULL)
+			rows = atoi(value);
+		else
+		if((value = GetOption(argv[i], "-batch")) != NULL)
+			batch = atoi(value);
+		else
+		if((value = GetOption(argv[i], "-iter")) != NULL)
+			iter = atoi(value);
+		else
+		if((value = GetOption(argv[i], "-out")) != NULL)
+			out_file = value;
+		else
+		if((value = GetOption(argv[i], "-commit")) != NULL)
+			commit = value;
+		else
+		{
+			printf("Usage: convbench [-rows=n] [-batch=n] [-iter=n] [-out=file] [-commit=id]\n");
+			return -1;
+		}
+	}
+
+	if(rows < 1 || batch < 1 || iter < 1)
+	{
+		printf("Usage: convbench [-rows=n] [-batch=n] [-iter=n] [-out=file] [-commit=id]\n");
+		return -1;
+	}
+
+	FILE *out = stdout;
+	bool header = true;
+
+	if(out_file != NULL)
+	{
+		FILE *exists = fopen(out_file, "r");
+
+		if(exists != NULL)
+		{
+			header = false;
+			fclose(exists);
+		}
+
+		out = fopen(out_file, "a");
+
+		if(out == NULL)
+		{
+			printf("Cannot open %s\n", out_file);
+			return -1;
+		}
+	}
+
+	if(header)
+		fprintf(out, "commit\trows\tbatch\titeration\tpair\tpath\ttime_ms\tvalues_per_sec\tchecksum\n");
+
+	struct { int pair; int path; const char *pair_name; const char *path_name; } runs[] =
+	{
+		{ CONV_ORA_DATE, CONV_PATH_ROW, "ora_date", "row" },
+		{ CONV_ORA_DATE, CONV_PATH_BATCH, "ora_date", "batch" },
+		{ CONV_ODBC_TS, CONV_PATH_ROW_SPRINTF, "odbc_ts", "row_sprintf" },
+		{ CONV_ODBC_TS, CONV_PATH_ROW, "odbc_ts", "row" },
+		{ CONV_ODBC_TS, CONV_PATH_BATCH, "odbc_ts", "batch" }
+	};
+
+	SqlCol ora_date, odbc_ts;
+
+	ora_date._fetch_len = 7;
+	ora_date._data = new char[ora_date._fetch_len * batch];
+	Fill(&ora_date, CONV_ORA_DATE, (size_t)batch);
+
+	odbc_ts._fetch_len = sizeof(SQL_TIMESTAMP_STRUCT);
+	odbc_ts._data = new char[odbc_ts._fetch_len * batch];
+	Fill(&odbc_ts, CONV_ODBC_TS, (size_t)batch);
+
+	// Conversion buffer as allocated by InitBulkTransfer, and COPY rows with the delimiter
+	char *conv = new char[(size_t)batch * SQLDATA_ODBC_TS_STR_LEN + 1];
+	char *copy = new char[(size_t)batch * (SQLDATA_ODBC_TS_STR_LEN + 1) + 1];
+	char *expected = new char[(size_t)batch * (SQLDATA_ODBC_TS_STR_LEN + 1) + 1];
+
+	int rc = 0;
+
+	for(size_t r = 0; r < sizeof(runs)/sizeof(runs[0]) && rc == 0; r++)
+	{
+		SqlCol *col = (runs[r].pair == CONV_ORA_DATE) ? &ora_date : &odbc_ts;
+
+		// Check the output against the batch path
+		size_t expected_len = ConvBench::Write(col, runs[r].pair, CONV_PATH_BATCH, (size_t)batch, conv, expected);
+		size_t len = ConvBench::Write(col, runs[r].pair, runs[r].path, (size_t)batch, conv, copy);
+
+		if(len != expected_len || memcmp(copy, expected, len) != 0)
+		{
+			printf("Conversion %s %s returned wrong text\n", runs[r].pair_name, runs[r].path_name);
+			rc = -1;
+			break;
+		}
+
+		for(int k = 1; k <= iter; k++)
+		{
+			unsigned long checksum = 0;
+			int done = 0;
+
+			double start = GetTime();
+
+			while(done < rows)
+			{
+				int count = (rows - done < batch) ? rows - done : batch;
+
+				len = ConvBench::Write(col, runs[r].pair, runs[r].path, (size_t)count, conv, copy);
+
+				// Use the output, so the conversion is not optimized away
+				checksum += (unsigned long)len + (unsigned char)copy[len/2];
+				done += count;
+			}
+
+			double time = GetTime() - start;
+
+			if(time <= 0)
+				time = 0.000001;
+
+			fprintf(out, "%s\t%d\t%d\t%d\t%s\t%s\t%.3f\t%.0f\t%lu\n", commit, rows, batch, k, runs[r].pair_name,
+				runs[r].path_name, time * 1000.0, (double)rows/time, checksum);
+			fflush(out);
+		}
+	}
+
+	delete [] ora_date._data;
+	delete [] odbc_ts._data;
+	delete [] conv;
+	delete [] copy;
+	delete [] expected;
+
+	ora_date._data = NULL;
+	odbc_ts._data = NULL;
+
+	if(out != stdout)
+		fclose(out);
+
+	return rc;
+}
@@ -0,0 +1,208 @@
+# Functions used by bench.sh: local database instances and synthetic data sets
+
+PG_PORT=${PG_PORT:-55432}
+MYSQL_PORT=${MYSQL_PORT:-53306}
+
+# Connection strings in sqldata format for the source and target database of each instance
+pg_conn() { echo "pg,bench@127.0.0.1:$PG_PORT,$1"; }
+mysql_conn() { echo "mysql,bench@127.0.0.1:$MYSQL_PORT,$1"; }
+
+pg_sql() { psql -q -X -v ON_ERROR_STOP=1 -h "$WORK/pg" -p $PG_PORT -U bench -d "$1"; }
+mysql_sql() { mysql --socket="$WORK/mysql/mysql.sock" -u root "$1"; }
+
+# Start a throwaway PostgreSQL instance in $WORK/pg
+start_pg()
+{
+	local bin=${PG_BIN:-$(ls -d /usr/lib/postgresql/*/bin 2>/dev/null | sort -V | tail -1)}
+	[ -n "$bin" ] && PATH="$bin:$PATH"
+
+	if [ ! -f "$WORK/pg/data/PG_VERSION" ]; then
+		mkdir -p "$WORK/pg"
+		initdb -D "$WORK/pg/data" -U bench --auth=trust -E UTF8 > "$WORK/pg/initdb.log" || return 1
+	fi
+
+	pg_ctl -D "$WORK/pg/data" -l "$WORK/pg/server.log" -w \
+		-o "-p $PG_PORT -k $WORK/pg -c listen_addresses=127.0.0.1 -c fsync=off" start > /dev/null || return 1
+
+	for db in bench_src bench_tgt; do
+		psql -q -X -h "$WORK/pg" -p $PG_PORT -U bench -d postgres -c "CREATE DATABASE $db" 2> /dev/null
+	done
+
+	return 0
+}
+
+stop_pg()
+{
+	[ -f "$WORK/pg/data/postmaster.pid" ] && pg_ctl -D "$WORK/pg/data" -m fast -w stop > /dev/null
+}
+
+# Start a throwaway MySQL or MariaDB instance in $WORK/mysql
+start_mysql()
+{
+	local mysqld=${MYSQLD:-$(command -v mysqld || command -v mariadbd || ls /usr/sbin/mysqld /usr/sbin/mariadbd 2>/dev/null | head -1)}
+
+	[ -z "$mysqld" ] && return 1
+
+	if [ ! -d "$WORK/mysql/data/mysql" ]; then
+		mkdir -p "$WORK/mysql/data"
+
+		if "$mysqld" --version | grep -qi mariadb; then
+			$(command -v mariadb-install-db || command -v mysql_install_db) --no-defaults --datadir="$WORK/mysql/data" \
+				--auth-root-authentication-method=normal > "$WORK/mysql/init.log" 2>&1 || return 1
+		else
+			"$mysqld" --no-defaults --initialize-insecure --datadir="$WORK/mysql/data" > "$WORK/mysql/init.log" 2>&1 || return 1
+		fi
+	fi
+
+	# sqldata loads MySQL tables with LOAD DATA LOCAL INFILE
+	"$mysqld" --no-defaults --datadir="$WORK/mysql/data" --socket="$WORK/mysql/mysql.sock" --port=$MYSQL_PORT \
+		--bind-address=127.0.0.1 --pid-file="$WORK/mysql/mysqld.pid" --local-infile=1 \
+		--innodb-flush-log-at-trx-commit=0 --skip-log-bin --log-error="$WORK/mysql/server.log" > /dev/null 2>&1 &
+
+	for i in $(seq 60); do
+		mysqladmin --socket="$WORK/mysql/mysql.sock" -u root ping > /dev/null 2>&1 && break
+		sleep 1
+	done
+
+	mysql --socket="$WORK/mysql/mysql.sock" -u root -e \
+		"CREATE DATABASE IF NOT EXISTS bench_src; CREATE DATABASE IF NOT EXISTS bench_tgt; SET GLOBAL local_infile = 1;
+		 CREATE USER IF NOT EXISTS 'bench'@'%'; GRANT ALL ON *.* TO 'bench'@'%'" || return 1
+}
+
+stop_mysql()
+{
+	[ -S "$WORK/mysql/mysql.sock" ] && mysqladmin --socket="$WORK/mysql/mysql.sock" -u root shutdown > /dev/null 2>&1
+}
+
+# Column list c01..cNN with the specified type
+columns()
+{
+	local n=$1 type=$2 i
+	for i in $(seq -f "%02g" 1 $n); do printf ", c%s %s" $i "$type"; done
+}
+
+# Table definitions are the same in the source and target, so sqldata only truncates the target (-topt=truncate)
+create_tables()
+{
+	local dbms=$1 text=TEXT
+
+	[ $dbms = mysql ] && text=LONGTEXT
+
+	cat <<EOF
+DROP TABLE IF EXISTS bench_narrow;
+DROP TABLE IF EXISTS bench_wide;
+DROP TABLE IF EXISTS bench_numeric;
+DROP TABLE IF EXISTS bench_lob;
+CREATE TABLE bench_narrow (id INT NOT NULL PRIMARY KEY, v INT);
+CREATE TABLE bench_wide (id INT NOT NULL PRIMARY KEY $(columns 20 "VARCHAR(100)"));
+CREATE TABLE bench_numeric (id INT NOT NULL PRIMARY KEY $(columns 8 "DECIMAL(18,4)"), f1 DOUBLE PRECISION, b1 BIGINT);
+CREATE TABLE bench_lob (id INT NOT NULL PRIMARY KEY, doc $text);
+EOF
+}
+
+# Catalog of many small tables with one row each, the transfer cost is dominated by per-table overhead
+create_catalog()
+{
+	local dbms=$1 rows=$2 i
+
+	for i in $(seq -f "%06g" 1 $CATALOG_TABLES); do
+		echo "DROP TABLE IF EXISTS bench_cat_$i;"
+		echo "CREATE TABLE bench_cat_$i (id INT NOT NULL PRIMARY KEY, name VARCHAR(30));"
+		[ $rows = 1 ] && echo "INSERT INTO bench_cat_$i VALUES (1, 'bench_cat_$i');"
+	done
+}
+
+# Source rows, generated by the database itself
+fill_pg()
+{
+	local i list
+
+	echo "INSERT INTO bench_narrow SELECT g, g % 1000 FROM generate_series(1, $NARROW_ROWS) g;"
+
+	list=""
+	for i in $(seq 1 20); do list="$list, substr(repeat(md5((g * 20 + $i)::text), 4), 1, $WIDE_WIDTH)"; done
+	echo "INSERT INTO bench_wide SELECT g $list FROM generate_series(1, $WIDE_ROWS) g;"
+
+	list=""
+	for i in $(seq 1 8); do list="$list, ((g % 100000000) * 1.2345 + $i)::numeric(18,4)"; done
+	echo "INSERT INTO bench_numeric SELECT g $list, g / 7.0, g::bigint * 1000003 FROM generate_series(1, $NUMERIC_ROWS) g;"
+
+	echo "INSERT INTO bench_lob SELECT g, repeat(md5(g::text), $LOB_BYTES / 32) FROM generate_series(1, $LOB_ROWS) g;"
+	echo "ANALYZE;"
+}
+
+fill_mysql()
+{
+	local i list max=$NARROW_ROWS d=1 seq="a0.d"
+
+	# Sequence 1..N built from cross joins of digits, works on MySQL and MariaDB versions without recursive CTE
+	for n in $WIDE_ROWS $NUMERIC_ROWS $LOB_ROWS; do [ $n -gt $max ] && max=$n; done
+	while [ $(( 10 ** d )) -lt $max ]; do seq="$seq + a$d.d * $(( 10 ** d ))"; d=$(( d + 1 )); done
+
+	echo "DROP TABLE IF EXISTS bench_digits; DROP TABLE IF EXISTS bench_seq;"
+	echo "CREATE TABLE bench_digits (d INT); INSERT INTO bench_digits VALUES (0),(1),(2),(3),(4),(5),(6),(7),(8),(9);"
+	echo "CREATE TABLE bench_seq (g INT NOT NULL PRIMARY KEY);"
+	printf "INSERT INTO bench_seq SELECT $seq + 1 FROM bench_digits a0"
+	for i in $(seq 1 $(( d - 1 ))); do printf ", bench_digits a$i"; done
+	echo " WHERE $seq < $max;"
+
+	echo "INSERT INTO bench_narrow SELECT g, g % 1000 FROM bench_seq WHERE g <= $NARROW_ROWS;"
+
+	list=""
+	for i in $(seq 1 20); do list="$list, SUBSTR(REPEAT(MD5(g * 20 + $i), 4), 1, $WIDE_WIDTH)"; done
+	echo "INSERT INTO bench_wide SELECT g $list FROM bench_seq WHERE g <= $WIDE_ROWS;"
+
+	list=""
+	for i in $(seq 1 8); do list="$list, CAST(MOD(g, 100000000) * 1.2345 + $i AS DECIMAL(18,4))"; done
+	echo "INSERT INTO bench_numeric SELECT g $list, g / 7.0, CAST(g AS SIGNED) * 1000003 FROM bench_seq WHERE g <= $NUMERIC_ROWS;"
+
+	echo "INSERT INTO bench_lob SELECT g, REPEAT(MD5(g), $LOB_BYTES DIV 32) FROM bench_seq WHERE g <= $LOB_ROWS;"
+	echo "DROP TABLE bench_digits; DROP TABLE bench_seq;"
+}
+
+# Create the tables in both databases of the instance and fill the source
+generate()
+{
+	local dbms=$1
+
+	if [ $dbms = pg ]; then
+		create_tables pg | pg_sql bench_tgt && { create_tables pg; fill_pg; } | pg_sql bench_src || return 1
+	else
+		create_tables mysql | mysql_sql bench_tgt && { create_tables mysql; fill_mysql; } | mysql_sql bench_src || return 1
+	fi
+
+	if [ $CATALOG_TABLES -gt 0 ]; then
+		create_catalog $dbms 0 | ${dbms}_sql bench_tgt || return 1
+		create_catalog $dbms 1 | ${dbms}_sql bench_src || return 1
+	fi
+}
+
+# Tables of each data set, one per line as expected by -tf
+tables()
+{
+	case $1 in
+		narrow) echo bench_narrow ;;
+		wide) echo bench_wide ;;
+		numeric) echo bench_numeric ;;
+		lob) echo bench_lob ;;
+		catalog) seq -f "bench_cat_%06g" 1 $CATALOG_TABLES ;;
+	esac
+}
+
+# Rows in the source tables of each data set
+rows()
+{
+	case $1 in
+		narrow) echo $NARROW_ROWS ;;
+		wide) echo $WIDE_ROWS ;;
+		numeric) echo $NUMERIC_ROWS ;;
+		lob) echo $LOB_ROWS ;;
+		catalog) echo $CATALOG_TABLES ;;
+	esac
+}
+
+# Sum of all samples of the metric in the Prometheus text file written by sqldata -metrics
+metric()
+{
+	awk -v name="$2" '$1 == name || index($1, name "{") == 1 { sum += $NF; found = 1 } END { if(found) printf "%.3f", sum }' "$1" 2> /dev/null
+}
@@ -0,0 +1,160 @@
+#!/bin/bash
+#
+# Slow-link benchmark for the -source_compress and -target_compress options of sqldata
+#
+# Starts the same throwaway database instances as bench.sh, then delays and rate-limits the traffic
+# of the MySQL/MariaDB port on the loopback interface with tc netem, and transfers each data set with
+# and without protocol compression for every link profile. Only the MySQL/MariaDB API supports
+# compression (libpq has none), so only the traffic of its port is shaped.
+#
+# One CSV line per run is appended to the results file in the bench.sh format, so two results files
+# can be compared with compare.sh. The pair is source-target@link, cmd is transfer or transfer_compress.
+#
+# Requires root (or CAP_NET_ADMIN) for tc, the qdisc is removed from the loopback interface on exit.
+#
+# Usage: ./netem.sh [results_file]
+#
+# Environment (defaults in brackets):
+#   LINKS           netem link profiles separated by ; ["delay 20ms rate 100mbit;delay 50ms rate 20mbit"]
+#   PAIRS           source:target pairs, one side must be mysql [mysql:pg pg:mysql]
+#   SETS            data sets [wide numeric]
+#   WIDE_ROWS, NUMERIC_ROWS, NARROW_ROWS, LOB_ROWS, LOB_BYTES, SESSIONS, WORK, SQLDATA, GENERATE, KEEP
+#                   as in bench.sh, with smaller row counts by default
+
+cd "$(dirname "$0")"
+
+SQLDATA=${SQLDATA:-../../sqldata/sqldata}
+WORK=${WORK:-/tmp/sqldata_bench}
+LINKS=${LINKS:-"delay 20ms rate 100mbit;delay 50ms rate 20mbit"}
+PAIRS=${PAIRS:-"mysql:pg pg:mysql"}
+SETS=${SETS:-"wide numeric"}
+SESSIONS=${SESSIONS:-4}
+NARROW_ROWS=${NARROW_ROWS:-200000}
+WIDE_ROWS=${WIDE_ROWS:-50000}
+WIDE_WIDTH=${WIDE_WIDTH:-100}
+NUMERIC_ROWS=${NUMERIC_ROWS:-200000}
+LOB_ROWS=${LOB_ROWS:-2000}
+LOB_BYTES=${LOB_BYTES:-65536}
+CATALOG_TABLES=0
+GENERATE=${GENERATE:-1}
+KEEP=${KEEP:-0}
+
+. ./lib.sh
+
+COMMIT=$(git rev-parse --short HEAD 2> /dev/null || echo unknown)
+RESULTS=${1:-results/$(date +%Y%m%d_%H%M%S)_${COMMIT}_netem.csv}
+
+if [ ! -x "$SQLDATA" ]; then
+	echo "sqldata executable not found: $SQLDATA (set SQLDATA)"
+	exit 1
+fi
+
+if ! command -v tc > /dev/null; then
+	echo "tc not found, install iproute2"
+	exit 1
+fi
+
+SQLDATA=$(cd "$(dirname "$SQLDATA")" && pwd)/$(basename "$SQLDATA")
+
+mkdir -p "$WORK/runs" "$(dirname "$RESULTS")"
+
+# Delay and rate-limit packets to and from the MySQL port, other loopback traffic goes to the default bands
+shape()
+{
+	tc qdisc del dev lo root 2> /dev/null
+	tc qdisc add dev lo root handle 1: prio bands 4 || return 1
+	tc qdisc add dev lo parent 1:4 handle 40: netem $1 || return 1
+	tc filter add dev lo parent 1: protocol ip prio 1 u32 match ip dport $MYSQL_PORT 0xffff flowid 1:4 || return 1
+	tc filter add dev lo parent 1: protocol ip prio 1 u32 match ip sport $MYSQL_PORT 0xffff flowid 1:4 || return 1
+}
+
+unshape()
+{
+	tc qdisc del dev lo root 2> /dev/null
+}
+
+stop()
+{
+	unshape
+	[ $KEEP = 1 ] && return
+	stop_pg
+	stop_mysql
+}
+
+trap stop EXIT
+
+DBMS=$(echo $PAIRS | tr ' :' '\n\n' | sort -u)
+
+for dbms in $DBMS; do
+	echo "Starting $dbms in $WORK/$dbms"
+	start_$dbms || { echo "Failed to start $dbms, see logs in $WORK/$dbms"; exit 1; }
+
+	if [ $GENERATE = 1 ]; then
+		echo "Generating data sets in $dbms"
+		generate $dbms || { echo "Failed to generate data sets in $dbms"; exit 1; }
+	fi
+done
+
+[ -f "$RESULTS" ] || echo "commit,date,pair,set,cmd,tables,rows,bytes,elapsed_s,rows_per_s,mb_per_s,cpu_s,peak_rss_mb,failed,rc" > "$RESULTS"
+
+IFS=';' read -r -a links <<< "$LINKS"
+
+for link in "${links[@]}"; do
+	echo "Shaping port $MYSQL_PORT: $link"
+	shape "$link" || { echo "Failed to set netem qdisc on lo (root required)"; exit 1; }
+
+	for pair in $PAIRS; do
+		s=${pair%%:*}
+		t=${pair##*:}
+
+		# Compression is requested for the MySQL side of the pair
+		compress=
+		[ $s = mysql ] && compress="-source_compress=yes"
+		[ $t = mysql ] && compress="$compress -target_compress=yes"
+
+		for set in $SETS; do
+			list="$WORK/runs/$set.txt"
+			tables $set > "$list"
+
+			for cmd in transfer transfer_compress; do
+				run="$WORK/runs/netem-$s-$t-$set-$cmd"
+				rm -f "$run.log" "$run.prom"
+
+				opt=
+				[ $cmd = transfer_compress ] && opt=$compress
+
+				echo "Running $cmd of $set from $s to $t"
+
+				start=$(date +%s.%N)
+
+				"$SQLDATA" -sd="$(${s}_conn bench_src)" -td="$(${t}_conn bench_tgt)" -tf="$list" -cmd=transfer -topt=truncate $opt \
+					-ss=$SESSIONS -log="$run.log" -metrics="$run.prom" -metrics_interval=3600 < /dev/null > "$run.out" 2>&1
+				rc=$?
+
+				end=$(date +%s.%N)
+
+				elapsed=$(metric "$run.prom" sqldata_elapsed_seconds)
+				[ -z "$elapsed" ] && elapsed=$(awk -v s=$start -v e=$end 'BEGIN { printf "%.3f", e - s }')
+
+				rows=$(metric "$run.prom" sqldata_table_rows_written)
+				bytes=$(metric "$run.prom" sqldata_table_bytes_written)
+				[ -z "$rows" ] && rows=0
+				[ -z "$bytes" ] && bytes=0
+
+				cpu=$(metric "$run.prom" sqldata_process_cpu_seconds)
+				rss=$(metric "$run.prom" sqldata_process_peak_rss_bytes)
+
+				failed=$(grep -c -E "Data transfer failed|Failed" "$run.log" 2> /dev/null)
+
+				echo "$COMMIT,$(date +%Y-%m-%dT%H:%M:%S),$s-$t@${link// /_},$set,$cmd,$(wc -l < "$list"),${rows%.*},${bytes%.*},$elapsed,$rows,$bytes,${cpu:-0},${rss:-0},${failed:-0},$rc" |
+					awk -F, 'BEGIN { OFS = "," } { e = ($9 > 0) ? $9 : 0.001; $10 = sprintf("%.0f", $10 / e); $11 = sprintf("%.2f", $11 / e / 1048576); $13 = sprintf("%.1f", $13 / 1048576); print }' >> "$RESULTS"
+
+				tail -1 "$RESULTS"
+			done
+		done
+	done
+
+	unshape
+done
+
+echo "Results written to $RESULTS"
@@ -0,0 +1,18 @@
+#!/bin/bash
+#
+# Build sqlparser as an optimized static library and link the benchmark driver with it
+#
+# Usage: ./build.sh [extra g++ options, for example -g]
+
+cd "$(dirname "$0")"
+mkdir -p obj
+
+for f in ../../sqlparser/*.cpp; do
+	# -fpermissive: the sources have pointer and integer comparisons that newer compilers reject
+	g++ -m64 -O2 -fpermissive -w "$@" -c $f -o obj/$(basename $f .cpp).o || exit 1
+done
+
+rm -f obj/sqlparser.a
+ar rcs obj/sqlparser.a obj/*.o
+
+g++ -m64 -O2 "$@" -I../../sqlparser parserbench.cpp obj/sqlparser.a -o parserbench
@@ -0,0 +1,56 @@
+#!/bin/bash
+#
+# Compare two results files written by run.sh
+#
+# Prints tokens/s, allocations of a conversion and peak memory for each file and source/target pair
+# and marks conversions where tokens/s dropped or allocations or peak memory grew by more than the
+# threshold. Exits with 1 if any conversion regressed.
+#
+# Usage: ./compare.sh base.tsv new.tsv [threshold_percent, 10 by default]
+
+if [ $# -lt 2 ]; then
+	echo "Usage: $0 base.tsv new.tsv [threshold_percent]"
+	exit 2
+fi
+
+awk -F'\t' -v threshold=${3:-10} '
+	FNR == 1 { next }
+	# Generated files are in a work directory, so files are matched by name
+	function key(f) { n = split($4, p, "/"); return $2 ":" $3 " " p[n] }
+	NR == FNR { base[key()] = $0; next }
+	{
+		k = key()
+		if(!(k in cur)) order[++n_order] = k
+		cur[k] = $0
+	}
+	function change(old, new) { return (old > 0) ? (new - old) * 100 / old : 0 }
+	END {
+		printf "%-45s %12s %12s %8s %12s %8s %9s %8s  %s\n", "pair file", "tokens/s", "base", "%", "allocs", "%", "rss_mb", "%", ""
+		bad = 0
+
+		for(i = 1; i <= n_order; i++)
+		{
+			k = order[i]
+			split(cur[k], c, "\t")
+
+			if(!(k in base))
+			{
+				printf "%-45s %12s %12s %8s %12s %8s %9.1f %8s  %s\n", k, c[11], "-", "-", c[12], "-", c[14] / 1048576, "-", "new"
+				continue
+			}
+
+			split(base[k], b, "\t")
+
+			r = change(b[11], c[11]); a = change(b[12], c[12]); m = change(b[14], c[14])
+			note = ""
+
+			if(r < -threshold) note = note " tokens/s"
+			if(a > threshold) note = note " allocs"
+			if(m > threshold) note = note " rss"
+			if(note != "") { note = "REGRESSION:" note; bad = 1 }
+
+			printf "%-45s %12s %12s %+7.1f%% %12s %+7.1f%% %9.1f %+7.1f%%  %s\n", k, c[11], b[11], r, c[12], a, c[14] / 1048576, m, note
+		}
+
+		exit bad
+	}' "$1" "$2"
@@ -0,0 +1,34 @@
+CREATE TABLE sales (
+  id INTEGER NOT NULL GENERATED ALWAYS AS IDENTITY (START WITH 1, INCREMENT BY 1),
+  region VARCHAR(30),
+  amount DECIMAL(12,2) WITH DEFAULT 0,
+  sold TIMESTAMP WITH DEFAULT CURRENT TIMESTAMP,
+  doc CLOB(1M),
+  PRIMARY KEY (id)
+) IN userspace1;
+
+CREATE PROCEDURE update_sales (IN p_region VARCHAR(30), OUT p_count INTEGER)
+LANGUAGE SQL
+BEGIN
+  DECLARE v_amount DECIMAL(12,2) DEFAULT 0;
+  DECLARE v_id INTEGER;
+  DECLARE SQLSTATE CHAR(5);
+  DECLARE at_end INT DEFAULT 0;
+  DECLARE c1 CURSOR WITH HOLD FOR SELECT id, amount FROM sales WHERE region = p_region;
+  DECLARE CONTINUE HANDLER FOR NOT FOUND SET at_end = 1;
+  SET p_count = 0;
+  OPEN c1;
+  fetch_loop: LOOP
+    FETCH c1 INTO v_id, v_amount;
+    IF at_end = 1 THEN
+      LEAVE fetch_loop;
+    END IF;
+    SET p_count = p_count + 1;
+    UPDATE sales SET amount = v_amount * 1.05, sold = CURRENT TIMESTAMP WHERE id = v_id;
+  END LOOP;
+  CLOSE c1;
+  VALUES (CURRENT DATE) INTO v_amount;
+  SELECT COALESCE(SUM(amount), 0) INTO v_amount FROM sales FETCH FIRST 1 ROWS ONLY;
+END@
+
+SELECT region, DAYS(CURRENT DATE) - DAYS(sold), SUBSTR(region, 1, 3), VARCHAR_FORMAT(sold, 'YYYY-MM-DD') FROM sales WITH UR;
@@ -0,0 +1,26 @@
+CREATE TABLE items (
+  id SERIAL NOT NULL,
+  descr LVARCHAR(2000),
+  price MONEY(10,2),
+  added DATETIME YEAR TO SECOND DEFAULT CURRENT YEAR TO SECOND,
+  PRIMARY KEY (id)
+);
+
+CREATE PROCEDURE upd_items(p_pct DECIMAL(5,2)) RETURNING INTEGER;
+  DEFINE v_id INTEGER;
+  DEFINE v_price MONEY(10,2);
+  DEFINE v_cnt INTEGER;
+  LET v_cnt = 0;
+  FOREACH c1 FOR SELECT id, price INTO v_id, v_price FROM items
+    LET v_cnt = v_cnt + 1;
+    IF v_price > 100 THEN
+      UPDATE items SET price = v_price * (1 + p_pct / 100) WHERE id = v_id;
+    END IF;
+  END FOREACH;
+  ON EXCEPTION SET sql_err
+    RETURN -1;
+  END EXCEPTION;
+  RETURN v_cnt;
+END PROCEDURE;
+
+SELECT FIRST 10 id, NVL(descr, 'n/a'), TODAY, MDY(1, 1, 2020) FROM items WHERE added > CURRENT - 1 UNITS DAY;
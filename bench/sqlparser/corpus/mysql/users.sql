@@ -0,0 +1,29 @@
+CREATE TABLE `users` (
+  `id` INT UNSIGNED NOT NULL AUTO_INCREMENT,
+  `login` VARCHAR(50) NOT NULL,
+  `created` DATETIME DEFAULT CURRENT_TIMESTAMP,
+  `bio` LONGTEXT,
+  `score` DOUBLE,
+  PRIMARY KEY (`id`),
+  KEY `idx_login` (`login`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+DELIMITER //
+CREATE PROCEDURE add_score(IN p_login VARCHAR(50), IN p_delta INT)
+BEGIN
+  DECLARE v_id INT;
+  DECLARE done INT DEFAULT FALSE;
+  DECLARE cur CURSOR FOR SELECT id FROM users WHERE login LIKE CONCAT(p_login, '%');
+  DECLARE CONTINUE HANDLER FOR NOT FOUND SET done = TRUE;
+  OPEN cur;
+  read_loop: LOOP
+    FETCH cur INTO v_id;
+    IF done THEN
+      LEAVE read_loop;
+    END IF;
+    UPDATE users SET score = IFNULL(score, 0) + p_delta, created = NOW() WHERE id = v_id;
+  END LOOP;
+  CLOSE cur;
+  SELECT DATE_FORMAT(NOW(), '%Y-%m-%d'), LIMIT_TEST FROM users LIMIT 10;
+END //
+DELIMITER ;
@@ -0,0 +1,84 @@
+CREATE TABLE emp (
+  id NUMBER(10) NOT NULL,
+  name VARCHAR2(100 CHAR),
+  salary NUMBER(12,2) DEFAULT 0,
+  hired DATE DEFAULT SYSDATE,
+  notes CLOB,
+  photo BLOB,
+  dept_id NUMBER(5),
+  CONSTRAINT pk_emp PRIMARY KEY (id)
+);
+
+CREATE INDEX idx_emp_name ON emp (name);
+
+CREATE SEQUENCE emp_seq START WITH 1 INCREMENT BY 1 NOCACHE;
+
+CREATE OR REPLACE PACKAGE BODY hr_pkg AS
+  PROCEDURE raise_salary(p_id IN NUMBER, p_pct IN NUMBER DEFAULT 10) IS
+    v_sal emp.salary%TYPE;
+    v_name VARCHAR2(100);
+    v_cnt NUMBER := 0;
+    CURSOR c_emp IS SELECT id, name, salary FROM emp WHERE dept_id = p_id;
+    rec c_emp%ROWTYPE;
+  BEGIN
+    SELECT salary, name INTO v_sal, v_name FROM emp WHERE id = p_id;
+    IF v_sal IS NULL THEN
+      v_sal := NVL(v_sal, 0);
+    ELSIF v_sal > 1000 THEN
+      v_sal := v_sal * (1 + p_pct / 100);
+    END IF;
+    OPEN c_emp;
+    LOOP
+      FETCH c_emp INTO rec;
+      EXIT WHEN c_emp%NOTFOUND;
+      v_cnt := v_cnt + 1;
+      UPDATE emp SET salary = rec.salary * 1.1, hired = TO_DATE('2020-01-01', 'YYYY-MM-DD') WHERE id = rec.id;
+    END LOOP;
+    CLOSE c_emp;
+    FOR r IN (SELECT e.id, e.name FROM emp e, dept d WHERE e.dept_id = d.id(+) AND ROWNUM < 10) LOOP
+      DBMS_OUTPUT.PUT_LINE('Emp: ' || r.name || ' ' || TO_CHAR(SYSDATE, 'YYYY-MM-DD HH24:MI:SS'));
+    END LOOP;
+    v_name := SUBSTR(v_name, 1, 10) || DECODE(v_cnt, 0, 'none', 1, 'one', 'many');
+    INSERT INTO emp (id, name, salary) VALUES (emp_seq.NEXTVAL, v_name, v_sal);
+    COMMIT;
+  EXCEPTION
+    WHEN NO_DATA_FOUND THEN
+      RAISE_APPLICATION_ERROR(-20001, 'Not found ' || p_id);
+    WHEN OTHERS THEN
+      ROLLBACK;
+      RAISE;
+  END raise_salary;
+
+  FUNCTION get_total(p_dept IN NUMBER) RETURN NUMBER IS
+    v_total NUMBER;
+  BEGIN
+    SELECT SUM(NVL(salary, 0)) INTO v_total FROM emp WHERE dept_id = p_dept;
+    RETURN v_total;
+  END;
+END hr_pkg;
+/
+
+CREATE OR REPLACE TRIGGER emp_bi BEFORE INSERT ON emp FOR EACH ROW
+BEGIN
+  IF :NEW.id IS NULL THEN
+    SELECT emp_seq.NEXTVAL INTO :NEW.id FROM dual;
+  END IF;
+  :new.hired := SYSTIMESTAMP;
+END;
+/
+
+CREATE OR REPLACE VIEW emp_v AS SELECT id, name, ADD_MONTHS(hired, 12) h, LENGTH(name) l, INSTR(name, 'a') p FROM emp WHERE hired > SYSDATE - 30;
+
+SELECT TRUNC(SYSDATE), LPAD(name, 20, '*'), NVL2(salary, 1, 0) FROM emp ORDER BY 1 NULLS FIRST;
+
+DECLARE
+  TYPE t_tab IS TABLE OF NUMBER INDEX BY PLS_INTEGER;
+  v_tab t_tab;
+  i PLS_INTEGER;
+BEGIN
+  FOR i IN 1..10 LOOP
+    v_tab(i) := i * 2;
+  END LOOP;
+  EXECUTE IMMEDIATE 'TRUNCATE TABLE emp';
+END;
+/
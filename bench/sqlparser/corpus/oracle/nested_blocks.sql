@@ -0,0 +1,55 @@
+CREATE OR REPLACE PROCEDURE nested_p(p_id IN NUMBER, P_Name VARCHAR2) AS
+  v_x NUMBER := 1;
+  v_y VARCHAR2(10);
+  emp_rec emp%ROWTYPE;
+  dept_rec dept%ROWTYPE;
+  CURSOR c1 IS SELECT * FROM emp;
+  CURSOR c2(p NUMBER) IS SELECT * FROM dept WHERE id = p;
+  e_custom EXCEPTION;
+BEGIN
+  v_x := p_id;
+  DECLARE
+    v_x VARCHAR2(20) := 'inner';
+    v_z NUMBER;
+  BEGIN
+    v_x := v_x || 'a';
+    v_z := LENGTH(v_x);
+    DECLARE
+      v_z DATE := SYSDATE;
+    BEGIN
+      v_z := v_z + 1;
+      V_X := 'deep';
+    END;
+    v_z := v_z + 1;
+  END;
+  v_x := v_x + 1;
+  SELECT * INTO emp_rec FROM emp WHERE id = p_id;
+  v_y := emp_rec.name;
+  Emp_Rec.salary := emp_rec.salary * 2;
+  dept_rec.name := p_name;
+  OPEN c1;
+  FETCH c1 INTO emp_rec;
+  CLOSE c1;
+  FOR r IN c1 LOOP
+    v_y := r.name;
+  END LOOP;
+  FOR c2 IN c2(1) LOOP
+    NULL;
+  END LOOP;
+  IF v_x > 10 THEN
+    RAISE e_custom;
+  END IF;
+EXCEPTION
+  WHEN e_custom THEN
+    v_y := 'x';
+END;
+/
+CREATE OR REPLACE FUNCTION f2(a NUMBER) RETURN NUMBER IS
+  emp_rec emp%ROWTYPE;
+  v_x NUMBER;
+BEGIN
+  SELECT * INTO emp_rec FROM emp WHERE id = a;
+  v_x := emp_rec.id + a;
+  RETURN v_x;
+END;
+/
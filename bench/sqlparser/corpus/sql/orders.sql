@@ -0,0 +1,68 @@
+CREATE TABLE [dbo].[orders] (
+  [id] INT IDENTITY(1,1) NOT NULL,
+  [customer] NVARCHAR(100) NULL,
+  [amount] MONEY DEFAULT 0,
+  [created] DATETIME DEFAULT GETDATE(),
+  [flag] BIT,
+  [data] VARBINARY(MAX),
+  CONSTRAINT [PK_orders] PRIMARY KEY CLUSTERED ([id] ASC)
+)
+GO
+
+CREATE PROCEDURE dbo.usp_process_orders
+  @customer NVARCHAR(100),
+  @min_amount MONEY = 0,
+  @total MONEY OUTPUT
+AS
+BEGIN
+  SET NOCOUNT ON;
+  DECLARE @id INT, @amount MONEY, @cnt INT = 0
+  DECLARE @msg VARCHAR(200)
+
+  DECLARE cur CURSOR FOR SELECT id, amount FROM orders WHERE customer = @customer AND amount > @min_amount
+  OPEN cur
+  FETCH NEXT FROM cur INTO @id, @amount
+  WHILE @@FETCH_STATUS = 0
+  BEGIN
+    SET @cnt = @cnt + 1
+    SELECT @total = ISNULL(@total, 0) + @amount
+    IF @amount > 1000
+      UPDATE orders SET flag = 1, created = GETDATE() WHERE id = @id
+    ELSE
+    BEGIN
+      SET @msg = 'Order ' + CAST(@id AS VARCHAR(10)) + ' small'
+      PRINT @msg
+    END
+    FETCH NEXT FROM cur INTO @id, @amount
+  END
+  CLOSE cur
+  DEALLOCATE cur
+
+  SELECT TOP 10 customer, SUM(amount) AS s, CONVERT(VARCHAR(10), MAX(created), 120) d
+  FROM orders WITH (NOLOCK)
+  GROUP BY customer
+  HAVING COUNT(*) > 1
+
+  IF @@ROWCOUNT = 0
+    RAISERROR('No rows', 16, 1)
+
+  BEGIN TRY
+    INSERT INTO orders (customer, amount) VALUES (@customer, DATEDIFF(day, GETDATE(), '2020-01-01'))
+    SELECT @id = SCOPE_IDENTITY()
+  END TRY
+  BEGIN CATCH
+    SELECT ERROR_MESSAGE()
+  END CATCH
+  RETURN @cnt
+END
+GO
+
+CREATE FUNCTION dbo.fn_len(@s VARCHAR(100)) RETURNS INT
+AS
+BEGIN
+  RETURN LEN(LTRIM(RTRIM(@s))) + CHARINDEX('a', @s)
+END
+GO
+
+SELECT o.id, o.customer, DATEADD(dd, 1, o.created) FROM orders o INNER JOIN customers c ON o.customer = c.name WHERE o.amount BETWEEN 1 AND 100
+GO
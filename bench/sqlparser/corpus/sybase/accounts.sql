@@ -0,0 +1,20 @@
+create table accounts (id int identity, owner varchar(50) null, balance money default 0, opened datetime default getdate())
+go
+create procedure sp_transfer @from int, @to int, @amt money
+as
+begin
+  declare @bal money
+  select @bal = balance from accounts where id = @from
+  if @bal < @amt
+  begin
+    raiserror 20001 'Insufficient funds'
+    return 1
+  end
+  begin tran
+  update accounts set balance = balance - @amt where id = @from
+  update accounts set balance = balance + @amt where id = @to
+  commit tran
+  select convert(varchar(10), getdate(), 101), datepart(yy, opened), isnull(owner, '') from accounts
+  return 0
+end
+go
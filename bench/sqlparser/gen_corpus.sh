@@ -0,0 +1,110 @@
+#!/bin/bash
+#
+# Generate the large corpus files that are too big to keep in the repository
+#
+# The output depends only on the parameters, so every run converts the same input:
+#   oracle/ddl_tables.sql   Oracle DDL dump: tables with columns, primary keys, indexes and comments
+#   oracle/pkg_large.sql    Oracle package specification and body with many procedures and functions
+#
+# Usage: ./gen_corpus.sh output_dir [tables, 50000 by default] [procedures, 2000 by default]
+
+if [ -z "$1" ]; then
+	echo "Usage: $0 output_dir [tables] [procedures]"
+	exit 1
+fi
+
+mkdir -p "$1/oracle"
+
+awk -v tables=${2:-50000} 'BEGIN {
+	split("NUMBER(10)|VARCHAR2(200)|NUMBER(12,2)|DATE|CHAR(1)|VARCHAR2(30 CHAR)|TIMESTAMP(6)|CLOB|RAW(16)|NUMBER", types, "|")
+	split(" NOT NULL| DEFAULT 0|| NOT NULL| DEFAULT SYSDATE NOT NULL", attrs, "|")
+
+	for(i = 1; i <= tables; i++)
+	{
+		cols = 3 + i % 12
+		printf "CREATE TABLE scott.tab_%d (\n  id NUMBER(10) NOT NULL,\n", i
+
+		for(c = 1; c <= cols; c++)
+		{
+			type = types[1 + (i * 7 + c) % 10]
+			attr = (type == "DATE") ? attrs[5] : (type ~ /^NUMBER/) ? attrs[1 + (i + c) % 3] : attrs[3 + (i + c) % 2]
+			printf "  col_%d %s%s,\n", c, type, attr
+		}
+
+		printf "  CONSTRAINT pk_tab_%d PRIMARY KEY (id)\n) TABLESPACE users PCTFREE 10 STORAGE (INITIAL 64K NEXT 1M);\n", i
+		printf "CREATE INDEX ix_tab_%d_1 ON scott.tab_%d (col_1, col_2);\n", i, i
+
+		if(i > 1 && i % 5 == 0)
+			printf "ALTER TABLE scott.tab_%d ADD CONSTRAINT fk_tab_%d FOREIGN KEY (col_1) REFERENCES scott.tab_%d (id) ON DELETE CASCADE;\n", i, i, i - 1
+
+		printf "COMMENT ON TABLE scott.tab_%d IS '\''Table %d'\'';\n", i, i
+		printf "COMMENT ON COLUMN scott.tab_%d.id IS '\''Identifier of table %d'\'';\n\n", i, i
+	}
+}' > "$1/oracle/ddl_tables.sql"
+
+awk -v procs=${3:-2000} 'BEGIN {
+	print "CREATE OR REPLACE PACKAGE large_pkg AS"
+
+	for(i = 1; i <= procs; i++)
+		if(i % 4 == 0)
+			printf "  FUNCTION f_%d(p_id IN NUMBER, p_name IN VARCHAR2 DEFAULT NULL) RETURN NUMBER;\n", i
+		else
+			printf "  PROCEDURE p_%d(p_id IN NUMBER, p_name IN VARCHAR2, p_out OUT NUMBER);\n", i
+
+	print "END large_pkg;\n/\n\nCREATE OR REPLACE PACKAGE BODY large_pkg AS"
+	print "  g_count NUMBER := 0;"
+	print "  TYPE t_ids IS TABLE OF NUMBER INDEX BY PLS_INTEGER;\n"
+
+	for(i = 1; i <= procs; i++)
+	{
+		if(i % 4 == 0)
+		{
+			printf "  FUNCTION f_%d(p_id IN NUMBER, p_name IN VARCHAR2 DEFAULT NULL) RETURN NUMBER IS\n", i
+			print  "    v_total NUMBER := 0;"
+			print  "    v_name VARCHAR2(100);"
+			print  "  BEGIN"
+			printf "    SELECT NVL(SUM(salary), 0), MAX(name) INTO v_total, v_name FROM emp WHERE dept_id = p_id AND hired > ADD_MONTHS(SYSDATE, -%d);\n", i % 24 + 1
+			print  "    IF p_name IS NOT NULL AND INSTR(v_name, p_name) > 0 THEN"
+			printf "      v_total := v_total + DECODE(MOD(p_id, 3), 0, %d, 1, LENGTH(p_name), 0);\n", i
+			print  "    END IF;"
+			print  "    RETURN ROUND(v_total, 2);"
+			print  "  EXCEPTION"
+			print  "    WHEN NO_DATA_FOUND THEN"
+			print  "      RETURN 0;"
+			printf "  END f_%d;\n\n", i
+			continue
+		}
+
+		printf "  PROCEDURE p_%d(p_id IN NUMBER, p_name IN VARCHAR2, p_out OUT NUMBER) IS\n", i
+		print  "    v_sal emp.salary%TYPE;"
+		print  "    v_cnt PLS_INTEGER := 0;"
+		print  "    v_ids t_ids;"
+		print  "    v_msg VARCHAR2(4000);"
+		printf "    CURSOR c_emp IS SELECT id, name, salary FROM emp WHERE dept_id = p_id AND ROWNUM <= %d;\n", i % 50 + 10
+		print  "  BEGIN"
+		print  "    FOR r IN c_emp LOOP"
+		print  "      v_cnt := v_cnt + 1;"
+		print  "      v_ids(v_cnt) := r.id;"
+		print  "      v_sal := NVL(r.salary, 0) * (1 + MOD(v_cnt, 10) / 100);"
+		print  "      UPDATE emp SET salary = v_sal, updated = SYSTIMESTAMP WHERE id = r.id;"
+		print  "    END LOOP;"
+		print  "    v_msg := '\''Processed '\'' || TO_CHAR(v_cnt) || '\'' rows for '\'' || SUBSTR(p_name, 1, 30) || '\'' at '\'' || TO_CHAR(SYSDATE, '\''YYYY-MM-DD HH24:MI:SS'\'');"
+		print  "    INSERT INTO audit_log (id, msg, created) VALUES (audit_seq.NEXTVAL, v_msg, SYSDATE);"
+		printf "    IF v_cnt > %d THEN\n", i % 20
+		print  "      EXECUTE IMMEDIATE '\''DELETE FROM emp_tmp WHERE dept_id = :1'\'' USING p_id;"
+		print  "    ELSIF v_cnt = 0 THEN"
+		print  "      RAISE_APPLICATION_ERROR(-20001, '\''No employees in '\'' || p_id);"
+		print  "    END IF;"
+		print  "    g_count := g_count + v_cnt;"
+		print  "    p_out := v_cnt;"
+		print  "  EXCEPTION"
+		print  "    WHEN DUP_VAL_ON_INDEX THEN"
+		print  "      p_out := -1;"
+		print  "    WHEN OTHERS THEN"
+		print  "      ROLLBACK;"
+		print  "      RAISE;"
+		printf "  END p_%d;\n\n", i
+	}
+
+	print "END large_pkg;\n/"
+}' > "$1/oracle/pkg_large.sql"
@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) 2016 SQLines
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Conversion benchmark driver linked with the sqlparser static library
+//
+// parserbench -s=source -t=target [-repeat=n] [-iter=n] [-out=file] [-commit=id] file [...n]
+//
+// Each file is repeated -repeat times to build the input, converted once to warm up, and then
+// converted -iter times. One tab-separated record per file is appended to the -out file (or printed):
+// average time of a conversion, MB/s, tokens/s, heap allocations and allocated bytes of a conversion,
+// and peak resident memory of the process.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <new>
+
+#ifdef WIN32
+#include <windows.h>
+#include <psapi.h>
+#define strncasecmp _strnicmp
+#define strcasecmp _stricmp
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+#include "sqlparser.h"
+
+// All allocations of the parser go through new and new[], they are counted while a conversion runs
+static bool count_allocs = false;
+static size_t allocs = 0;
+static size_t alloc_bytes = 0;
+
+void* operator new(size_t size)
+{
+	if(count_allocs)
+	{
+		allocs++;
+		alloc_bytes += size;
+	}
+
+	void *p = malloc(size != 0 ? size : 1);
+
+	if(p == NULL)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+	free(p);
+}
+
+struct ParserType
+{
+	const char *name;
+	short type;
+};
+
+// Names accepted by -s and -t, the same as in sqlines
+static ParserType types[] = {
+	{ "sql", SQL_SQL_SERVER }, { "oracle", SQL_ORACLE }, { "db2", SQL_DB2 }, { "mysql", SQL_MYSQL },
+	{ "postgresql", SQL_POSTGRESQL }, { "sybase", SQL_SYBASE }, { "informix", SQL_INFORMIX },
+	{ "greenplum", SQL_GREENPLUM }, { "asa", SQL_SYBASE_ASA }, { "teradata", SQL_TERADATA },
+	{ "netezza", SQL_NETEZZA }, { "mariadb", SQL_MARIADB }, { "mariadb_ora", SQL_MARIADB_ORA },
+	{ "hive", SQL_HIVE }, { "redshift", SQL_REDSHIFT }, { "esgyndb", SQL_ESGYNDB }, { "ads", SQL_SYBASE_ADS }
+};
+
+// Get parser type by name, 0 if the name is unknown
+static short GetType(const char *name)
+{
+	for(size_t i = 0; i < sizeof(types)/sizeof(types[0]); i++)
+	{
+		if(strcasecmp(name, types[i].name) == 0)
+			return types[i].type;
+	}
+
+	return 0;
+}
+
+// Get the current time in seconds
+static double GetTime()
+{
+#ifdef WIN32
+	LARGE_INTEGER freq, count;
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+
+	return (double)count.QuadPart/(double)freq.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	return (double)tv.tv_sec + (double)tv.tv_usec/1000000.0;
+#endif
+}
+
+// Get peak resident memory of the process in bytes
+static size_t GetPeakRss()
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return (size_t)pmc.PeakWorkingSetSize;
+
+	return 0;
+#else
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	// Linux reports the maximum resident set size in kilobytes
+	return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+// Read the file content
+static int ReadFile(const char *file, std::string &content)
+{
+	FILE *in = fopen(file, "rb");
+
+	if(in == NULL)
+		return -1;
+
+	char buf[65536];
+	size_t len = 0;
+
+	while((len = fread(buf, 1, sizeof(buf), in)) > 0)
+		content.append(buf, len);
+
+	fclose(in);
+
+	return 0;
+}
+
+// Get the option value if the argument is -name=value
+static const char* GetOption(const char *arg, const char *name)
+{
+	size_t len = strlen(name);
+
+	if(strncasecmp(arg, name, len) == 0 && arg[len] == '=')
+		return arg + len + 1;
+
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	const char *s = NULL, *t = NULL, *out_file = NULL, *commit = "";
+	int repeat = 1, iter = 5;
+	int files = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char *value = NULL;
+
+		if((value = GetOption(argv[i], "-s")) != NULL)
+			s = value;
+		else
+		if((value = GetOption(argv[i], "-t")) != NULL)
+			t = value;
+		else
+		if((value = GetOption(argv[i], "-repeat")) != NULL)
+			repeat = atoi(value);
+		else
+		if((value = GetOption(argv[i], "-iter")) != NULL)
+			iter = atoi(value);
+		else
+		if((value = GetOption(argv[i], "-out")) != NULL)
+			out_file = value;
+		else
+		if((value = GetOption(argv[i], "-commit")) != NULL)
+			commit = value;
+		else
+		if(argv[i][0] != '-')
+			files++;
+	}
+
+	short source = (s != NULL) ? GetType(s) : 0;
+	short target = (t != NULL) ? GetType(t) : 0;
+
+	if(source == 0 || target == 0 || files == 0 || repeat < 1 || iter < 1)
+	{
+		printf("Usage: parserbench -s=source -t=target [-repeat=n] [-iter=n] [-out=file] [-commit=id] file [...n]\n");
+		return -1;
+	}
+
+	FILE *out = stdout;
+	bool header = true;
+
+	if(out_file != NULL)
+	{
+		FILE *exists = fopen(out_file, "r");
+
+		if(exists != NULL)
+		{
+			header = false;
+			fclose(exists);
+		}
+
+		out = fopen(out_file, "a");
+
+		if(out == NULL)
+		{
+			printf("Cannot open %s\n", out_file);
+			return -1;
+		}
+	}
+
+	if(header)
+		fprintf(out, "commit\tsource\ttarget\tfile\tbytes\tlines\ttokens\titerations\ttime_ms\tmb_per_sec\ttokens_per_sec\tallocs\talloc_bytes\tpeak_rss_bytes\n");
+
+	int rc = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(argv[i][0] == '-')
+			continue;
+
+		std::string content, input;
+
+		if(ReadFile(argv[i], content) == -1)
+		{
+			printf("Cannot read %s\n", argv[i]);
+			rc = -1;
+			continue;
+		}
+
+		for(int r = 0; r < repeat; r++)
+		{
+			input += content;
+			input += '\n';
+		}
+
+		// One parser converts all iterations of the file, as sqlines converts all files with one parser
+		SqlParser *parser = new SqlParser();
+		parser->SetTypes(source, target);
+
+		const char *output = NULL;
+		int out_size = 0, lines = 0;
+
+		// Warm up
+		parser->Convert(input.c_str(), (int)input.size(), &output, &out_size, &lines);
+		delete [] output;
+
+		double time = 0;
+		size_t tokens = 0;
+
+		allocs = 0;
+		alloc_bytes = 0;
+
+		for(int k = 0; k < iter; k++)
+		{
+			double start = GetTime();
+
+			count_allocs = true;
+			parser->Convert(input.c_str(), (int)input.size(), &output, &out_size, &lines);
+			count_allocs = false;
+
+			time += GetTime() - start;
+			tokens += (size_t)parser->GetConvertedTokens();
+
+			delete [] output;
+		}
+
+		delete parser;
+
+		if(time <= 0)
+			time = 0.000001;
+
+		fprintf(out, "%s\t%s\t%s\t%s\t%d\t%d\t%d\t%d\t%.3f\t%.3f\t%.0f\t%.0f\t%.0f\t%.0f\n", commit, s, t, argv[i], (int)input.size(), lines,
+			(int)(tokens/iter), iter, time * 1000.0/iter, ((double)input.size() * iter)/(1024.0 * 1024.0)/time, (double)tokens/time,
+			(double)allocs/iter, (double)alloc_bytes/iter, (double)GetPeakRss());
+		fflush(out);
+	}
+
+	if(out != stdout)
+		fclose(out);
+
+	return rc;
+}
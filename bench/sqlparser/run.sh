@@ -0,0 +1,71 @@
+#!/bin/bash
+#
+# Conversion benchmark: converts the corpus for every source/target pair with parserbench
+#
+# corpus/<source>/*.sql files are repeated REPEAT times to build large inputs, the DDL dump and
+# the large package generated by gen_corpus.sh are converted as is. One record per file and pair
+# is appended to the results file, compare two results files with compare.sh.
+#
+# Usage: ./run.sh [results_file]
+#
+# Environment (defaults in brackets):
+#   PAIRS       source:target pairs [all pairs below]
+#   REPEAT      times each corpus file is repeated in the input [200]
+#   ITER        conversions of each corpus file [5]
+#   ITER_LARGE  conversions of each generated file [1]
+#   TABLES      tables in the generated DDL dump [50000]
+#   PROCS       procedures in the generated package [2000]
+#   WORK        directory for the generated files [/tmp/sqlparser_bench]
+
+cd "$(dirname "$0")"
+
+PAIRS=${PAIRS:-"oracle:postgresql oracle:mysql oracle:mariadb oracle:mariadb_ora oracle:sql oracle:greenplum oracle:redshift
+	sql:postgresql sql:mysql sql:mariadb sql:oracle sql:redshift
+	sybase:postgresql sybase:mysql sybase:sql sybase:oracle
+	db2:postgresql db2:mysql db2:mariadb db2:oracle db2:sql
+	informix:postgresql informix:mysql informix:mariadb informix:oracle informix:sql
+	mysql:postgresql mysql:mariadb mysql:oracle mysql:sql"}
+REPEAT=${REPEAT:-200}
+ITER=${ITER:-5}
+ITER_LARGE=${ITER_LARGE:-1}
+TABLES=${TABLES:-50000}
+PROCS=${PROCS:-2000}
+WORK=${WORK:-/tmp/sqlparser_bench}
+
+COMMIT=$(git rev-parse --short HEAD 2> /dev/null || echo unknown)
+RESULTS=${1:-results/$(date +%Y%m%d_%H%M%S)_$COMMIT.tsv}
+
+if [ ! -x parserbench ]; then
+	./build.sh || exit 1
+fi
+
+# Generated files are kept for the next runs with the same sizes
+GEN="$WORK/corpus_${TABLES}_$PROCS"
+
+if [ ! -d "$GEN" ]; then
+	echo "Generating the DDL dump and the large package in $GEN"
+	./gen_corpus.sh "$GEN" $TABLES $PROCS || exit 1
+fi
+
+mkdir -p "$(dirname "$RESULTS")"
+
+rc=0
+
+for pair in $PAIRS; do
+	s=${pair%%:*}
+	t=${pair##*:}
+
+	echo "Converting from $s to $t"
+
+	if ls corpus/$s/*.sql > /dev/null 2>&1; then
+		./parserbench -s=$s -t=$t -repeat=$REPEAT -iter=$ITER -out="$RESULTS" -commit=$COMMIT corpus/$s/*.sql || rc=1
+	fi
+
+	if ls "$GEN/$s/"*.sql > /dev/null 2>&1; then
+		./parserbench -s=$s -t=$t -iter=$ITER_LARGE -out="$RESULTS" -commit=$COMMIT "$GEN/$s/"*.sql || rc=1
+	fi
+done
+
+echo "Results written to $RESULTS"
+
+exit $rc
@@ -22,12 +22,14 @@
 #include <stdlib.h>
 
 #if defined(WIN32) || defined(WIN64)
+#include <windows.h>
 #include <io.h>
 #include <direct.h>
 #else
 #include <sys/stat.h>
 #include <sys/io.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #define _read read
 #define _write write
@@ -461,3 +463,18 @@ int File::Append(const char *file, const char *data, unsigned int len)
  
    return rc;
 }
+
+// Get a temporary name for the file unique for the current process and thread
+void File::GetTempName(const char *file, std::string &tmp)
+{
+	char suffix[64];
+
+#if defined(WIN32) || defined(WIN64)
+	sprintf(suffix, ".%lu.%lu.tmp", (unsigned long)GetCurrentProcessId(), (unsigned long)GetCurrentThreadId());
+#else
+	sprintf(suffix, ".%lu.%lu.tmp", (unsigned long)getpid(), (unsigned long)pthread_self());
+#endif
+
+	tmp = file;
+	tmp += suffix;
+}
@@ -83,6 +83,9 @@ public:
 	static int Truncate(const char *file);
 	// Append data to the existing file
 	static int Append(const char *file, const char *data, unsigned int len);
+
+	// Get a temporary name for the file unique for the current process and thread
+	static void GetTempName(const char *file, std::string &tmp);
 };
 
 #endif // sqlines_file_h
\ No newline at end of file
@@ -5,6 +5,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+
+#if defined(WIN32) || defined(_WIN64)
+#include <process.h>
+#endif
+
 #include "applog.h"
 #include "file.h"
 
@@ -21,13 +26,50 @@ AppLog::AppLog()
 	_console = NULL;
 	_console_object = NULL;
 
+	_trc_file = NULL;
+	_trc_writer_started = false;
+	_trc_writer_stop = false;
+
 #if defined(WIN32) || defined(_WIN64)
 	InitializeCriticalSection(&_log_critical_section);
+	InitializeCriticalSection(&_trc_buffer_critical_section);
+	InitializeCriticalSection(&_trc_file_critical_section);
+	_trc_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	_trc_writer = NULL;
 #else
 	pthread_mutex_init(&_log_critical_section, NULL);
+	pthread_mutex_init(&_trc_buffer_critical_section, NULL);
+	pthread_mutex_init(&_trc_file_critical_section, NULL);
+	Os::CreateEvent(&_trc_event);
 #endif
 }
 
+// Destructor
+AppLog::~AppLog()
+{
+	// Stop the trace writer, it writes remaining messages before exit
+	if(_trc_writer_started)
+	{
+		Os::EnterCriticalSection(&_trc_buffer_critical_section);
+		_trc_writer_stop = true;
+		Os::LeaveCriticalSection(&_trc_buffer_critical_section);
+
+#if defined(WIN32) || defined(_WIN64)
+		SetEvent(_trc_event);
+		WaitForSingleObject(_trc_writer, INFINITE);
+		CloseHandle(_trc_writer);
+#else
+		Os::SetEvent(&_trc_event);
+		pthread_join(_trc_writer, NULL);
+#endif
+	}
+
+	FlushTrace();
+
+	if(_trc_file != NULL)
+		fclose(_trc_file);
+}
+
 // Set log file name
 void AppLog::SetLogfile(const char *name, const char *default_dir)
 {
@@ -49,6 +91,11 @@ void AppLog::SetTracefile(const char *name, const char *default_dir)
 	if(name == NULL)
 		return;
 
+	// Messages traced before belong to the previous file
+	FlushTrace();
+
+	Os::EnterCriticalSection(&_trc_file_critical_section);
+
 	// If directory is not set use the default directory
 	if(File::IsDirectoryInPath(name) == false)
 		File::GetPathFromDirectoryAndFile(_filename_trc, default_dir, name); 
@@ -56,6 +103,8 @@ void AppLog::SetTracefile(const char *name, const char *default_dir)
 		_filename_trc = name;
 
 	first_write_trc = true;
+
+	Os::LeaveCriticalSection(&_trc_file_critical_section);
 }
 
 // Log message to console and log file
@@ -96,8 +145,6 @@ void AppLog::Log(const char *format, ...)
 // Log messages to file if trace mode is set
 void AppLog::Trace(const char *format, ...)
 {
-	Os::EnterCriticalSection(&_log_critical_section);
-
 	va_list args;
 	va_start(args, format);
 
@@ -105,7 +152,6 @@ void AppLog::Trace(const char *format, ...)
 	TraceFileVaList(format, args);
 
 	va_end(args);
-	Os::LeaveCriticalSection(&_log_critical_section);
 }
 
 // Write to console only
@@ -173,31 +219,159 @@ void AppLog::LogFile(const char *data, int len)
 		File::Append(_filename.c_str(), data, (unsigned int)len);
 }
 
-// Write to trace file
+// Write to trace file (the message is formatted by the caller and written by the writer thread)
 void AppLog::TraceFileVaList(const char *format, va_list args)
 {
-	const char *openMode = "a";
+	char line[APPTRACE_LINE_SIZE];
+	std::string long_line;
 
-	// During the first call destroy the log file content that may exists from the previous runs
-	if(first_write_trc == true)
-		openMode = "w";
+	Os::CurrentTimestamp(line);
 
-	FILE *file = fopen(_filename_trc.c_str(), openMode);
+	int ts_len = (int)strlen(line);
+	line[ts_len++] = ' ';
 
-	// Log message to file
-	if(file)
+	va_list args2;
+	va_copy(args2, args);
+
+	int len = vsnprintf(line + ts_len, APPTRACE_LINE_SIZE - ts_len - 1, format, args);
+
+	if(len < 0)
+		len = 0;
+
+	const char *data = line;
+
+	// Message does not fit the stack buffer
+	if(len >= APPTRACE_LINE_SIZE - ts_len - 1)
 	{
-		fprintf(file, "%s ", Os::CurrentTimestamp());
-		vfprintf(file, format, args);
-		fprintf(file, "\n");
-		fclose(file);
+		long_line.assign(line, ts_len);
+		long_line.resize(ts_len + len + 1);
+
+		vsnprintf(&long_line[ts_len], len + 1, format, args2);
+
+		long_line[ts_len + len] = '\n';
+		data = long_line.c_str();
 	}
-	else 
-	{  
-		// Show error message during the first call only  
-		if(first_write == true)
-			printf("\n\nError:\n Opening trace file %s - %s", _filename_trc.c_str(), strerror(errno));
+	else
+		line[ts_len + len] = '\n';
+
+	va_end(args2);
+
+	bool overflow = false;
+
+	Os::EnterCriticalSection(&_trc_buffer_critical_section);
+
+	bool was_empty = _trc_buffer.empty();
+
+	_trc_buffer.append(data, ts_len + len + 1);
+
+	if(_trc_buffer.size() > APPTRACE_BUFFER_MAX)
+		overflow = true;
+
+	if(!_trc_writer_started)
+	{
+		StartTraceWriter();
+
+		// Writer thread cannot be started
+		if(!_trc_writer_started)
+			overflow = true;
 	}
 
-	first_write_trc = false;
+	Os::LeaveCriticalSection(&_trc_buffer_critical_section);
+
+	// Writer does not keep up, write messages in this thread
+	if(overflow)
+		FlushTrace();
+	else
+	// Wake up the writer
+	if(was_empty)
+	{
+#if defined(WIN32) || defined(_WIN64)
+		SetEvent(_trc_event);
+#else
+		Os::SetEvent(&_trc_event);
+#endif
+	}
+}
+
+// Write all buffered trace messages to the file
+void AppLog::FlushTrace()
+{
+	std::string data;
+
+	// File section is taken first, so messages taken from the buffer by different threads are written in order
+	Os::EnterCriticalSection(&_trc_file_critical_section);
+
+	Os::EnterCriticalSection(&_trc_buffer_critical_section);
+	data.swap(_trc_buffer);
+	Os::LeaveCriticalSection(&_trc_buffer_critical_section);
+
+	if(!data.empty())
+	{
+		// During the first write destroy the trace file content that may exists from the previous runs
+		if(first_write_trc || _trc_file == NULL)
+		{
+			if(_trc_file != NULL)
+				fclose(_trc_file);
+
+			_trc_file = fopen(_filename_trc.c_str(), first_write_trc ? "w" : "a");
+
+			// Show error message during the first call only  
+			if(_trc_file == NULL && first_write_trc)
+				printf("\n\nError:\n Opening trace file %s - %s", _filename_trc.c_str(), strerror(errno));
+
+			first_write_trc = false;
+		}
+
+		if(_trc_file != NULL)
+		{
+			fwrite(data.c_str(), 1, data.size(), _trc_file);
+			fflush(_trc_file);
+		}
+	}
+
+	Os::LeaveCriticalSection(&_trc_file_critical_section);
+}
+
+// Start the trace writer thread (called in the buffer critical section)
+void AppLog::StartTraceWriter()
+{
+#if defined(WIN32) || defined(_WIN64)
+	_trc_writer = (HANDLE)_beginthreadex(NULL, 0, &AppLog::TraceWriterS, this, 0, NULL);
+	_trc_writer_started = (_trc_writer != NULL);
+#else
+	_trc_writer_started = (pthread_create(&_trc_writer, NULL, &AppLog::TraceWriterS, this) == 0);
+#endif
+}
+
+// Trace writer thread
+#if defined(WIN32) || defined(_WIN64)
+unsigned int __stdcall AppLog::TraceWriterS(void *object)
+#else
+void* AppLog::TraceWriterS(void *object)
+#endif
+{
+	AppLog *log = (AppLog*)object;
+
+	while(true)
+	{
+#if defined(WIN32) || defined(_WIN64)
+		WaitForSingleObject(log->_trc_event, INFINITE);
+#else
+		Os::WaitForEvent(&log->_trc_event);
+#endif
+		log->FlushTrace();
+
+		Os::EnterCriticalSection(&log->_trc_buffer_critical_section);
+		bool stop = log->_trc_writer_stop;
+		Os::LeaveCriticalSection(&log->_trc_buffer_critical_section);
+
+		if(stop)
+			break;
+	}
+
+#if defined(WIN32) || defined(_WIN64)
+	return 0;
+#else
+	return NULL;
+#endif
 }
@@ -11,6 +11,7 @@
 #include <pthread.h>
 #endif
 
+#include <stdio.h>
 #include <stdarg.h>
 #include <string>
 #include "os.h"
@@ -19,6 +20,11 @@
 #define APPLOG_DEFAULT_FILE			"applog.log"
 #define APPTRACE_DEFAULT_FILE		"applog.trc"
 
+// Size of the stack buffer to format a trace message, longer messages are formatted in the heap
+#define APPTRACE_LINE_SIZE			4096
+// Maximum size of trace messages waiting for the writer thread, the caller writes them itself when exceeded
+#define APPTRACE_BUFFER_MAX			(8*1024*1024)
+
 typedef void (*AppLogConsoleFunc)(void *object, const char *format, va_list args);
 
 class AppLog
@@ -42,8 +48,30 @@ class AppLog
 	pthread_mutex_t _log_critical_section;
 #endif
 
+	// Trace messages formatted by callers and waiting for the writer thread
+	std::string _trc_buffer;
+	// Trace file kept open by the writer
+	FILE *_trc_file;
+
+	bool _trc_writer_started;
+	bool _trc_writer_stop;
+
+	// Buffer section is held only to append or take messages, file section while writing to the file
+#if defined(WIN32) || defined(_WIN64)
+	CRITICAL_SECTION _trc_buffer_critical_section;
+	CRITICAL_SECTION _trc_file_critical_section;
+	HANDLE _trc_event;
+	HANDLE _trc_writer;
+#else
+	pthread_mutex_t _trc_buffer_critical_section;
+	pthread_mutex_t _trc_file_critical_section;
+	Event _trc_event;
+	pthread_t _trc_writer;
+#endif
+
 public:
 	AppLog();
+	~AppLog();
 
 	// Log message to console and log file
     void Log(const char *format, ...);
@@ -59,6 +87,8 @@ public:
     void LogFileVaList(const char *format, va_list args);
 	// Write to trace file
     void TraceFileVaList(const char *format, va_list args);
+	// Write all buffered trace messages to the file
+	void FlushTrace();
 
 	// Set log and trace file names
 	void SetLogfile(const char *name, const char *default_dir); 
@@ -70,6 +100,15 @@ public:
 
 	// Set console output function
 	void SetConsoleFunc(void *object, AppLogConsoleFunc console) { _console_object = object; _console = console; }
+
+private:
+	// Trace writer thread
+	void StartTraceWriter();
+#if defined(WIN32) || defined(_WIN64)
+	static unsigned int __stdcall TraceWriterS(void *object);
+#else
+	static void* TraceWriterS(void *object);
+#endif
 };
 
 #endif // sqlines_applog_h
\ No newline at end of file
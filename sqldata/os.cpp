@@ -19,6 +19,10 @@
 #include <stdio.h>
 #include "os.h"
 
+#if !defined(WIN32) && !defined(_WIN64)
+#include <errno.h>
+#endif
+
 #if !defined(WIN32) && !defined(_WIN64)
 long long GetTickCount(void) 
 {
@@ -85,6 +89,35 @@ void Os::WaitForEvent(Event *event)
 	pthread_mutex_unlock(&event->_mutex);
 }
 
+// Wait for event to be set or timeout in milliseconds, returns false on timeout
+bool Os::WaitForEvent(Event *event, size_t timeout)
+{
+	struct timespec now;
+	struct timespec until;
+
+	// Condition variables wait until the realtime clock time
+	clock_gettime(CLOCK_REALTIME, &now);
+
+	long long nsec = (long long)now.tv_nsec + (long long)(timeout % 1000) * 1000000;
+
+	until.tv_sec = now.tv_sec + (time_t)(timeout / 1000) + (time_t)(nsec / 1000000000);
+	until.tv_nsec = (long)(nsec % 1000000000);
+
+	pthread_mutex_lock(&event->_mutex);
+
+	int rc = 0;
+
+	while(!event->_state && rc != ETIMEDOUT)
+		rc = pthread_cond_timedwait(&event->_event, &event->_mutex, &until);
+
+	bool set = event->_state;
+	event->_state = false;
+
+	pthread_mutex_unlock(&event->_mutex);
+
+	return set;
+}
+
 #endif
 
 // Load dynamic library
@@ -218,6 +251,12 @@ const char *Os::CurrentTimestamp()
 {
 	static char ts[26];
 
+	return CurrentTimestamp(ts);
+}
+
+// Write the current timestamp to the buffer, thread-safe
+const char *Os::CurrentTimestamp(char *ts)
+{
 #if defined(WIN32) || defined(_WIN64)
 	SYSTEMTIME lt;
 	GetLocalTime(&lt);
@@ -226,9 +265,10 @@ const char *Os::CurrentTimestamp()
 	char t[26];
 	struct tm* tm_info;
 	struct timeval tv;
+	struct tm tm_buf;
 
 	gettimeofday(&tv, NULL);
-	tm_info = localtime(&tv.tv_sec);
+	tm_info = localtime_r(&tv.tv_sec, &tm_buf);
 	strftime(t, sizeof(t), "%Y:%m:%d %H:%M:%S", tm_info);
 	sprintf(ts, "%s.%03d", t, (int)tv.tv_usec/1000);
 #endif
@@ -246,3 +286,42 @@ const char* Os::CurrentWorkingDirectory()
 	return cwd;
 }
 
+// Get CPU time (user and system, seconds) and peak resident memory (bytes) of the current process
+int Os::GetProcessUsage(double *cpu_seconds, size_t *peak_rss)
+{
+#if defined(WIN32) || defined(_WIN64)
+	FILETIME create_time, exit_time, kernel_time, user_time;
+
+	if(!GetProcessTimes(GetCurrentProcess(), &create_time, &exit_time, &kernel_time, &user_time))
+		return -1;
+
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernel_time.dwLowDateTime;
+	kernel.HighPart = kernel_time.dwHighDateTime;
+	user.LowPart = user_time.dwLowDateTime;
+	user.HighPart = user_time.dwHighDateTime;
+
+	// FILETIME is in 100-nanosecond units
+	if(cpu_seconds != NULL)
+		*cpu_seconds = ((double)(kernel.QuadPart + user.QuadPart))/10000000.0;
+
+	PROCESS_MEMORY_COUNTERS pmc;
+
+	if(peak_rss != NULL)
+		*peak_rss = GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? (size_t)pmc.PeakWorkingSetSize : 0;
+#else
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+
+	if(cpu_seconds != NULL)
+		*cpu_seconds = (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + 
+			((double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec))/1000000.0;
+
+	// Linux reports the maximum resident set size in kilobytes
+	if(peak_rss != NULL)
+		*peak_rss = (size_t)usage.ru_maxrss * 1024;
+#endif
+	return 0;
+}
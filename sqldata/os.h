@@ -29,11 +29,13 @@
 #if defined(WIN32) || defined(_WIN64)
 #include <windows.h>
 #include <direct.h>
+#include <psapi.h>
 #else
 #include <dlfcn.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <sys/time.h>
+#include <sys/resource.h>
 
 #define _getcwd getcwd
 
@@ -61,6 +63,8 @@ public:
 	static void SetEvent(Event *event);
 	static void ResetEvent(Event *event);
 	static void WaitForEvent(Event *event);
+	// Wait for event to be set or timeout in milliseconds, returns false on timeout
+	static bool WaitForEvent(Event *event, size_t timeout);
 #endif
 
 	// Load dynamic library
@@ -96,10 +100,15 @@ public:
 
 	// Get the current timestamp string
 	static const char* CurrentTimestamp();
+	// Write the current timestamp to the buffer (at least 26 bytes), thread-safe
+	static const char* CurrentTimestamp(char *ts);
 
 	// Get the current working directory
 	static const char* CurrentWorkingDirectory();
 
+	// Get CPU time (user and system, seconds) and peak resident memory (bytes) of the current process
+	static int GetProcessUsage(double *cpu_seconds, size_t *peak_rss);
+
 	// Check if DDL is 64-bit
 	static bool Is64Bit(const char *filename);
 };
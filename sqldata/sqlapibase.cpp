@@ -20,7 +20,9 @@
 #include <windows.h>
 #endif
 
+#include <sql.h>
 #include <stdio.h>
+#include <ctype.h>
 #include <algorithm>
 #include "sqlapibase.h"
 #include "str.h"
@@ -32,6 +34,7 @@ const char *g_spec_symbols = " _\"'.,;:(){}[]=+-*<>!$~|~`@#%^&/\\\n\r\t";
 SqlApiBase::SqlApiBase()
 {
 	_connected = false; 
+	_compress = false;
 
 	_subtype = 0;
 	_version_major = 0;
@@ -40,6 +43,7 @@ SqlApiBase::SqlApiBase()
 
 	_cursor_cols_count = 0;
 	_cursor_allocated_rows = 0;
+	_cursor_fetch_rows = 0;
 	_cursor_cols = NULL;
 	_cursor_lob_exists = false;
 	_cursor_fetch_lob_as_varchar = false;
@@ -67,7 +71,11 @@ SqlApiBase::SqlApiBase()
 
 	_batch_max_rows = 0;
     _lob_bind_buffer = 0;
+	_lob_chunk_size = SQLDATA_LOB_CHUNK_SIZE;
+	_catalog_indexed_items = 0;
+	_catalog_indexed = false;
 	_char_length_ratio = 0.0;
+	_transfer_send_time = -1;
 
 	_trace = false;
 	_trace_data = false;
@@ -102,6 +110,644 @@ void SqlApiBase::ClearSchema()
 	_table_ind_columns.clear();
 	_table_ind_expressions.clear();
 	_sequences.clear();
+
+	ClearCatalogIndex();
+}
+
+// Get catalog index key SCHEMA.NAME
+void SqlApiBase::GetCatalogKey(const char *schema, const char *name, std::string &key)
+{
+	key.clear();
+
+	if(schema != NULL)
+	{
+		for(const char *cur = schema; *cur; cur++)
+			key += (char)toupper((unsigned char)*cur);
+	}
+
+	key += '.';
+
+	if(name != NULL)
+	{
+		for(const char *cur = name; *cur; cur++)
+			key += (char)toupper((unsigned char)*cur);
+	}
+}
+
+// Build the catalog index from the catalog lists
+void SqlApiBase::BuildCatalogIndex()
+{
+	size_t items = _table_columns.size() + _table_constraints.size() + _table_cons_columns.size() + 
+		_table_comments.size() + _table_indexes.size() + _table_ind_columns.size();
+
+	// Index is up to date
+	if(_catalog_indexed == true && items == _catalog_indexed_items)
+		return;
+
+	_catalog_tables.clear();
+	_catalog_cons_columns.clear();
+	_catalog_ind_columns.clear();
+
+	std::string key;
+
+	for(std::list<SqlColMeta>::iterator i = _table_columns.begin(); i != _table_columns.end(); i++)
+	{
+		if((*i).table == NULL)
+			continue;
+
+		GetCatalogKey((*i).schema, (*i).table, key);
+		_catalog_tables[key].columns.push_back(&(*i));
+	}
+
+	for(std::list<SqlConstraints>::iterator i = _table_constraints.begin(); i != _table_constraints.end(); i++)
+	{
+		if((*i).table == NULL)
+			continue;
+
+		GetCatalogKey((*i).schema, (*i).table, key);
+		_catalog_tables[key].constraints.push_back(&(*i));
+	}
+
+	for(std::list<SqlIndexes>::iterator i = _table_indexes.begin(); i != _table_indexes.end(); i++)
+	{
+		if((*i).t_name == NULL)
+			continue;
+
+		GetCatalogKey((*i).t_schema, (*i).t_name, key);
+		_catalog_tables[key].indexes.push_back(&(*i));
+	}
+
+	for(std::list<SqlComments>::iterator i = _table_comments.begin(); i != _table_comments.end(); i++)
+	{
+		if((*i).table == NULL)
+			continue;
+
+		GetCatalogKey((*i).schema, (*i).table, key);
+		_catalog_tables[key].comments.push_back(&(*i));
+	}
+
+	for(std::list<SqlConsColumns>::iterator i = _table_cons_columns.begin(); i != _table_cons_columns.end(); i++)
+	{
+		if((*i).constraint == NULL)
+			continue;
+
+		GetCatalogKey((*i).schema, (*i).constraint, key);
+		_catalog_cons_columns[key].push_back(&(*i));
+	}
+
+	for(std::list<SqlIndColumns>::iterator i = _table_ind_columns.begin(); i != _table_ind_columns.end(); i++)
+	{
+		if((*i).index == NULL)
+			continue;
+
+		GetCatalogKey((*i).schema, (*i).index, key);
+		_catalog_ind_columns[key].push_back(&(*i));
+	}
+
+	_catalog_indexed_items = items;
+	_catalog_indexed = true;
+}
+
+// Clear the catalog index, it is rebuilt on the next lookup
+void SqlApiBase::ClearCatalogIndex()
+{
+	_catalog_tables.clear();
+	_catalog_cons_columns.clear();
+	_catalog_ind_columns.clear();
+	_catalog_indexed_items = 0;
+	_catalog_indexed = false;
+}
+
+// Get indexed catalog objects of the table
+SqlTableCatalog* SqlApiBase::GetCatalogTable(const char *schema, const char *table)
+{
+	if(table == NULL)
+		return NULL;
+
+	BuildCatalogIndex();
+
+	std::string key;
+	GetCatalogKey(schema, table, key);
+
+	std::map<std::string, SqlTableCatalog>::iterator i = _catalog_tables.find(key);
+
+	if(i == _catalog_tables.end())
+		return NULL;
+
+	return &i->second;
+}
+
+// Check whether the table has an identity column
+bool SqlApiBase::IsIdentityDefined(std::string &schema, std::string &table)
+{
+	SqlTableCatalog *catalog = GetCatalogTable(schema.c_str(), table.c_str());
+
+	if(catalog == NULL)
+		return false;
+
+	for(std::vector<SqlColMeta*>::iterator i = catalog->columns.begin(); i != catalog->columns.end(); i++)
+	{
+		if((*i)->identity == true)
+			return true;
+	}
+
+	return false;
+}
+
+// Get constraint columns by schema and constraint name
+std::vector<SqlConsColumns*>* SqlApiBase::GetCatalogConstraintColumns(const char *schema, const char *constraint)
+{
+	if(constraint == NULL)
+		return NULL;
+
+	BuildCatalogIndex();
+
+	std::string key;
+	GetCatalogKey(schema, constraint, key);
+
+	std::map<std::string, std::vector<SqlConsColumns*> >::iterator i = _catalog_cons_columns.find(key);
+
+	if(i == _catalog_cons_columns.end())
+		return NULL;
+
+	return &i->second;
+}
+
+// Get index columns by schema and index name
+std::vector<SqlIndColumns*>* SqlApiBase::GetCatalogIndexColumns(const char *schema, const char *index)
+{
+	if(index == NULL)
+		return NULL;
+
+	BuildCatalogIndex();
+
+	std::string key;
+	GetCatalogKey(schema, index, key);
+
+	std::map<std::string, std::vector<SqlIndColumns*> >::iterator i = _catalog_ind_columns.find(key);
+
+	if(i == _catalog_ind_columns.end())
+		return NULL;
+
+	return &i->second;
+}
+
+// Save the catalog lists to the metadata snapshot file
+int SqlApiBase::SaveSchemaCache(const char *file, const char *key, const char *fingerprint)
+{
+	if(file == NULL)
+		return -1;
+
+	std::string out = SQLDATA_META_CACHE_HEADER;
+
+	PutCacheValue(out, key);
+	PutCacheValue(out, fingerprint);
+
+	PutCacheValue(out, (int)_table_columns.size());
+
+	for(std::list<SqlColMeta>::iterator i = _table_columns.begin(); i != _table_columns.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).table); PutCacheValue(out, (*i).column);
+		PutCacheValue(out, (*i).num); PutCacheValue(out, (*i).data_type); PutCacheValue(out, (*i).data_type_code);
+		PutCacheValue(out, (int)(*i).no_default); PutCacheValue(out, (*i).default_value); 
+		PutCacheValue(out, (int)(*i).default_type); PutCacheValue(out, (int)(*i).nullable); 
+		PutCacheValue(out, (int)(*i).pk_column); PutCacheValue(out, (int)(*i).identity); 
+		PutCacheValue(out, (*i).id_start); PutCacheValue(out, (*i).id_inc); PutCacheValue(out, (*i).id_next);
+		PutCacheValue(out, (*i).tabid);
+	}
+
+	PutCacheValue(out, (int)_table_constraints.size());
+
+	for(std::list<SqlConstraints>::iterator i = _table_constraints.begin(); i != _table_constraints.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).table); PutCacheValue(out, (*i).constraint);
+		PutCacheValue(out, (int)(*i).type); PutCacheValue(out, (*i).condition); PutCacheValue(out, (*i).cnsid);
+		PutCacheValue(out, (*i).tabid); PutCacheValue(out, (*i).idxname); PutCacheValue(out, (*i).idxid);
+		PutCacheValue(out, (*i).r_schema); PutCacheValue(out, (*i).r_constraint); PutCacheValue(out, (*i).r_cnsid);
+		PutCacheValue(out, (*i).fkid); PutCacheValue(out, (*i).pk_schema); PutCacheValue(out, (*i).pk_table);
+		PutCacheValue(out, (int)(*i).fk_on_update); PutCacheValue(out, (int)(*i).fk_on_delete);
+	}
+
+	PutCacheValue(out, (int)_table_cons_columns.size());
+
+	for(std::list<SqlConsColumns>::iterator i = _table_cons_columns.begin(); i != _table_cons_columns.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).table); PutCacheValue(out, (*i).constraint);
+		PutCacheValue(out, (*i).column); PutCacheValue(out, (*i).cnsid); PutCacheValue(out, (*i).tabid);
+		PutCacheValue(out, (*i).pk_column);
+	}
+
+	PutCacheValue(out, (int)_table_comments.size());
+
+	for(std::list<SqlComments>::iterator i = _table_comments.begin(); i != _table_comments.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).table); PutCacheValue(out, (*i).column);
+		PutCacheValue(out, (*i).comment); PutCacheValue(out, (int)(*i).type);
+	}
+
+	PutCacheValue(out, (int)_table_indexes.size());
+
+	for(std::list<SqlIndexes>::iterator i = _table_indexes.begin(); i != _table_indexes.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).index); PutCacheValue(out, (int)(*i).unique);
+		PutCacheValue(out, (*i).t_schema); PutCacheValue(out, (*i).t_name); PutCacheValue(out, (*i).tabid);
+		PutCacheValue(out, (*i).idxid);
+	}
+
+	PutCacheValue(out, (int)_table_ind_columns.size());
+
+	for(std::list<SqlIndColumns>::iterator i = _table_ind_columns.begin(); i != _table_ind_columns.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).index); PutCacheValue(out, (*i).column);
+		PutCacheValue(out, (*i).tabid); PutCacheValue(out, (*i).idxid); PutCacheValue(out, (int)(*i).asc);
+	}
+
+	PutCacheValue(out, (int)_table_ind_expressions.size());
+
+	for(std::list<SqlIndExp>::iterator i = _table_ind_expressions.begin(); i != _table_ind_expressions.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).index); PutCacheValue(out, (*i).expression);
+	}
+
+	PutCacheValue(out, (int)_sequences.size());
+
+	for(std::list<SqlSequences>::iterator i = _sequences.begin(); i != _sequences.end(); i++)
+	{
+		PutCacheValue(out, (*i).schema); PutCacheValue(out, (*i).name); PutCacheValue(out, (*i).min_str);
+		PutCacheValue(out, (*i).max_str); PutCacheValue(out, (*i).inc_str); PutCacheValue(out, (*i).cur_str);
+		PutCacheValue(out, (*i).cache_size_str); PutCacheValue(out, (int)(*i).cycle); PutCacheValue(out, (int)(*i).no_max);
+	}
+
+	// Write to a temporary file first, so concurrent sessions never read a partially written snapshot
+	std::string tmp;
+	File::GetTempName(file, tmp);
+
+	// File::Write does not truncate the existing file
+	File::Truncate(tmp.c_str());
+
+	if(File::Write(tmp.c_str(), out.c_str(), out.length()) != (int)out.length())
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+#if defined(WIN32) || defined(_WIN64)
+	remove(file);
+#endif
+
+	if(rename(tmp.c_str(), file) != 0)
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+	return 0;
+}
+
+// Load the catalog lists from the metadata snapshot file
+int SqlApiBase::LoadSchemaCache(const char *file, const char *key, std::string &fingerprint)
+{
+	int size = File::GetFileSize(file);
+
+	if(size <= 0)
+		return -1;
+
+	char *input = new char[(size_t)size];
+
+	if(File::GetContent(file, input, (size_t)size) == -1)
+	{
+		delete [] input;
+		return -1;
+	}
+
+	size_t header_len = strlen(SQLDATA_META_CACHE_HEADER);
+
+	const char *cur = input + header_len;
+	const char *end = input + size;
+
+	char *cache_key = NULL;
+	char *cache_fingerprint = NULL;
+
+	// Snapshot is created by another version, or for another database or selection
+	bool valid = ((size_t)size > header_len && strncmp(input, SQLDATA_META_CACHE_HEADER, header_len) == 0 &&
+		GetCacheValue(&cur, end, &cache_key) && GetCacheValue(&cur, end, &cache_fingerprint) &&
+		cache_key != NULL && key != NULL && strcmp(cache_key, key) == 0);
+
+	if(cache_fingerprint != NULL)
+		fingerprint = cache_fingerprint;
+
+	delete [] cache_key;
+	delete [] cache_fingerprint;
+
+	ClearSchema();
+
+	int count = 0;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_table_columns.push_back(SqlColMeta());
+			SqlColMeta &c = _table_columns.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.table) && 
+				GetCacheValue(&cur, end, &c.column) && GetCacheValue(&cur, end, &c.num) && 
+				GetCacheValue(&cur, end, &c.data_type) && GetCacheValue(&cur, end, &c.data_type_code) && 
+				GetCacheValue(&cur, end, &c.no_default) && GetCacheValue(&cur, end, &c.default_value) && 
+				GetCacheValue(&cur, end, &c.default_type) && GetCacheValue(&cur, end, &c.nullable) && 
+				GetCacheValue(&cur, end, &c.pk_column) && GetCacheValue(&cur, end, &c.identity) && 
+				GetCacheValue(&cur, end, &c.id_start) && GetCacheValue(&cur, end, &c.id_inc) && 
+				GetCacheValue(&cur, end, &c.id_next) && GetCacheValue(&cur, end, &c.tabid);
+		}
+	}
+	else
+		valid = false;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_table_constraints.push_back(SqlConstraints());
+			SqlConstraints &c = _table_constraints.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.table) && 
+				GetCacheValue(&cur, end, &c.constraint) && GetCacheValue(&cur, end, &c.type) && 
+				GetCacheValue(&cur, end, &c.condition) && GetCacheValue(&cur, end, &c.cnsid) && 
+				GetCacheValue(&cur, end, &c.tabid) && GetCacheValue(&cur, end, &c.idxname) && 
+				GetCacheValue(&cur, end, &c.idxid) && GetCacheValue(&cur, end, &c.r_schema) && 
+				GetCacheValue(&cur, end, &c.r_constraint) && GetCacheValue(&cur, end, &c.r_cnsid) && 
+				GetCacheValue(&cur, end, &c.fkid) && GetCacheValue(&cur, end, &c.pk_schema) && 
+				GetCacheValue(&cur, end, &c.pk_table) && GetCacheValue(&cur, end, &c.fk_on_update) && 
+				GetCacheValue(&cur, end, &c.fk_on_delete);
+		}
+	}
+	else
+		valid = false;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_table_cons_columns.push_back(SqlConsColumns());
+			SqlConsColumns &c = _table_cons_columns.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.table) && 
+				GetCacheValue(&cur, end, &c.constraint) && GetCacheValue(&cur, end, &c.column) && 
+				GetCacheValue(&cur, end, &c.cnsid) && GetCacheValue(&cur, end, &c.tabid) && 
+				GetCacheValue(&cur, end, &c.pk_column);
+		}
+	}
+	else
+		valid = false;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_table_comments.push_back(SqlComments());
+			SqlComments &c = _table_comments.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.table) && 
+				GetCacheValue(&cur, end, &c.column) && GetCacheValue(&cur, end, &c.comment) && 
+				GetCacheValue(&cur, end, &c.type);
+		}
+	}
+	else
+		valid = false;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_table_indexes.push_back(SqlIndexes());
+			SqlIndexes &c = _table_indexes.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.index) && 
+				GetCacheValue(&cur, end, &c.unique) && GetCacheValue(&cur, end, &c.t_schema) && 
+				GetCacheValue(&cur, end, &c.t_name) && GetCacheValue(&cur, end, &c.tabid) && 
+				GetCacheValue(&cur, end, &c.idxid);
+		}
+	}
+	else
+		valid = false;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_table_ind_columns.push_back(SqlIndColumns());
+			SqlIndColumns &c = _table_ind_columns.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.index) && 
+				GetCacheValue(&cur, end, &c.column) && GetCacheValue(&cur, end, &c.tabid) && 
+				GetCacheValue(&cur, end, &c.idxid) && GetCacheValue(&cur, end, &c.asc);
+		}
+	}
+	else
+		valid = false;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_table_ind_expressions.push_back(SqlIndExp());
+			SqlIndExp &c = _table_ind_expressions.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.index) && 
+				GetCacheValue(&cur, end, &c.expression);
+		}
+	}
+	else
+		valid = false;
+
+	if(valid && GetCacheValue(&cur, end, &count))
+	{
+		for(int i = 0; i < count && valid; i++)
+		{
+			_sequences.push_back(SqlSequences());
+			SqlSequences &c = _sequences.back();
+
+			valid = GetCacheValue(&cur, end, &c.schema) && GetCacheValue(&cur, end, &c.name) && 
+				GetCacheValue(&cur, end, &c.min_str) && GetCacheValue(&cur, end, &c.max_str) && 
+				GetCacheValue(&cur, end, &c.inc_str) && GetCacheValue(&cur, end, &c.cur_str) && 
+				GetCacheValue(&cur, end, &c.cache_size_str) && GetCacheValue(&cur, end, &c.cycle) && 
+				GetCacheValue(&cur, end, &c.no_max);
+		}
+	}
+	else
+		valid = false;
+
+	delete [] input;
+
+	// Do not use a partially loaded snapshot
+	if(valid == false)
+	{
+		ClearSchema();
+		return -1;
+	}
+
+	// Catalog rows were replaced by the snapshot
+	ClearCatalogIndex();
+
+	return 0;
+}
+
+// Remove catalog rows of the specified tables
+void SqlApiBase::RemoveSchemaTables(std::set<std::string> &tables)
+{
+	std::set<std::string> indexes;
+	std::string key;
+
+	for(std::list<SqlColMeta>::iterator i = _table_columns.begin(); i != _table_columns.end(); )
+	{
+		GetCatalogKey((*i).schema, (*i).table, key);
+		i = (tables.find(key) != tables.end()) ? _table_columns.erase(i) : ++i;
+	}
+
+	for(std::list<SqlConstraints>::iterator i = _table_constraints.begin(); i != _table_constraints.end(); )
+	{
+		GetCatalogKey((*i).schema, (*i).table, key);
+		i = (tables.find(key) != tables.end()) ? _table_constraints.erase(i) : ++i;
+	}
+
+	for(std::list<SqlConsColumns>::iterator i = _table_cons_columns.begin(); i != _table_cons_columns.end(); )
+	{
+		GetCatalogKey((*i).schema, (*i).table, key);
+		i = (tables.find(key) != tables.end()) ? _table_cons_columns.erase(i) : ++i;
+	}
+
+	for(std::list<SqlComments>::iterator i = _table_comments.begin(); i != _table_comments.end(); )
+	{
+		GetCatalogKey((*i).schema, (*i).table, key);
+		i = (tables.find(key) != tables.end()) ? _table_comments.erase(i) : ++i;
+	}
+
+	// Index columns and expressions refer to the index name only
+	for(std::list<SqlIndexes>::iterator i = _table_indexes.begin(); i != _table_indexes.end(); )
+	{
+		GetCatalogKey((*i).t_schema, (*i).t_name, key);
+
+		if(tables.find(key) != tables.end())
+		{
+			GetCatalogKey((*i).schema, (*i).index, key);
+			indexes.insert(key);
+
+			i = _table_indexes.erase(i);
+		}
+		else
+			i++;
+	}
+
+	for(std::list<SqlIndColumns>::iterator i = _table_ind_columns.begin(); i != _table_ind_columns.end(); )
+	{
+		GetCatalogKey((*i).schema, (*i).index, key);
+		i = (indexes.find(key) != indexes.end()) ? _table_ind_columns.erase(i) : ++i;
+	}
+
+	for(std::list<SqlIndExp>::iterator i = _table_ind_expressions.begin(); i != _table_ind_expressions.end(); )
+	{
+		GetCatalogKey((*i).schema, (*i).index, key);
+		i = (indexes.find(key) != indexes.end()) ? _table_ind_expressions.erase(i) : ++i;
+	}
+
+	// Items of the catalog index point to the removed rows
+	ClearCatalogIndex();
+}
+
+// Write a string value to the metadata snapshot as <length>:<bytes>, NULL is written as -1:
+void SqlApiBase::PutCacheValue(std::string &out, const char *value)
+{
+	char len[21];
+
+	sprintf(len, "%d:", (value != NULL) ? (int)strlen(value) : -1);
+	out += len;
+
+	if(value != NULL)
+		out += value;
+}
+
+// Write an integer value to the metadata snapshot as <value>;
+void SqlApiBase::PutCacheValue(std::string &out, int value)
+{
+	char num[21];
+
+	sprintf(num, "%d;", value);
+	out += num;
+}
+
+// Read a string value from the metadata snapshot
+bool SqlApiBase::GetCacheValue(const char **cur, const char *end, char **value)
+{
+	const char *start = *cur;
+	int len = 0;
+
+	if(start >= end)
+		return false;
+
+	len = atoi(start);
+
+	while(start < end && *start != ':')
+		start++;
+
+	if(start >= end || len < -1 || len > end - start - 1)
+		return false;
+
+	start++;
+
+	if(len == -1)
+		*value = NULL;
+	else
+	{
+		*value = new char[(size_t)len + 1];
+
+		memcpy(*value, start, (size_t)len);
+		(*value)[len] = '\x0';
+	}
+
+	*cur = start + ((len > 0) ? len : 0);
+	return true;
+}
+
+// Read an integer value from the metadata snapshot
+bool SqlApiBase::GetCacheValue(const char **cur, const char *end, int *value)
+{
+	const char *start = *cur;
+
+	if(start >= end)
+		return false;
+
+	*value = atoi(start);
+
+	while(start < end && *start != ';')
+		start++;
+
+	if(start >= end)
+		return false;
+
+	*cur = start + 1;
+	return true;
+}
+
+bool SqlApiBase::GetCacheValue(const char **cur, const char *end, bool *value)
+{
+	int num = 0;
+
+	if(GetCacheValue(cur, end, &num) == false)
+		return false;
+
+	*value = (num != 0);
+	return true;
+}
+
+bool SqlApiBase::GetCacheValue(const char **cur, const char *end, char *value)
+{
+	int num = 0;
+
+	if(GetCacheValue(cur, end, &num) == false)
+		return false;
+
+	*value = (char)num;
+	return true;
 }
 
 // Check if identifier is a reserved word
@@ -544,6 +1190,12 @@ void SqlApiBase::SetParameters(Parameters *p)
 
 	if(_parameters->GetTrue("-trace_data") != NULL)
 		_trace_data = true;
+
+	// Buffer size to stream LOB values, set for all APIs as it is used by the target API
+	int lob_chunk_size = _parameters->GetInt("-lob_chunk_size", 0);
+
+	if(lob_chunk_size >= 1024 && lob_chunk_size < 1024*1024*100)
+		_lob_chunk_size = (size_t)lob_chunk_size;
 }
 
 // Initialize session by setting general options
@@ -601,4 +1253,44 @@ bool SqlApiBase::IsVersionEqualOrHigher(int mj, int mi, int rel)
 		return true;
 
 	return false;		
-}
\ No newline at end of file
+}
+
+// Convert all fetched rows of Oracle DATE column to text
+void SqlApiBase::OraDatesToStr(SqlCol *col, size_t rows, char *out)
+{
+	if(col == NULL || out == NULL)
+		return;
+
+	unsigned char *data = (unsigned char*)col->_data;
+
+	// NULL rows are converted too, it is faster than checking indicators and their text is not used
+	for(size_t i = 0; i < rows; i++)
+	{
+		Str::OraDate2Str(data, out);
+
+		data += col->_fetch_len;
+		out += SQLDATA_ORA_DATE_STR_LEN;
+	}
+}
+
+// Convert all fetched rows of ODBC TIMESTAMP column fetched as SQL_TIMESTAMP_STRUCT to text
+void SqlApiBase::OdbcTimestampsToStr(SqlCol *col, size_t rows, long fraction_div, bool fraction_div_exact, char *out)
+{
+	if(col == NULL || out == NULL)
+		return;
+
+	SQL_TIMESTAMP_STRUCT *ts = (SQL_TIMESTAMP_STRUCT*)col->_data;
+
+	for(size_t i = 0; i < rows; i++, ts++)
+	{
+		long fraction = (long)ts->fraction;
+
+		if(fraction_div > 1 && (!fraction_div_exact || fraction % fraction_div == 0))
+			fraction = fraction/fraction_div;
+
+		// Puts terminating 0 that is overwritten by the next row
+		Str::SqlTs2Str((short)ts->year, (short)ts->month, (short)ts->day, (short)ts->hour, (short)ts->minute, (short)ts->second, fraction, out);
+
+		out += SQLDATA_ODBC_TS_STR_LEN;
+	}
+}
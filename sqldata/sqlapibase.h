@@ -21,6 +21,9 @@
 
 #include <string>
 #include <list>
+#include <map>
+#include <vector>
+#include <set>
 #include "parameters.h"
 #include "applog.h"
 #include "file.h"
@@ -36,6 +39,16 @@
 #define FK_ACTION_SET_NULL		4
 #define FK_ACTION_SET_DEFAULT	5
 
+// Default size of the buffer to stream LOB values in pieces from the source to the target
+#define SQLDATA_LOB_CHUNK_SIZE	(1024*1024)
+
+// Length of text representation of Oracle DATE and ODBC TIMESTAMP with 6-digit fraction
+#define SQLDATA_ORA_DATE_STR_LEN	19
+#define SQLDATA_ODBC_TS_STR_LEN		26
+
+// Header of the metadata snapshot file, change the version when the catalog structures change
+#define SQLDATA_META_CACHE_HEADER	"SQLDATA_META_CACHE 1\n"
+
 #define TRACE(mess) { if(_trace && _log != NULL) _log->Trace(mess); }
 #define TRACE_P(mess, ...) { if(_trace && _log != NULL) _log->Trace(mess, ##__VA_ARGS__); }
 #define TRACE_S(obj, mess) { if(obj->_trace && obj->_log != NULL) obj->_log->Trace(mess); }
@@ -427,6 +440,15 @@ struct SqlSequences
 	}
 };
 
+// Catalog objects of a table, items point to the catalog lists
+struct SqlTableCatalog
+{
+	std::vector<SqlColMeta*> columns;
+	std::vector<SqlConstraints*> constraints;
+	std::vector<SqlIndexes*> indexes;
+	std::vector<SqlComments*> comments;
+};
+
 class SqlApiBase
 {
 protected:
@@ -434,6 +456,8 @@ protected:
 	static bool _static_init; 
 	// Connection to the database is established
 	bool _connected; 
+	// Use the protocol compression of the driver for new connections
+	bool _compress;
 
 	// Database subtype
 	int _subtype;
@@ -442,6 +466,8 @@ protected:
 	size_t _cursor_cols_count;
 	// Number of allocated rows for cursor
 	size_t _cursor_allocated_rows;
+	// Number of rows requested by the next fetch (0 means all allocated rows)
+	size_t _cursor_fetch_rows;
 	// Column describtions and data
 	SqlCol *_cursor_cols;
 	// A LOB column exists in the cursor
@@ -469,6 +495,36 @@ protected:
 	std::list<SqlSequences> _sequences;
 	std::list<std::string> _reserved_words_ddl;
 
+	// Catalog index by SCHEMA.TABLE (in upper case), constraint columns by SCHEMA.CONSTRAINT and index columns 
+	// by SCHEMA.INDEX, so lookups do not scan the catalog lists for each table
+	std::map<std::string, SqlTableCatalog> _catalog_tables;
+	std::map<std::string, std::vector<SqlConsColumns*> > _catalog_cons_columns;
+	std::map<std::string, std::vector<SqlIndColumns*> > _catalog_ind_columns;
+	// Number of catalog items when the index was built, the index is rebuilt if rows were added
+	size_t _catalog_indexed_items;
+	// Index is built and its items point to the current catalog rows
+	bool _catalog_indexed;
+
+	// Build the catalog index from the catalog lists
+	void BuildCatalogIndex();
+	// Clear the catalog index when catalog rows are removed or replaced, it is rebuilt on the next lookup
+	void ClearCatalogIndex();
+	// Get catalog index key SCHEMA.NAME
+	static void GetCatalogKey(const char *schema, const char *name, std::string &key);
+
+	// Write and read values of the metadata snapshot file
+	static void PutCacheValue(std::string &out, const char *value);
+	static void PutCacheValue(std::string &out, int value);
+	static bool GetCacheValue(const char **cur, const char *end, char **value);
+	static bool GetCacheValue(const char **cur, const char *end, int *value);
+	static bool GetCacheValue(const char **cur, const char *end, bool *value);
+	static bool GetCacheValue(const char **cur, const char *end, char *value);
+
+	// Convert all fetched rows of Oracle DATE or ODBC TIMESTAMP column to fixed length text (the output has the text length 
+	// per row plus 1 byte), the fraction is divided if required by the source (only if divisible when exact is set)
+	static void OraDatesToStr(SqlCol *col, size_t rows, char *out);
+	static void OdbcTimestampsToStr(SqlCol *col, size_t rows, long fraction_div, bool fraction_div_exact, char *out);
+
 	// Error information
 	int _error;
 	char _error_text[1024];
@@ -508,11 +564,19 @@ protected:
     // the maximum LOB value, default is to read LOBs by separate calls
     int _lob_bind_buffer;
 
+	// Size of the buffer to read LOB values by parts (GetLobPart) when the target streams them, limits memory used 
+	// for a LOB value regardless of its size
+	size_t _lob_chunk_size;
+
 	// When converting from ASCII or UTF16/UCS-2 character sets in the source database to UTF8 i.e. in the target database depending on 
 	// the actual data you may need greater storage size. And vice versa converting in opposite direction you may require smaller storage size.
 	// This parameter specifies the length change ratio. If the source length is 100, and ratio is 1.1 then the target length will be 110 
 	float _char_length_ratio;
 
+	// Time spent sending data to the database in the last TransferRows call, -1 if the API does not measure it separately
+	// from data conversion
+	int _transfer_send_time;
+
 	// Library is in trace mode
 	bool _trace;
 	bool _trace_data;
@@ -578,9 +642,26 @@ public:
 	// Specifies whether target bound source buffers, so the same buffers must be passed to TransferRows
 	virtual bool IsDataBufferBound() { return false; }
 
+	// Specifies whether API can fetch into (source) or rebind (target) buffers allocated by the caller, so fetched
+	// buffers can be handed over to the target without copying data
+	virtual bool IsBufferExchangeSupported() { return false; }
+	// Fetch next rows into the specified buffers (same layout as buffers returned by OpenCursor)
+	virtual int SetFetchBuffers(SqlCol * /*cols*/) { return -1; }
+	// Rebind source buffers bound in InitBulkTransfer to the specified buffers
+	virtual int SetTransferBuffers(SqlCol * /*s_cols*/) { return -1; }
+
+	// Set the number of rows for next fetches (not greater than allocated), -1 if the API always fetches all allocated rows
+	virtual int SetFetchRows(size_t /*rows*/) { return -1; }
+
+	// Enable the driver protocol compression for next connections, -1 if the driver does not support it
+	virtual int SetCompress(bool /*compress*/) { return -1; }
+
 	// Get the maximum size of a character in the client character set in bytes (4 for UTF-8)
 	virtual int GetCharMaxSizeInBytes() { return -1; }
 
+	// Get time spent sending data in the last TransferRows call (-1 if not measured)
+	int GetTransferSendTime() { return _transfer_send_time; }
+
 	// Complete bulk transfer
 	virtual int CloseBulkTransfer() = 0;
 
@@ -600,6 +681,8 @@ public:
 	virtual int GetLobContent(size_t row, size_t column, void *data, size_t length, int *len_ind) = 0;
 	// Get partial LOB content
 	virtual int GetLobPart(size_t row, size_t column, void *data, size_t length, int *len_ind) = 0;
+	// Specifies whether LOB can be read into the caller buffer in pieces by GetLobPart
+	virtual bool IsLobPartReadSupported() { return false; }
 
 	// Get the list of available tables
 	virtual int GetAvailableTables(std::string &table_template, std::string &exclude, 
@@ -668,6 +751,21 @@ public:
 	std::list<SqlIndExp>* GetIndexExpressions() { return &_table_ind_expressions; }
 	std::list<SqlSequences>* GetSequences() { return &_sequences; }
 
+	// Get indexed catalog objects of the table, NULL if the table has no catalog objects
+	SqlTableCatalog* GetCatalogTable(const char *schema, const char *table);
+	// Check whether the table has an identity column
+	bool IsIdentityDefined(std::string &schema, std::string &table);
+	// Get constraint columns by schema and constraint name (in the catalog order)
+	std::vector<SqlConsColumns*>* GetCatalogConstraintColumns(const char *schema, const char *constraint);
+	// Get index columns by schema and index name (in the catalog order)
+	std::vector<SqlIndColumns*>* GetCatalogIndexColumns(const char *schema, const char *index);
+
+	// Save the catalog lists to the metadata snapshot file, and load them from the file
+	int SaveSchemaCache(const char *file, const char *key, const char *fingerprint);
+	int LoadSchemaCache(const char *file, const char *key, std::string &fingerprint);
+	// Remove catalog rows of the specified tables (SCHEMA.TABLE in upper case)
+	void RemoveSchemaTables(std::set<std::string> &tables);
+
 	// Check if identifier is a reserved word
 	bool IsReservedWord(const char *name);
     bool IsReservedWord(std::string &name) { return IsReservedWord(name.c_str()); }
@@ -19,10 +19,20 @@
 #if defined(WIN32) || defined(_WIN64)
 #include <windows.h>
 #include <process.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
 #endif
 
 #include <stdio.h>
 #include <algorithm>
+#include <vector>
 #include "sqldata.h"
 #include "str.h"
 #include "sqlparserexp.h"
@@ -50,6 +60,12 @@ SqlData::SqlData()
 	_workers = -1;
 	_local_workers = -1;
 
+	_worker_socket = -1;
+	_listen_socket = -1;
+#if !defined(WIN32) && !defined(_WIN64)
+	_accept_thread_started = false;
+#endif
+
 #if defined(WIN32) || defined(_WIN64)
 	_completed_event = NULL;
 
@@ -108,6 +124,41 @@ int SqlData::Run()
 
 	size_t start = GetTickCount();
 
+#if !defined(WIN32) && !defined(_WIN64)
+	const char *listen_address = (_parameters != NULL) ? _parameters->Get("-wrk_listen") : NULL;
+	std::string address;
+
+	// Accept worker processes, local processes use a Unix domain socket by default
+	if(listen_address != NULL)
+		address = listen_address;
+	else
+	if(_workers > 0)
+	{
+		char pid[21];
+		sprintf(pid, "%d", (int)getpid());
+
+		address = SQLDATA_WORKER_SOCKET;
+		address += pid;
+		address += ".sock";
+	}
+
+	if(address.empty() == false)
+	{
+		_listen_socket = ListenSocket(address.c_str());
+
+		if(_listen_socket != -1)
+		{
+			_accept_thread_started = (pthread_create(&_accept_thread, NULL, &SqlData::StartSessionsS, this) == 0);
+
+			if(_workers > 0)
+				StartWorkerProcesses(address.c_str());
+		}
+		else
+		if(_log != NULL)
+			_log->Log("\n  Failed to listen for worker processes on %s", address.c_str());
+	}
+#endif
+
 	// Start local in-process workers
 	StartLocalWorkers();
 
@@ -116,6 +167,38 @@ int SqlData::Run()
 	WaitForSingleObject(_completed_event, INFINITE);
 #else
 	Os::WaitForEvent(&_completed_event);
+
+	// Stop accepting worker processes, workers connecting later find no tasks
+	if(_listen_socket != -1)
+	{
+		shutdown(_listen_socket, SHUT_RDWR);
+		close(_listen_socket);
+
+		_listen_socket = -1;
+
+		if(strncmp(address.c_str(), "unix:", 5) == 0)
+			unlink(address.c_str() + 5);
+	}
+
+	// accept() fails once the listening socket is closed, so no more session threads are started after this
+	if(_accept_thread_started)
+	{
+		pthread_join(_accept_thread, NULL);
+		_accept_thread_started = false;
+	}
+#endif
+
+	JoinSessionThreads();
+
+#if !defined(WIN32) && !defined(_WIN64)
+	// Each session sent NO_MORE_TASKS to its worker process, wait until all worker processes exit
+	for(std::list<int>::iterator i = _worker_pids.begin(); i != _worker_pids.end(); i++)
+	{
+		while(waitpid((pid_t)(*i), NULL, 0) == -1 && errno == EINTR)
+			;
+	}
+
+	_worker_pids.clear();
 #endif
 
 	// Notify on operation completion
@@ -318,7 +401,6 @@ int SqlData::CreateMetadataQueues(std::string &select, std::string &exclude)
 	}
 
 	std::list<SqlConstraints> *table_constraints = _db.GetTableConstraints(SQLDB_SOURCE_ONLY);
-	std::list<SqlConsColumns> *table_cons_columns = _db.GetConstraintColumns(SQLDB_SOURCE_ONLY);
 
 	if(table_constraints != NULL)
 	{
@@ -405,13 +487,17 @@ int SqlData::CreateMetadataQueues(std::string &select, std::string &exclude)
 				std::string fcols;
 				std::string pcols;
 
+				std::vector<SqlConsColumns*> *fk_columns = _db.GetConstraintColumns(SQLDB_SOURCE_ONLY, (*i).schema, (*i).constraint);
+
 				// Find constraint columns
-				for(std::list<SqlConsColumns>::iterator k = table_cons_columns->begin(); k != table_cons_columns->end(); k++)
+				for(size_t k = 0; fk_columns != NULL && k < fk_columns->size(); k++)
 				{
+					SqlConsColumns *col = (*fk_columns)[k];
+
 					// Compare schema, table and constraint names (columns are already ordered)
-					if((*k).schema != NULL && strcmp((*k).schema, (*i).schema) == 0 &&
-						(*k).table != NULL && strcmp((*k).table, (*i).table) == 0 &&
-						(*k).constraint != NULL && strcmp((*k).constraint, (*i).constraint) == 0)
+					if(col->schema != NULL && strcmp(col->schema, (*i).schema) == 0 &&
+						col->table != NULL && strcmp(col->table, (*i).table) == 0 &&
+						col->constraint != NULL && strcmp(col->constraint, (*i).constraint) == 0)
 					{
 						if(fcols.empty() == false)
 							fcols += ", ";
@@ -419,15 +505,22 @@ int SqlData::CreateMetadataQueues(std::string &select, std::string &exclude)
 						if(_target_type == SQL_SQL_SERVER)
 							fcols += '[';
 
-						fcols += (*k).column;
+						fcols += col->column;
 
 						if(_target_type == SQL_SQL_SERVER)
 							fcols += ']';
 					}
+				}
+
+				std::vector<SqlConsColumns*> *pk_columns = _db.GetConstraintColumns(SQLDB_SOURCE_ONLY, (*i).r_schema, (*i).r_constraint);
 
-					// Get primary or unique key columns 
-					if((*k).schema != NULL && strcmp((*k).schema, (*i).r_schema) == 0 &&
-						(*k).constraint != NULL && strcmp((*k).constraint, (*i).r_constraint) == 0)
+				// Get primary or unique key columns 
+				for(size_t k = 0; pk_columns != NULL && k < pk_columns->size(); k++)
+				{
+					SqlConsColumns *col = (*pk_columns)[k];
+
+					if(col->schema != NULL && strcmp(col->schema, (*i).r_schema) == 0 &&
+						col->constraint != NULL && strcmp(col->constraint, (*i).r_constraint) == 0)
 					{
 						if(pcols.empty() == false)
 							pcols += ", ";
@@ -435,12 +528,12 @@ int SqlData::CreateMetadataQueues(std::string &select, std::string &exclude)
 						if(_target_type == SQL_SQL_SERVER)
 							pcols += '[';
 
-						pcols += (*k).column;
+						pcols += col->column;
 
 						if(_target_type == SQL_SQL_SERVER)
 							pcols += ']';
 
-						ptable = (*k).table;
+						ptable = col->table;
 					}
 				}
 
@@ -939,13 +1032,7 @@ void SqlData::SetTableMappingFromFile(std::string &file)
 			break;
 
 		// Get the source table name until ,
-		while(*cur && *cur != ',')
-		{
-			source += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(source);
+		cur = Str::GetField(cur, ",", source);
 
 		if(*cur == ',')
 			cur++;
@@ -955,16 +1042,12 @@ void SqlData::SetTableMappingFromFile(std::string &file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get the target table name until new line
-		while(*cur && *cur != '\r' && *cur != '\n')
-		{
-			target += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(target);
+		cur = Str::GetField(cur, "\r\n", target);
 
 		_table_map.insert(std::pair<std::string, std::string>(source, target));
 	}
+
+	delete [] input;
 }
 
 // Set column name mapping
@@ -1008,13 +1091,7 @@ void SqlData::SetColumnMappingFromFile(std::string &file)
 		std::string object;
 
 		// Get schema.object until ,
-		while(*cur && *cur != ',')
-		{
-			object += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(object);
+		cur = Str::GetField(cur, ",", object);
 
 		SqlApiBase::SplitQualifiedName(object.c_str(), col.schema, col.table);
 
@@ -1026,13 +1103,7 @@ void SqlData::SetColumnMappingFromFile(std::string &file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get source column name until ,
-		while(*cur && *cur != ',')
-		{
-			col.name += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(col.name);
+		cur = Str::GetField(cur, ",", col.name);
 
 		if(*cur == ',')
 			cur++;
@@ -1042,13 +1113,7 @@ void SqlData::SetColumnMappingFromFile(std::string &file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get target column name until , or newline/tab
-		while(*cur && *cur != ',' && *cur != '\r' && *cur != '\n' && *cur != '\t')
-		{
-			col.t_name += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(col.t_name);
+		cur = Str::GetField(cur, ",\r\n\t", col.t_name);
 
 		if(*cur == ',')
 			cur++;
@@ -1062,16 +1127,12 @@ void SqlData::SetColumnMappingFromFile(std::string &file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get the target name until new line
-		while(*cur && *cur != '\r' && *cur != '\n' && *cur != '\t')
-		{
-			col.t_type += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(col.t_type);
+		cur = Str::GetField(cur, "\r\n\t", col.t_type);
 
 		_column_map.push_back(col);
 	}
+
+	delete [] input;
 }
 
 // Set constraint name mapping
@@ -1109,13 +1170,7 @@ void SqlData::SetConstraintMappingFromFile(std::string &file)
 			break;
 
 		// Get schema.table until ,
-		while(*cur && *cur != ',')
-		{
-			table += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(table);
+		cur = Str::GetField(cur, ",", table);
 
 		if(*cur == ',')
 			cur++;
@@ -1125,13 +1180,7 @@ void SqlData::SetConstraintMappingFromFile(std::string &file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get source constraint name until ,
-		while(*cur && *cur != ',')
-		{
-			source_cns += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(source_cns);
+		cur = Str::GetField(cur, ",", source_cns);
 
 		if(*cur == ',')
 			cur++;
@@ -1141,16 +1190,12 @@ void SqlData::SetConstraintMappingFromFile(std::string &file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get target constraint name until , or newline or tab
-		while(*cur && *cur != ',' && *cur != '\r' && *cur != '\n' && *cur != '\t')
-		{
-			target_cns += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(target_cns);
+		cur = Str::GetField(cur, ",\r\n\t", target_cns);
 
 		_cns_map.insert(std::pair<std::string, std::string>(table + ',' + source_cns, target_cns));
 	}
+
+	delete [] input;
 }
 
 // Set global data type mapping
@@ -1194,13 +1239,7 @@ void SqlData::SetDataTypeMappingFromFile(std::string &file)
 			break;
 
 		// Get the source data type name until , or (
-		while(*cur && *cur != ',' && *cur != '(')
-		{
-			dt.name += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(dt.name);
+		cur = Str::GetField(cur, ",(", dt.name);
 
         // Length range
         if(*cur == '(')
@@ -1241,13 +1280,7 @@ void SqlData::SetDataTypeMappingFromFile(std::string &file)
                 if(*cur != '*')
                 {
                     // Get the minimal scale until - or )
-		            while(*cur && *cur != '-' && *cur != ')')
-		            {
-			            scale += *cur;
-			            cur++;
-		            }
-
-                    Str::TrimTrailingSpaces(scale);
+		            cur = Str::GetField(cur, "-)", scale);
 
                     int num = -1;
                     sscanf(scale.c_str(), "%d", &num);
@@ -1273,16 +1306,12 @@ void SqlData::SetDataTypeMappingFromFile(std::string &file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get the target data type until new line
-		while(*cur && *cur != '\r' && *cur != '\n' && *cur != '\t')
-		{
-			dt.t_name += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(dt.t_name);
+		cur = Str::GetField(cur, "\r\n\t", dt.t_name);
 
 		_datatype_map.push_back(dt);
 	}
+
+	delete [] input;
 }
 
 // Set table select expressions from file
@@ -1527,16 +1556,35 @@ int SqlData::StartLocalWorkers()
 	else
 		local = _local_workers;
 
+	// Count all local workers before starting threads, so the first worker cannot signal completion while others are still connecting
+	Os::EnterCriticalSection(&_worker_critical_section);
+
+	_running_workers += local;
+
+	// Session IDs are shared with worker processes that may be connecting at the same time
+	int first_session_id = _all_workers + 1;
+	_all_workers += local;
+
+	Os::LeaveCriticalSection(&_worker_critical_section);
+
 	// Start a local worker thread using existing database interface
 	if(local >= 1)
 	{
+		_db.SetSessionId(first_session_id);
+
+		Os::EnterCriticalSection(&_worker_critical_section);
 #if defined(WIN32) || defined(_WIN64)
-		_beginthreadex(NULL, 0, &SqlData::StartLocalWorkerS, data, 0, NULL);
+		HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, &SqlData::StartLocalWorkerS, data, 0, NULL);
+
+		if(thread != NULL)
+			_session_threads.push_back(thread);
 #else
 		pthread_t thread;
-		pthread_create(&thread, NULL, &SqlData::StartLocalWorkerS, data);
+
+		if(pthread_create(&thread, NULL, &SqlData::StartLocalWorkerS, data) == 0)
+			_session_threads.push_back(thread);
 #endif
-		_all_workers++;
+		Os::LeaveCriticalSection(&_worker_critical_section);
 	}
 
 	// Start additional worker threads
@@ -1552,7 +1600,7 @@ int SqlData::StartLocalWorkers()
 		sqlDb->SetMetaDb(&_db);
 		sqlDb->SetParameters(_parameters);
 		sqlDb->SetAppLog(_log);
-		sqlDb->SetSessionId(i + 1);
+		sqlDb->SetSessionId(first_session_id + i);
 
 		sqlDb->SetColumnMapping(&_column_map);
         sqlDb->SetDataTypeMapping(&_datatype_map);
@@ -1560,26 +1608,25 @@ int SqlData::StartLocalWorkers()
 		sqlDb->SetTableSelectExpressionsAll(&_tsel_exp_all);
 		sqlDb->SetTableWhereConditions(&_twhere_cond_map);
 
-		SqlDataReply reply;
-
-		int db_types = (_command != SQLDATA_CMD_ASSESS) ? SQLDB_BOTH : SQLDB_SOURCE_ONLY;
-		
-		// Connect to the databases
-		sqlDb->Init(db_types, _source_conn.c_str(), _target_conn.c_str(), NULL, NULL);
-		sqlDb->Connect(db_types, reply, NULL, NULL);
-
+		// Session connects to the databases in its own thread, so all sessions connect concurrently
 		sqlDb->SetCallbackRate(_callback_rate);
 		sqlDb->SetCallback(this, CallbackS);
 
 		data[1] = sqlDb;
 
+		Os::EnterCriticalSection(&_worker_critical_section);
 #if defined(WIN32) || defined(_WIN64)
-		_beginthreadex(NULL, 0, &SqlData::StartLocalWorkerS, data, 0, NULL);
+		HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, &SqlData::StartLocalWorkerS, data, 0, NULL);
+
+		if(thread != NULL)
+			_session_threads.push_back(thread);
 #else
 		pthread_t thread;
-		pthread_create(&thread, NULL, &SqlData::StartLocalWorkerS, data);
+
+		if(pthread_create(&thread, NULL, &SqlData::StartLocalWorkerS, data) == 0)
+			_session_threads.push_back(thread);
 #endif
-		_all_workers++;
+		Os::LeaveCriticalSection(&_worker_critical_section);
 	}
 	return 0;
 }
@@ -1606,15 +1653,17 @@ void* SqlData::StartLocalWorkerS(void *dt)
 
 	if(sqlData != NULL && sqlDb != NULL)
 	{
-		// Use critical section to increment the number of workers
-		Os::EnterCriticalSection(&sqlData->_worker_critical_section);
+		rc = 0;
 
-		sqlData->_running_workers++;
+		// Additional sessions are not connected yet
+		if(sqlDb != &sqlData->_db)
+			rc = sqlData->ConnectLocalWorker(sqlDb);
 
-		Os::LeaveCriticalSection(&sqlData->_worker_critical_section);
-	
-		// Run the worker
-		rc = sqlData->StartLocalWorker(sqlDb);
+		// Run the worker as soon as its own connection is ready
+		if(rc == 0)
+			rc = sqlData->StartLocalWorker(sqlDb);
+		else
+			sqlData->NotifyWorkerExit();
 	}
 
 	// Delete database API object if they do not belong to manager internal object
@@ -1630,6 +1679,76 @@ void* SqlData::StartLocalWorkerS(void *dt)
 #endif
 }
 
+// Connect additional local session, retry with increasing delay on failure
+int SqlData::ConnectLocalWorker(SqlDb *sqlDb)
+{
+	if(sqlDb == NULL)
+		return -1;
+
+	int db_types = (_command != SQLDATA_CMD_ASSESS) ? SQLDB_BOTH : SQLDB_SOURCE_ONLY;
+
+	int retries = SQLDATA_CONNECT_RETRIES;
+	int delay = SQLDATA_CONNECT_RETRY_DELAY;
+
+	if(_parameters != NULL)
+	{
+		retries = _parameters->GetInt("-session_connect_retries", retries);
+		delay = _parameters->GetInt("-session_connect_retry_delay", delay);
+	}
+
+	int s_rc = 0;
+	int t_rc = 0;
+
+	// Load database libraries and create API objects, not repeated on connection failure
+	sqlDb->Init(db_types, _source_conn.c_str(), _target_conn.c_str(), &s_rc, &t_rc);
+
+	SqlDataReply reply;
+
+	int rc = -1;
+	int attempts = 0;
+
+	if(s_rc != -1 && t_rc != -1)
+	{
+		rc = sqlDb->Connect(db_types, reply, NULL, NULL);
+		attempts++;
+	}
+
+	// Connect() of each API returns at once if it is already connected, so only the failed side is reconnected on retry
+	while(rc == -1 && attempts > 0 && attempts <= retries)
+	{
+		Os::Sleep(delay);
+
+		// Double the delay up to the limit
+		delay *= 2;
+
+		if(delay > SQLDATA_CONNECT_RETRY_DELAY_MAX)
+			delay = SQLDATA_CONNECT_RETRY_DELAY_MAX;
+
+		rc = sqlDb->Connect(db_types, reply, NULL, NULL);
+		attempts++;
+	}
+
+	if(rc == -1 && _log != NULL)
+	{
+		Os::EnterCriticalSection(&_worker_critical_section);
+
+		if(attempts == 0)
+			_log->Log("\n  Session %d failed to initialize database API", sqlDb->GetSessionId());
+		else
+			_log->Log("\n  Session %d failed to connect (%d attempts)", sqlDb->GetSessionId(), attempts);
+
+		if(reply.s_error == -1)
+			_log->Log("\n    Source: %s", reply.s_native_error_text);
+
+		if(reply.t_error == -1)
+			_log->Log("\n    Target: %s", reply.t_native_error_text);
+
+		Os::LeaveCriticalSection(&_worker_critical_section);
+	}
+
+	return rc;
+}
+
 int SqlData::StartLocalWorker(SqlDb *sqlDb)
 {
 	if(sqlDb == NULL)
@@ -1666,35 +1785,8 @@ int SqlData::StartLocalWorker(SqlDb *sqlDb)
 			strcpy(reply._t_name, t_table.c_str());
 		}
 
-		// Execute transfer command
-		if(_command == SQLDATA_CMD_TRANSFER)
-		{
-			if(_migrate_tables || _migrate_data)
-				reply.rc = sqlDb->TransferRows(reply, _command_options, _migrate_tables, _migrate_data);
-			else
-			{
-				reply.rc = 0;
-				reply._cmd_subtype = SQLDATA_CMD_SKIPPED;
-			}
-		}
-		else
-		// Execute validate row cound command
-		if(_command == SQLDATA_CMD_VALIDATE)
-		{
-			// Row count validation
-			if(_command_options == SQLDATA_OPT_ROWCOUNT)
-				reply.rc = sqlDb->ValidateRowCount(reply);
-			else
-			// Data validation
-			if(_command_options == SQLDATA_OPT_ROWS)
-				reply.rc = sqlDb->ValidateRows(reply);
-		}
-		else
-		// Execute assessment command
-		if(_command == SQLDATA_CMD_ASSESS)
-		{
-			reply.rc = sqlDb->AssessRows(reply);
-		}
+		// Execute transfer, validation or assessment command
+		ExecuteTableTask(sqlDb, reply);
 
 		// Notify that the table processing (data transfer) completed
 		NotifyTableCompletion(s_table);
@@ -1763,6 +1855,40 @@ int SqlData::StartLocalWorker(SqlDb *sqlDb)
 	return 0;
 }
 
+// Execute transfer, validation or assessment command for the table set in reply
+void SqlData::ExecuteTableTask(SqlDb *sqlDb, SqlDataReply &reply)
+{
+	// Execute transfer command
+	if(_command == SQLDATA_CMD_TRANSFER)
+	{
+		if(_migrate_tables || _migrate_data)
+			reply.rc = sqlDb->TransferRows(reply, _command_options, _migrate_tables, _migrate_data);
+		else
+		{
+			reply.rc = 0;
+			reply._cmd_subtype = SQLDATA_CMD_SKIPPED;
+		}
+	}
+	else
+	// Execute validate row cound command
+	if(_command == SQLDATA_CMD_VALIDATE)
+	{
+		// Row count validation
+		if(_command_options == SQLDATA_OPT_ROWCOUNT)
+			reply.rc = sqlDb->ValidateRowCount(reply);
+		else
+		// Data validation
+		if(_command_options == SQLDATA_OPT_ROWS)
+			reply.rc = sqlDb->ValidateRows(reply);
+	}
+	else
+	// Execute assessment command
+	if(_command == SQLDATA_CMD_ASSESS)
+	{
+		reply.rc = sqlDb->AssessRows(reply);
+	}
+}
+
 // Start a communication with a worker process
 #if defined(WIN32) || defined(_WIN64)
 unsigned int __stdcall SqlData::StartWorkerS(void *object)
@@ -1837,6 +1963,556 @@ int SqlData::StartWorker(HANDLE hp)
 }
 #endif
 
+#if !defined(WIN32) && !defined(_WIN64)
+// Start communication sessions with worker processes
+void* SqlData::StartSessionsS(void *object)
+{
+	SqlData *sqlData = (SqlData*)object;
+
+	if(sqlData != NULL)
+		sqlData->StartSessions();
+
+	return NULL;
+}
+
+// Start communication sessions with worker processes
+int SqlData::StartSessions()
+{
+	if(_listen_socket == -1)
+		return -1;
+
+	bool more = true;
+
+	// Connection loop, ends when the listening socket is closed
+	while(more)
+	{
+		int sock = accept(_listen_socket, NULL, NULL);
+
+		if(sock == -1)
+		{
+			if(errno == EINTR)
+				continue;
+
+			more = false;
+			break;
+		}
+
+		SqlDataPipe *dp = new SqlDataPipe();
+		dp->sd = this;
+		dp->sock = sock;
+
+		pthread_t thread;
+
+		Os::EnterCriticalSection(&_worker_critical_section);
+
+		if(pthread_create(&thread, NULL, &SqlData::StartWorkerS, dp) == 0)
+			_session_threads.push_back(thread);
+
+		Os::LeaveCriticalSection(&_worker_critical_section);
+	}
+
+	return 0;
+}
+
+// Launch worker processes running the same command connected to this process
+int SqlData::StartWorkerProcesses(const char *address)
+{
+	if(address == NULL || _parameters == NULL)
+		return -1;
+
+	char exe[1024];
+	ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+
+	if(len <= 0)
+		return -1;
+
+	exe[len] = '\x0';
+
+	for(int i = 0; i < _workers; i++)
+	{
+		std::list<std::string> args;
+
+		// Pass all options except worker options, each worker writes its own log
+		for(ParametersMap::iterator p = _parameters->GetMap().begin(); p != _parameters->GetMap().end(); p++)
+		{
+			if(p->first == "-wrk" || p->first == "-lwrk" || p->first == "-log" || p->first == "-wrk_listen")
+				continue;
+
+			args.push_back(p->first + "=" + p->second);
+		}
+
+		char num[21];
+		sprintf(num, "%d", i + 1);
+
+		args.push_back(std::string("-wrk_connect=") + address);
+		args.push_back(std::string("-log=sqldata_wrk") + num + ".log");
+
+		// Build the argument array before fork(), the child of a multithreaded process can only call async-signal-safe functions
+		std::vector<char*> argv;
+		argv.push_back(exe);
+
+		for(std::list<std::string>::iterator a = args.begin(); a != args.end(); a++)
+			argv.push_back((char*)(*a).c_str());
+
+		argv.push_back(NULL);
+
+		pid_t pid = fork();
+
+		// Child process
+		if(pid == 0)
+		{
+			execv(exe, &argv[0]);
+			_exit(127);
+		}
+
+		if(pid > 0)
+			_worker_pids.push_back((int)pid);
+	}
+
+	return 0;
+}
+
+// Start a communication with a worker process
+void* SqlData::StartWorkerS(void *object)
+{
+	SqlDataPipe *sp = (SqlDataPipe*)object;
+
+	if(sp == NULL)
+		return NULL;
+
+	sp->sd->StartWorker(sp->sock);
+
+	delete sp;
+
+	return NULL;
+}
+
+// Send tables to a worker process and pass its replies to the callback
+int SqlData::StartWorker(int sock)
+{
+	Os::EnterCriticalSection(&_worker_critical_section);
+
+	_running_workers++;
+	_all_workers++;
+
+	int session_id = _all_workers;
+
+	Os::LeaveCriticalSection(&_worker_critical_section);
+
+	SqlDataCommand cmd;
+	SqlDataReply reply;
+
+	bool connected = true;
+
+	// Process tasks in a loop
+	while(connected)
+	{
+		// Get next table for processing
+		std::string s_table = GetNextTask();
+		std::string t_table;
+
+		// No more tables for processing
+		if(s_table.empty())
+			break;
+
+		// Get the target name
+		MapObjectName(s_table, t_table);
+
+		cmd._cmd = _command;
+		strncpy(cmd._s_name, s_table.c_str(), 1023);
+		strncpy(cmd._t_name, t_table.c_str(), 1023);
+
+		connected = (SendCommand(sock, cmd) == 0);
+
+		bool last = false;
+
+		// Wait for replies until the table is processed
+		while(connected && !last)
+		{
+			connected = (ReceiveReply(sock, reply, &last) == 0);
+
+			if(connected)
+			{
+				reply.session_id = session_id;
+				Callback(&reply);
+			}
+		}
+
+		// The worker process terminated, report the table as failed
+		if(!connected)
+		{
+			SqlDataReply failed;
+			failed._cmd = _command;
+			failed._cmd_subtype = SQLDATA_CMD_OPEN_CURSOR;
+			failed.session_id = session_id;
+			failed.rc = -1;
+
+			strcpy(failed._s_name, cmd._s_name);
+			strcpy(failed._t_name, cmd._t_name);
+			strcpy(failed.s_native_error_text, "Connection with the worker process lost");
+
+			Callback(&failed);
+		}
+
+		// Notify that the table processing (data transfer) completed
+		NotifyTableCompletion(s_table);
+	}
+
+	// Notify the worker that it can finish
+	if(connected)
+	{
+		cmd._cmd = SQLDATA_CMD_NO_MORE_TASKS;
+		SendCommand(sock, cmd);
+	}
+
+	close(sock);
+
+	NotifyWorkerExit();
+
+	return 0;
+}
+
+// Run as a worker process: get tables from the coordinator and send back the replies
+int SqlData::RunWorker(const char *address)
+{
+	_worker_socket = ConnectSocket(address);
+
+	if(_worker_socket == -1)
+		return -1;
+
+	SqlDataCommand cmd;
+
+	// Process tasks until the coordinator has no more tables
+	while(ReceiveCommand(_worker_socket, cmd) == 0 && cmd._cmd != SQLDATA_CMD_NO_MORE_TASKS)
+	{
+		SqlDataReply reply;
+		reply._cmd = _command;
+		reply.session_id = _db.GetSessionId();
+
+		strcpy(reply._s_name, cmd._s_name);
+		strcpy(reply._t_name, cmd._t_name);
+
+		ExecuteTableTask(&_db, reply);
+
+		// Final reply for the table
+		if(SendReply(_worker_socket, reply, true) == -1)
+			break;
+	}
+
+	close(_worker_socket);
+	_worker_socket = -1;
+
+	return 0;
+}
+
+// Parse the address unix:/path, host:port or port
+int SqlData::GetSocketAddress(const char *address, struct sockaddr_storage *addr, socklen_t *len, bool passive)
+{
+	if(address == NULL)
+		return -1;
+
+	memset(addr, 0, sizeof(struct sockaddr_storage));
+
+	// Unix domain socket
+	if(strncmp(address, "unix:", 5) == 0)
+	{
+		struct sockaddr_un *un = (struct sockaddr_un*)addr;
+
+		if(strlen(address + 5) >= sizeof(un->sun_path))
+			return -1;
+
+		un->sun_family = AF_UNIX;
+		strcpy(un->sun_path, address + 5);
+
+		*len = sizeof(struct sockaddr_un);
+		return AF_UNIX;
+	}
+
+	std::string host;
+	const char *port = strrchr(address, ':');
+
+	if(port != NULL)
+	{
+		host.assign(address, (size_t)(port - address));
+		port++;
+	}
+	else
+		port = address;
+
+	struct addrinfo hints;
+	struct addrinfo *result = NULL;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+	if(getaddrinfo(host.empty() ? NULL : host.c_str(), port, &hints, &result) != 0 || result == NULL)
+		return -1;
+
+	memcpy(addr, result->ai_addr, result->ai_addrlen);
+	*len = result->ai_addrlen;
+
+	freeaddrinfo(result);
+	return AF_INET;
+}
+
+// Open a socket to listen for worker processes
+int SqlData::ListenSocket(const char *address)
+{
+	struct sockaddr_storage addr;
+	socklen_t len = 0;
+
+	int family = GetSocketAddress(address, &addr, &len, true);
+
+	if(family == -1)
+		return -1;
+
+	int sock = socket(family, SOCK_STREAM, 0);
+
+	if(sock == -1)
+		return -1;
+
+	if(family == AF_UNIX)
+		unlink(((struct sockaddr_un*)&addr)->sun_path);
+	else
+	{
+		int on = 1;
+		setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	}
+
+	if(bind(sock, (struct sockaddr*)&addr, len) == -1 || listen(sock, SOMAXCONN) == -1)
+	{
+		close(sock);
+		return -1;
+	}
+
+	return sock;
+}
+
+// Connect to the coordinator process
+int SqlData::ConnectSocket(const char *address)
+{
+	struct sockaddr_storage addr;
+	socklen_t len = 0;
+
+	int family = GetSocketAddress(address, &addr, &len, false);
+
+	if(family == -1)
+		return -1;
+
+	int sock = socket(family, SOCK_STREAM, 0);
+
+	if(sock == -1)
+		return -1;
+
+	if(connect(sock, (struct sockaddr*)&addr, len) == -1)
+	{
+		close(sock);
+		return -1;
+	}
+
+	// Replies are small, do not delay them
+	if(family == AF_INET)
+	{
+		int on = 1;
+		setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	}
+
+	return sock;
+}
+
+// Send and receive the specified number of bytes
+int SqlData::SendAll(int sock, const void *data, size_t len)
+{
+	const char *cur = (const char*)data;
+
+	while(len > 0)
+	{
+		ssize_t rc = send(sock, cur, len, MSG_NOSIGNAL);
+
+		if(rc == -1 && errno == EINTR)
+			continue;
+
+		if(rc <= 0)
+			return -1;
+
+		cur += rc;
+		len -= (size_t)rc;
+	}
+
+	return 0;
+}
+
+int SqlData::ReceiveAll(int sock, void *data, size_t len)
+{
+	char *cur = (char*)data;
+
+	while(len > 0)
+	{
+		ssize_t rc = recv(sock, cur, len, 0);
+
+		if(rc == -1 && errno == EINTR)
+			continue;
+
+		if(rc <= 0)
+			return -1;
+
+		cur += rc;
+		len -= (size_t)rc;
+	}
+
+	return 0;
+}
+
+// Send and receive a command
+int SqlData::SendCommand(int sock, SqlDataCommand &cmd)
+{
+	return SendAll(sock, &cmd, sizeof(SqlDataCommand));
+}
+
+int SqlData::ReceiveCommand(int sock, SqlDataCommand &cmd)
+{
+	int rc = ReceiveAll(sock, &cmd, sizeof(SqlDataCommand));
+
+	cmd._s_name[1023] = '\x0';
+	cmd._t_name[1023] = '\x0';
+
+	return rc;
+}
+
+// Send a reply, pointers are replaced with the SQL text, other data blocks are not sent
+int SqlData::SendReply(int sock, SqlDataReply &reply, bool last)
+{
+	SqlDataReplyPacket packet;
+	memset(&packet, 0, sizeof(SqlDataReplyPacket));
+
+	packet._cmd = reply._cmd;
+	packet._cmd_subtype = reply._cmd_subtype;
+	packet.session_id = reply.session_id;
+	packet.rc = reply.rc;
+	packet._s_rc = reply._s_rc;
+	packet._t_rc = reply._t_rc;
+	packet._time_spent = (__int64)reply._time_spent;
+	packet._s_time_spent = (__int64)reply._s_time_spent;
+	packet._t_time_spent = (__int64)reply._t_time_spent;
+
+	memcpy(packet._s_name, reply._s_name, sizeof(packet._s_name));
+	memcpy(packet._t_name, reply._t_name, sizeof(packet._t_name));
+	memcpy(packet.t_o_name, reply.t_o_name, sizeof(packet.t_o_name));
+
+	packet._int1 = reply._int1;
+	packet._int2 = reply._int2;
+	packet._int3 = reply._int3;
+	packet._s_int1 = reply._s_int1;
+	packet._s_int2 = reply._s_int2;
+	packet._t_int1 = reply._t_int1;
+	packet._t_int2 = reply._t_int2;
+	packet._s_bigint1 = reply._s_bigint1;
+	packet._t_bigint1 = reply._t_bigint1;
+	memcpy(packet._stages, reply._stages, sizeof(packet._stages));
+	packet.s_error = reply.s_error;
+	packet.t_error = reply.t_error;
+
+	memcpy(packet.s_native_error_text, reply.s_native_error_text, sizeof(packet.s_native_error_text));
+	memcpy(packet.t_native_error_text, reply.t_native_error_text, sizeof(packet.t_native_error_text));
+	memcpy(packet.data2, reply.data2, sizeof(packet.data2));
+
+	// Column metadata is not sent for DDL dump
+	if(reply._cmd_subtype == SQLDATA_CMD_DUMP_DDL)
+		packet._int1 = 0;
+
+	const char *s_sql = (reply.s_sql != NULL) ? reply.s_sql : reply.s_sql_l.c_str();
+	const char *t_sql = (reply.t_sql != NULL) ? reply.t_sql : reply.t_sql_l.c_str();
+
+	packet.last = last ? 1 : 0;
+	packet.s_sql_len = (int)strlen(s_sql);
+	packet.t_sql_len = (int)strlen(t_sql);
+
+	if(SendAll(sock, &packet, sizeof(SqlDataReplyPacket)) == -1 || 
+		SendAll(sock, s_sql, (size_t)packet.s_sql_len) == -1 || SendAll(sock, t_sql, (size_t)packet.t_sql_len) == -1)
+		return -1;
+
+	return 0;
+}
+
+// Receive a reply, SQL text is available in s_sql_l and t_sql_l
+int SqlData::ReceiveReply(int sock, SqlDataReply &reply, bool *last)
+{
+	SqlDataReplyPacket packet;
+
+	if(ReceiveAll(sock, &packet, sizeof(SqlDataReplyPacket)) == -1 || packet.s_sql_len < 0 || packet.t_sql_len < 0)
+		return -1;
+
+	reply._cmd = packet._cmd;
+	reply._cmd_subtype = packet._cmd_subtype;
+	reply.session_id = packet.session_id;
+	reply.rc = packet.rc;
+	reply._s_rc = packet._s_rc;
+	reply._t_rc = packet._t_rc;
+	reply._time_spent = (size_t)packet._time_spent;
+	reply._s_time_spent = (size_t)packet._s_time_spent;
+	reply._t_time_spent = (size_t)packet._t_time_spent;
+
+	memcpy(reply._s_name, packet._s_name, sizeof(reply._s_name));
+	memcpy(reply._t_name, packet._t_name, sizeof(reply._t_name));
+	memcpy(reply.t_o_name, packet.t_o_name, sizeof(reply.t_o_name));
+
+	reply._int1 = packet._int1;
+	reply._int2 = packet._int2;
+	reply._int3 = packet._int3;
+	reply._s_int1 = packet._s_int1;
+	reply._s_int2 = packet._s_int2;
+	reply._t_int1 = packet._t_int1;
+	reply._t_int2 = packet._t_int2;
+	reply._s_bigint1 = packet._s_bigint1;
+	reply._t_bigint1 = packet._t_bigint1;
+	memcpy(reply._stages, packet._stages, sizeof(reply._stages));
+	reply.s_error = packet.s_error;
+	reply.t_error = packet.t_error;
+
+	memcpy(reply.s_native_error_text, packet.s_native_error_text, sizeof(reply.s_native_error_text));
+	memcpy(reply.t_native_error_text, packet.t_native_error_text, sizeof(reply.t_native_error_text));
+	memcpy(reply.data2, packet.data2, sizeof(reply.data2));
+
+	reply.s_sql_l.resize((size_t)packet.s_sql_len);
+	reply.t_sql_l.resize((size_t)packet.t_sql_len);
+
+	if((packet.s_sql_len > 0 && ReceiveAll(sock, &reply.s_sql_l[0], (size_t)packet.s_sql_len) == -1) ||
+		(packet.t_sql_len > 0 && ReceiveAll(sock, &reply.t_sql_l[0], (size_t)packet.t_sql_len) == -1))
+		return -1;
+
+	reply.s_sql = (packet.s_sql_len > 0) ? reply.s_sql_l.c_str() : NULL;
+	reply.t_sql = (packet.t_sql_len > 0) ? reply.t_sql_l.c_str() : NULL;
+	reply.data = NULL;
+
+	if(last != NULL)
+		*last = (packet.last != 0);
+
+	return 0;
+}
+#endif
+
+// Get the number of pending and in-progress table and metadata tasks
+void SqlData::GetQueueDepths(int *tables, int *tables_in_progress, int *meta, int *meta_in_progress)
+{
+	Os::EnterCriticalSection(&_task_queue_critical_section);
+
+	if(tables != NULL)
+		*tables = (_tables != NULL) ? (int)_tables->size() : 0;
+
+	if(tables_in_progress != NULL)
+		*tables_in_progress = (int)_tables_in_progress.size();
+
+	if(meta != NULL)
+		*meta = (int)_meta_tasks.size();
+
+	if(meta_in_progress != NULL)
+		*meta_in_progress = (int)_meta_in_progress.size();
+
+	Os::LeaveCriticalSection(&_task_queue_critical_section);
+}
+
 // Notify that the table processing (data transfer) completed
 void SqlData::NotifyTableCompletion(std::string table)
 {
@@ -1885,6 +2561,33 @@ void SqlData::NotifyWorkerExit()
 	Os::LeaveCriticalSection(&_worker_critical_section);
 }
 
+// Wait until local worker and session threads exit
+void SqlData::JoinSessionThreads()
+{
+	Os::EnterCriticalSection(&_worker_critical_section);
+
+#if defined(WIN32) || defined(_WIN64)
+	std::list<HANDLE> threads;
+#else
+	std::list<pthread_t> threads;
+#endif
+	threads.swap(_session_threads);
+
+	Os::LeaveCriticalSection(&_worker_critical_section);
+
+	// Threads exit soon after the completion event is set, they only release their resources
+#if defined(WIN32) || defined(_WIN64)
+	for(std::list<HANDLE>::iterator i = threads.begin(); i != threads.end(); i++)
+	{
+		WaitForSingleObject(*i, INFINITE);
+		CloseHandle(*i);
+	}
+#else
+	for(std::list<pthread_t>::iterator i = threads.begin(); i != threads.end(); i++)
+		pthread_join(*i, NULL);
+#endif
+}
+
 // Get next table for processing
 std::string SqlData::GetNextTask()
 {
@@ -2435,6 +3138,15 @@ void SqlData::Callback(SqlDataReply *reply)
 	if(reply == NULL)
 		return;
 
+#if !defined(WIN32) && !defined(_WIN64)
+	// In a worker process, send notifications to the coordinator
+	if(_worker_socket != -1)
+	{
+		SendReply(_worker_socket, *reply, false);
+		return;
+	}
+#endif
+
 	Os::EnterCriticalSection(&_worker_critical_section);
 
 	if(reply->_cmd_subtype == SQLDATA_CMD_COMPLETE)
@@ -23,6 +23,7 @@
 #include <windows.h>
 #else
 #include <pthread.h>
+#include <sys/socket.h>
 #endif
 
 #include <string>
@@ -51,12 +52,20 @@
 
 #define SQLDATA_DEFAULT_SESSIONS	4
 
+// Connection retries for additional sessions, delay in seconds is doubled after each attempt
+#define SQLDATA_CONNECT_RETRIES			3
+#define SQLDATA_CONNECT_RETRY_DELAY		1
+#define SQLDATA_CONNECT_RETRY_DELAY_MAX	30
+
 // SQLData named pipe
 #define SQLDATA_NAMED_PIPE			"\\\\.\\pipe\\SqlData"
 
 // SQLData worker process executable
 #define SQLDATA_WORKER_EXE			"sqldataworker.exe"
 
+// Default socket to communicate with local worker processes on Linux (process ID and .sock are appended)
+#define SQLDATA_WORKER_SOCKET		"unix:/tmp/sqldata_"
+
 struct SqlMetaTask
 {
 	int type;
@@ -120,6 +129,22 @@ class SqlData
 	short _workers;
 	short _local_workers;
 
+	// Socket connected to the coordinator process (in a worker process only), and socket to accept workers
+	int _worker_socket;
+	int _listen_socket;
+	// Started worker processes
+	std::list<int> _worker_pids;
+
+	// Threads of local workers and of sessions with worker processes, joined before Run() returns
+#if defined(WIN32) || defined(_WIN64)
+	std::list<HANDLE> _session_threads;
+#else
+	std::list<pthread_t> _session_threads;
+	// Thread accepting worker processes
+	pthread_t _accept_thread;
+	bool _accept_thread_started;
+#endif
+
 	// Number of concurrent sessions
 	int _max_sessions;
 
@@ -214,6 +239,9 @@ public:
 	// Test connection
 	int TestConnection(std::string &conn, std::string &error, std::string &loaded_path, std::list<std::string> &search_paths, size_t *time_spent);
 
+	// Get the number of pending and in-progress table and metadata tasks
+	void GetQueueDepths(int *tables, int *tables_in_progress, int *meta, int *meta_in_progress);
+
 	// Create queues to transfer schema metadata
 	int CreateMetadataQueues(std::string &select, std::string &exclude);
 	void CreateMetadataTaskForColumnDefault(SqlColMeta &col);
@@ -264,6 +292,9 @@ public:
 	// Drop references to the selected tables in the target database
 	int DropReferences(int *all_keys, size_t *time_spent);
 
+	// Run as a worker process processing tables received from the coordinator process
+	int RunWorker(const char *address);
+
 	// Callbacks
 	void Callback(SqlDataReply *reply);
 	static void CallbackS(void *object, SqlDataReply *reply);
@@ -281,6 +312,7 @@ private:
 
 	// Start local in-process workers
 	int StartLocalWorkers();
+	int ConnectLocalWorker(SqlDb *sqlDb);
 	int StartLocalWorker(SqlDb *sqlDb);
 #if defined(WIN32) || defined(_WIN64)
 	static unsigned int __stdcall StartLocalWorkerS(void *data);
@@ -292,13 +324,37 @@ private:
 	// Start communication sessions with worker processes
 	int StartSessions();
 	static unsigned int __stdcall StartSessionsS(void *object);
+#else
+	int StartSessions();
+	static void* StartSessionsS(void *object);
+	// Launch worker processes connecting to the specified address
+	int StartWorkerProcesses(const char *address);
 #endif
 
 	// Start a communication with a worker process
 #if defined(WIN32) || defined(_WIN64)
 	int StartWorker(HANDLE hp);
 	static unsigned int __stdcall StartWorkerS(void *object); 
+#else
+	int StartWorker(int sock);
+	static void* StartWorkerS(void *object);
+
+	// Listen and connect to the address unix:/path, host:port or port
+	static int GetSocketAddress(const char *address, struct sockaddr_storage *addr, socklen_t *len, bool passive);
+	static int ListenSocket(const char *address);
+	static int ConnectSocket(const char *address);
+
+	// Send and receive commands and replies between the coordinator and worker processes
+	static int SendAll(int sock, const void *data, size_t len);
+	static int ReceiveAll(int sock, void *data, size_t len);
+	static int SendCommand(int sock, SqlDataCommand &cmd);
+	static int ReceiveCommand(int sock, SqlDataCommand &cmd);
+	static int SendReply(int sock, SqlDataReply &reply, bool last);
+	static int ReceiveReply(int sock, SqlDataReply &reply, bool *last);
 #endif
+
+	// Execute transfer, validation or assessment command for the table
+	void ExecuteTableTask(SqlDb *sqlDb, SqlDataReply &reply);
 	
 	// Get next table for processing
 	std::string GetNextTask();
@@ -317,6 +373,8 @@ private:
 
 	// Worker thread is terminating work
 	void NotifyWorkerExit();
+	// Wait until local worker and session threads exit
+	void JoinSessionThreads();
 
 	// Check whether data of the table already transferred
 	bool IsDataTransferred(std::string &table);
@@ -359,7 +417,52 @@ struct SqlDataPipe
 
 #if defined(WIN32) || defined(WIN64)
 	HANDLE hp;
+#else
+	int sock;
 #endif
 };
 
+// Reply sent by a worker process through a socket, SqlDataReply without pointers followed by SQL text
+struct SqlDataReplyPacket
+{
+	short _cmd;
+	short _cmd_subtype;
+	int session_id;
+	int rc;
+	int _s_rc;
+	int _t_rc;
+
+	__int64 _time_spent;
+	__int64 _s_time_spent;
+	__int64 _t_time_spent;
+
+	char _s_name[1024];
+	char _t_name[1024];
+	char t_o_name[1024];
+
+	int _int1;
+	int _int2;
+	int _int3;
+	int _s_int1;
+	int _s_int2;
+	int _t_int1;
+	int _t_int2;
+	__int64 _s_bigint1;
+	__int64 _t_bigint1;
+
+	SqlDataHistogram _stages[SQLDATA_STAGES];
+
+	int s_error;
+	int t_error;
+
+	char s_native_error_text[1024];
+	char t_native_error_text[1024];
+	char data2[1024];
+
+	// Last reply for the table, and length of source and target SQL text following the packet
+	int last;
+	int s_sql_len;
+	int t_sql_len;
+};
+
 #endif // sqldata_sqldata_h
\ No newline at end of file
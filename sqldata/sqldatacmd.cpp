@@ -18,6 +18,7 @@
 
 #if defined(WIN32) || defined(WIN64)
 #include <conio.h>
+#include <process.h>
 #else
 #include <sys/time.h>
 #include <time.h>
@@ -67,11 +68,30 @@ SqlDataCmd::SqlDataCmd()
 	_assess_table_num = 1;
 
 	_td_stdout = false;
+
+	_metrics_interval = SQLDATA_METRICS_INTERVAL;
+	_metrics_written = 0;
+	_metrics_writer_started = false;
+
+#if defined(WIN32) || defined(_WIN64)
+	InitializeCriticalSection(&_metrics_critical_section);
+	_metrics_stop_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	_metrics_writer = NULL;
+#else
+	pthread_mutex_init(&_metrics_critical_section, NULL);
+	Os::CreateEvent(&_metrics_stop_event);
+#endif
 }
 
 // Run the data transfer or validation
 int SqlDataCmd::Run()
 {
+	const char *coordinator = _parameters.Get(WORKERS_CONNECT_OPTION);
+
+	// Tables are received from the coordinator process
+	if(coordinator != NULL)
+		return RunWorker(coordinator);
+
 	_command_start = Os::GetTickCount();
 	
 	_total_tables = 0;
@@ -92,6 +112,8 @@ int SqlDataCmd::Run()
 	_failed_tables_list.clear();
 	_warnings_tables_list.clear();
 	_tables_diff_list.clear();
+	_metrics.clear();
+	_table_stages.clear();
 
 	// Read and validate parameters
 	int rc = SetParameters();
@@ -168,10 +190,21 @@ int SqlDataCmd::Run()
 
 	_log.Log("(%d %s):\n", workers, (workers == 1) ? "session" : "concurrent sessions");
 
+	// Rewrite the metrics file periodically, also when the transfer does not progress
+	StartMetricsWriter();
+
 	// Process tables or objects
 	if(rc != -1)
 		rc = _sqlData.Run();
 
+	StopMetricsWriter();
+
+	// Write final metrics
+	WriteMetrics(true);
+
+	if(_command == SQLDATA_CMD_TRANSFER)
+		PrintTimeBreakdown();
+
 	PrintCurrentTimestamp();
 
 	printf("\n");
@@ -179,6 +212,42 @@ int SqlDataCmd::Run()
 	return rc;
 }
 
+// Run as a worker process of another SQLData process
+int SqlDataCmd::RunWorker(const char *address)
+{
+	_command_start = Os::GetTickCount();
+
+	// Worker process writes its own execution log only
+	_log.Reset();
+
+	int rc = SetParameters();
+
+	if(rc == -1)
+		return rc;
+
+	PrintCurrentTimestamp();
+
+	// Connect to the databases and read the catalog to build queries and target DDL
+	rc = Connect();
+
+	if(rc != -1)
+		rc = ReadMetadata();
+
+	if(rc != -1)
+	{
+		_log.Log("\n\nProcessing tables from %s", address);
+
+		rc = _sqlData.RunWorker(address);
+
+		if(rc == -1)
+			_log.Log("\n  Failed to connect to %s", address);
+	}
+
+	PrintCurrentTimestamp();
+
+	return rc;
+}
+
 // Callback (already called from a critical section)
 void SqlDataCmd::Callback(SqlDataReply *reply)
 {
@@ -211,6 +280,18 @@ void SqlDataCmd::CallbackTransfer(SqlDataReply *reply)
 	if(reply == NULL)
 		return;
 
+	UpdateMetrics(reply);
+
+	// Save per-batch latency of transfer stages
+	if(reply->_cmd_subtype == SQLDATA_CMD_COMPLETE)
+	{
+		SqlDataTableStages &ts = _table_stages[reply->_s_name];
+
+		ts.session_id = reply->session_id;
+		ts.time = reply->_int1;
+		memcpy(ts.stages, reply->_stages, sizeof(ts.stages));
+	}
+
 	char time_fmt[21];
 
 	// Object name
@@ -1593,6 +1674,16 @@ int SqlDataCmd::SetParameters()
 		_sqlData.SetLocalWorkers(_local_workers);
 	}
 
+	// Get -metrics option
+	value = _parameters.Get(METRICS_OPTION);
+
+	if(value != NULL)
+		_metrics_file = value;
+	else
+		_metrics_file.clear();
+
+	_metrics_interval = _parameters.GetInt(METRICS_INTERVAL_OPTION, SQLDATA_METRICS_INTERVAL);
+
 	// Some mandatory parameters must be set, and if not print how to use and exist
 	if(_sd.empty() || _td.empty() || _parameters.Get(HELP_PARAMETER) || (_t.empty() && _tf.empty() && _qf.empty()))
 	{
@@ -1702,6 +1793,485 @@ void SqlDataCmd::LogSql(SqlDataReply *reply, const char *time_str)
 	}
 }
 
+// Update live transfer metrics for the table
+void SqlDataCmd::UpdateMetrics(SqlDataReply *reply)
+{
+	if(reply == NULL || _metrics_file.empty())
+		return;
+
+	if(reply->_cmd_subtype != SQLDATA_CMD_STARTED && reply->_cmd_subtype != SQLDATA_CMD_IN_PROGRESS && 
+		reply->_cmd_subtype != SQLDATA_CMD_COMPLETE)
+		return;
+
+	Os::EnterCriticalSection(&_metrics_critical_section);
+
+	if(reply->_cmd_subtype == SQLDATA_CMD_STARTED)
+	{
+		SqlDataTableMetrics &m = _metrics[reply->_s_name];
+		m.session_id = reply->session_id;
+	}
+	else
+	{
+		SqlDataTableMetrics &m = _metrics[reply->_s_name];
+
+		m.session_id = reply->session_id;
+		m.complete = (reply->_cmd_subtype == SQLDATA_CMD_COMPLETE);
+		m.time = reply->_int1;
+		m.time_read = reply->_s_int2;
+		m.time_write = reply->_t_int2;
+		m.rows_read = reply->_s_int1;
+		m.rows_written = reply->_t_int1;
+		m.bytes_written = reply->_t_bigint1;
+	}
+
+	Os::LeaveCriticalSection(&_metrics_critical_section);
+
+	// Without the writer thread, the file is rewritten on transfer progress
+	if(!_metrics_writer_started)
+		WriteMetrics(false);
+}
+
+// Write live transfer metrics in Prometheus text format
+void SqlDataCmd::WriteMetrics(bool force)
+{
+	if(_metrics_file.empty())
+		return;
+
+	size_t now = Os::GetTickCount();
+
+	// Rewrite the file not more often than the specified interval
+	if(!force && _metrics_written != 0 && now - _metrics_written < (size_t)_metrics_interval * 1000)
+		return;
+
+	_metrics_written = now;
+
+	int tables = 0, tables_in_progress = 0, meta = 0, meta_in_progress = 0;
+	_sqlData.GetQueueDepths(&tables, &tables_in_progress, &meta, &meta_in_progress);
+
+	// Take a copy, so callbacks are not blocked while the file is written
+	Os::EnterCriticalSection(&_metrics_critical_section);
+	std::map<std::string, SqlDataTableMetrics> metrics_copy = _metrics;
+	Os::LeaveCriticalSection(&_metrics_critical_section);
+
+	std::map<int, SqlDataTableMetrics> sessions;
+	std::map<std::string, std::string> labels;
+
+	size_t time_read = 0, time_write = 0;
+	size_t all_time_read = 0, all_time_write = 0;
+
+	for(std::map<std::string, SqlDataTableMetrics>::iterator i = metrics_copy.begin(); i != metrics_copy.end(); i++)
+	{
+		SqlDataTableMetrics &m = i->second;
+		SqlDataTableMetrics &s = sessions[m.session_id];
+
+		s.session_id = m.session_id;
+		s.time += m.time;
+		s.time_read += m.time_read;
+		s.time_write += m.time_write;
+		s.rows_read += m.rows_read;
+		s.rows_written += m.rows_written;
+		s.bytes_written += m.bytes_written;
+
+		// Current bottleneck is defined by tables in progress
+		if(!m.complete)
+		{
+			time_read += m.time_read;
+			time_write += m.time_write;
+		}
+
+		all_time_read += m.time_read;
+		all_time_write += m.time_write;
+
+		// Escape the table name for label value
+		std::string label = "table=\"";
+
+		for(const char *c = i->first.c_str(); *c; c++)
+		{
+			if(*c == '"' || *c == '\\')
+				label += '\\';
+
+			label += *c;
+		}
+
+		char session[21];
+		sprintf(session, "%d", m.session_id);
+
+		label += "\",session=\"";
+		label += session;
+		label += "\"";
+
+		labels[i->first] = label;
+	}
+
+	if(time_read == 0 && time_write == 0)
+	{
+		time_read = all_time_read;
+		time_write = all_time_write;
+	}
+
+	const char *metrics[][2] = {
+		{ "rows_read", "Rows read from the source" },
+		{ "rows_written", "Rows written to the target" },
+		{ "bytes_written", "Bytes written to the target" },
+		{ "read_time_seconds", "Time spent reading from the source" },
+		{ "write_time_seconds", "Time spent writing to the target" },
+		{ "rows_per_second", "Rows written per second of transfer time" },
+		{ "bytes_per_second", "Bytes written per second of transfer time" }
+	};
+
+	int metrics_count = sizeof(metrics)/sizeof(metrics[0]);
+
+	std::string out;
+	char line[256];
+
+	for(int k = 0; k < 2; k++)
+	{
+		const char *scope = (k == 0) ? "table" : "session";
+
+		for(int j = 0; j < metrics_count; j++)
+		{
+			sprintf(line, "# HELP sqldata_%s_%s %s\n# TYPE sqldata_%s_%s gauge\n", scope, metrics[j][0], metrics[j][1], scope, metrics[j][0]);
+			out += line;
+
+			if(k == 0)
+			{
+				for(std::map<std::string, SqlDataTableMetrics>::iterator i = metrics_copy.begin(); i != metrics_copy.end(); i++)
+				{
+					sprintf(line, "sqldata_table_%s{", metrics[j][0]);
+					out += line;
+					out += labels[i->first];
+
+					sprintf(line, "} %.3f\n", GetMetricValue(i->second, j));
+					out += line;
+				}
+			}
+			else
+			{
+				for(std::map<int, SqlDataTableMetrics>::iterator i = sessions.begin(); i != sessions.end(); i++)
+				{
+					sprintf(line, "sqldata_session_%s{session=\"%d\"} %.3f\n", metrics[j][0], i->first, GetMetricValue(i->second, j));
+					out += line;
+				}
+			}
+		}
+	}
+
+	sprintf(line, "# HELP sqldata_tables_pending Tables waiting for transfer\n# TYPE sqldata_tables_pending gauge\nsqldata_tables_pending %d\n", tables);
+	out += line;
+
+	sprintf(line, "# HELP sqldata_tables_in_progress Tables being transferred\n# TYPE sqldata_tables_in_progress gauge\nsqldata_tables_in_progress %d\n", tables_in_progress);
+	out += line;
+
+	sprintf(line, "# HELP sqldata_meta_tasks_pending Metadata tasks waiting for execution\n# TYPE sqldata_meta_tasks_pending gauge\nsqldata_meta_tasks_pending %d\n", meta);
+	out += line;
+
+	sprintf(line, "# HELP sqldata_meta_tasks_in_progress Metadata tasks being executed\n# TYPE sqldata_meta_tasks_in_progress gauge\nsqldata_meta_tasks_in_progress %d\n", meta_in_progress);
+	out += line;
+
+	// Side that takes more time for tables in progress
+	sprintf(line, "# HELP sqldata_bottleneck Side that currently takes more time\n# TYPE sqldata_bottleneck gauge\n"
+		"sqldata_bottleneck{side=\"source\"} %d\nsqldata_bottleneck{side=\"target\"} %d\n", 
+		(time_read > time_write) ? 1 : 0, (time_write > 0 && time_write >= time_read) ? 1 : 0);
+	out += line;
+
+	sprintf(line, "# HELP sqldata_elapsed_seconds Time since the command start\n# TYPE sqldata_elapsed_seconds gauge\nsqldata_elapsed_seconds %.3f\n", 
+		((double)(now - _command_start))/1000.0);
+	out += line;
+
+	double cpu_seconds = 0;
+	size_t peak_rss = 0;
+
+	// Resource usage of this process (workers started as separate processes report their own)
+	if(Os::GetProcessUsage(&cpu_seconds, &peak_rss) == 0)
+	{
+		sprintf(line, "# HELP sqldata_process_cpu_seconds User and system CPU time\n# TYPE sqldata_process_cpu_seconds gauge\nsqldata_process_cpu_seconds %.3f\n", 
+			cpu_seconds);
+		out += line;
+
+		sprintf(line, "# HELP sqldata_process_peak_rss_bytes Peak resident memory\n# TYPE sqldata_process_peak_rss_bytes gauge\nsqldata_process_peak_rss_bytes %.0f\n", 
+			(double)peak_rss);
+		out += line;
+	}
+
+	// Write to a temporary file and rename it, so readers never see a partially written file
+	std::string tmp = _metrics_file;
+	tmp += ".tmp";
+
+	File::Truncate(tmp.c_str());
+
+	if(File::Write(tmp.c_str(), out.c_str(), out.length()) == -1)
+		return;
+
+#if defined(WIN32) || defined(_WIN64)
+	remove(_metrics_file.c_str());
+#endif
+	rename(tmp.c_str(), _metrics_file.c_str());
+}
+
+// Start the thread rewriting the metrics file every interval
+void SqlDataCmd::StartMetricsWriter()
+{
+	if(_metrics_file.empty() || _metrics_interval <= 0)
+		return;
+
+#if defined(WIN32) || defined(_WIN64)
+	_metrics_writer = (HANDLE)_beginthreadex(NULL, 0, &SqlDataCmd::MetricsWriterS, this, 0, NULL);
+	_metrics_writer_started = (_metrics_writer != NULL);
+#else
+	_metrics_writer_started = (pthread_create(&_metrics_writer, NULL, &SqlDataCmd::MetricsWriterS, this) == 0);
+#endif
+}
+
+// Stop the metrics writer thread and wait until it exits
+void SqlDataCmd::StopMetricsWriter()
+{
+	if(!_metrics_writer_started)
+		return;
+
+#if defined(WIN32) || defined(_WIN64)
+	SetEvent(_metrics_stop_event);
+	WaitForSingleObject(_metrics_writer, INFINITE);
+	CloseHandle(_metrics_writer);
+#else
+	Os::SetEvent(&_metrics_stop_event);
+	pthread_join(_metrics_writer, NULL);
+#endif
+
+	_metrics_writer_started = false;
+}
+
+// Metrics writer thread
+#if defined(WIN32) || defined(_WIN64)
+unsigned int __stdcall SqlDataCmd::MetricsWriterS(void *object)
+#else
+void* SqlDataCmd::MetricsWriterS(void *object)
+#endif
+{
+	SqlDataCmd *cmd = (SqlDataCmd*)object;
+
+	size_t interval = (size_t)cmd->_metrics_interval * 1000;
+
+	while(true)
+	{
+		// The stop event is set when the command completes, otherwise wait times out at the interval
+#if defined(WIN32) || defined(_WIN64)
+		bool stop = (WaitForSingleObject(cmd->_metrics_stop_event, (DWORD)interval) == WAIT_OBJECT_0);
+#else
+		bool stop = Os::WaitForEvent(&cmd->_metrics_stop_event, interval);
+#endif
+		if(stop)
+			break;
+
+		cmd->WriteMetrics(true);
+	}
+
+#if defined(WIN32) || defined(_WIN64)
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+// Output where the transfer time went and suggested settings
+void SqlDataCmd::PrintTimeBreakdown()
+{
+	if(_table_stages.empty())
+		return;
+
+	const char *names[SQLDATA_STAGES] = { "Fetch", "Encode", "Send", "Commit" };
+
+	SqlDataHistogram all[SQLDATA_STAGES];
+	std::map<int, SqlDataTableStages> sessions;
+
+	for(int i = 0; i < SQLDATA_STAGES; i++)
+		all[i].Reset();
+
+	for(std::map<std::string, SqlDataTableStages>::iterator i = _table_stages.begin(); i != _table_stages.end(); i++)
+	{
+		std::map<int, SqlDataTableStages>::iterator s = sessions.find(i->second.session_id);
+
+		if(s == sessions.end())
+		{
+			SqlDataTableStages ss;
+			ss.session_id = i->second.session_id;
+			ss.time = 0;
+
+			for(int k = 0; k < SQLDATA_STAGES; k++)
+				ss.stages[k].Reset();
+
+			s = sessions.insert(std::pair<int, SqlDataTableStages>(ss.session_id, ss)).first;
+		}
+
+		s->second.time += i->second.time;
+
+		for(int k = 0; k < SQLDATA_STAGES; k++)
+		{
+			all[k].Merge(i->second.stages[k]);
+			s->second.stages[k].Merge(i->second.stages[k]);
+		}
+	}
+
+	__int64 total = 0;
+
+	for(int k = 0; k < SQLDATA_STAGES; k++)
+		total += all[k].sum;
+
+	char time_fmt[21];
+
+	_log.Log("\n\nWhere the time went (per-batch latency):\n");
+	_log.Log("\n  Stage       Batches        Time      %%    Avg ms    p50 ms    p95 ms    Max ms");
+
+	for(int k = 0; k < SQLDATA_STAGES; k++)
+	{
+		Str::FormatTime((size_t)all[k].sum, time_fmt);
+
+		_log.Log("\n  %-8s %10d %11s %5.1lf%% %9.1lf %9d %9d %9d", names[k], all[k].count, time_fmt, 
+			(total != 0) ? ((double)all[k].sum)/((double)total)*100.0 : 0.0,
+			(all[k].count != 0) ? ((double)all[k].sum)/((double)all[k].count) : 0.0,
+			GetPercentile(all[k], 50), GetPercentile(all[k], 95), all[k].max);
+	}
+
+	_log.Log("\n\n  Session     Tables      Time     Fetch    Encode      Send    Commit");
+
+	int min_time = -1, max_time = 0;
+
+	for(std::map<int, SqlDataTableStages>::iterator s = sessions.begin(); s != sessions.end(); s++)
+	{
+		int tables = 0;
+
+		for(std::map<std::string, SqlDataTableStages>::iterator i = _table_stages.begin(); i != _table_stages.end(); i++)
+			if(i->second.session_id == s->first)
+				tables++;
+
+		Str::FormatTime((size_t)s->second.time, time_fmt);
+		_log.Log("\n  %7d %10d %9s", s->first, tables, time_fmt);
+
+		for(int k = 0; k < SQLDATA_STAGES; k++)
+		{
+			Str::FormatTime((size_t)s->second.stages[k].sum, time_fmt);
+			_log.Log(" %9s", time_fmt);
+		}
+
+		if(min_time == -1 || s->second.time < min_time)
+			min_time = s->second.time;
+
+		if(s->second.time > max_time)
+			max_time = s->second.time;
+	}
+
+	// Output the slowest tables with the stage that took most time
+	std::list<std::pair<int, std::string> > slowest;
+
+	for(std::map<std::string, SqlDataTableStages>::iterator i = _table_stages.begin(); i != _table_stages.end(); i++)
+		slowest.push_back(std::pair<int, std::string>(i->second.time, i->first));
+
+	slowest.sort();
+	slowest.reverse();
+
+	_log.Log("\n\n  Slowest tables:\n");
+
+	int n = 1;
+
+	for(std::list<std::pair<int, std::string> >::iterator i = slowest.begin(); i != slowest.end() && n <= SQLDATA_SLOWEST_TABLES; i++, n++)
+	{
+		SqlDataTableStages &ts = _table_stages[i->second];
+
+		int stage = 0;
+
+		for(int k = 1; k < SQLDATA_STAGES; k++)
+			if(ts.stages[k].sum > ts.stages[stage].sum)
+				stage = k;
+
+		Str::FormatTime((size_t)ts.time, time_fmt);
+
+		_log.Log("\n  %5d. %s (%s, %s %.0lf%%, session %d)", n, i->second.c_str(), time_fmt, names[stage], 
+			(ts.time != 0) ? ((double)ts.stages[stage].sum)/((double)ts.time)*100.0 : 0.0, ts.session_id);
+	}
+
+	// Suggested settings
+	_log.Log("\n\n  Suggestions:\n");
+
+	int dominant = 0;
+
+	for(int k = 1; k < SQLDATA_STAGES; k++)
+		if(all[k].sum > all[dominant].sum)
+			dominant = k;
+
+	if(total == 0)
+		_log.Log("\n    Transfer was too fast to measure");
+	else
+	if(dominant == SQLDATA_STAGE_FETCH)
+		_log.Log("\n    Source fetch is the bottleneck, increase -ss if the source database has spare capacity");
+	else
+	if(dominant == SQLDATA_STAGE_ENCODE)
+		_log.Log("\n    Data conversion is the bottleneck, increase -ss to use more CPU cores");
+	else
+	if(dominant == SQLDATA_STAGE_SEND)
+		_log.Log("\n    Writing to the target is the bottleneck, increasing -ss helps only if the target database has spare capacity");
+	else
+		_log.Log("\n    Completing the bulk load is the bottleneck, consider creating indexes and constraints after the data transfer");
+
+	// Many small batches: per-batch overhead dominates
+	if(all[SQLDATA_STAGE_FETCH].count > SQLDATA_SMALL_BATCHES_MIN && GetPercentile(all[SQLDATA_STAGE_FETCH], 50) <= 1 && 
+		GetPercentile(all[SQLDATA_STAGE_SEND], 50) <= 1)
+		_log.Log("\n    Most batches take less than 1 ms, increase -batch_max_rows to reduce the per-batch overhead");
+
+	// Slow batches hold the buffer for a long time
+	if(GetPercentile(all[SQLDATA_STAGE_FETCH], 95) > SQLDATA_SLOW_BATCH_MS || GetPercentile(all[SQLDATA_STAGE_SEND], 95) > SQLDATA_SLOW_BATCH_MS)
+		_log.Log("\n    Some batches take more than %d ms, decrease -batch_max_rows to overlap reading and writing better", SQLDATA_SLOW_BATCH_MS);
+
+	// One session works much longer than others
+	if(sessions.size() > 1 && min_time >= 0 && max_time > min_time * 2)
+		_log.Log("\n    Session load is unbalanced, the slowest table limits the total time, more sessions will not help");
+	else
+	if((int)sessions.size() < _concurrent_sessions)
+		_log.Log("\n    Only %d session%s did the work, -ss greater than the number of tables does not help", (int)sessions.size(), 
+			SUFFIX((int)sessions.size()));
+
+	_log.Log("\n");
+}
+
+// Get the upper bound of the histogram bucket containing the percentile (in milliseconds)
+int SqlDataCmd::GetPercentile(SqlDataHistogram &h, int percent)
+{
+	if(h.count == 0)
+		return 0;
+
+	__int64 rank = ((__int64)h.count * percent + 99)/100;
+	__int64 cur = 0;
+
+	for(int i = 0; i < SQLDATA_HIST_BUCKETS; i++)
+	{
+		cur += h.buckets[i];
+
+		if(cur >= rank)
+		{
+			int bound = (i == 0) ? 1 : (1 << i);
+
+			return (bound < h.max) ? bound : h.max;
+		}
+	}
+
+	return h.max;
+}
+
+// Get metric value by its index in metrics list
+double SqlDataCmd::GetMetricValue(SqlDataTableMetrics &m, int metric)
+{
+	switch(metric)
+	{
+		case 0: return (double)m.rows_read;
+		case 1: return (double)m.rows_written;
+		case 2: return (double)m.bytes_written;
+		case 3: return ((double)m.time_read)/1000.0;
+		case 4: return ((double)m.time_write)/1000.0;
+		case 5: return (m.time != 0) ? ((double)m.rows_written)/((double)m.time)*1000.0 : 0;
+		case 6: return (m.time != 0) ? ((double)m.bytes_written)/((double)m.time)*1000.0 : 0;
+	}
+
+	return 0;
+}
+
 // Save information about failed table
 void SqlDataCmd::AddFailedTable(SqlDataReply *reply, const char *error)
 {
@@ -1859,6 +2429,8 @@ void SqlDataCmd::PrintHowToUse()
 	printf("\n   -qf       - Query file");
 	printf("\n   -out      - Output directory (the current directory by default)");
 	printf("\n   -log      - Log file (sqldata.log by default)");
+	printf("\n   -source_compress=yes - Compress the source connection protocol (MySQL/MariaDB)");
+	printf("\n   -target_compress=yes - Compress the target connection protocol (MySQL/MariaDB)");
 	printf("\n   -?        - Print how to use");
 
 	printf("\n\nExample:");
@@ -49,6 +49,10 @@
 #define SS_OPTION					"-ss"		// Number of concurrent sessions option
 #define WORKERS_OPTION				"-wrk"		// Number of separate worker processes (undocumented)
 #define LOCAL_WORKERS_OPTION		"-lwrk"		// Number of worker threads (undocumented)
+#define WORKERS_LISTEN_OPTION		"-wrk_listen"	// Address to accept worker processes: unix:/path, host:port or port (undocumented)
+#define WORKERS_CONNECT_OPTION		"-wrk_connect"	// Run as a worker process of the coordinator at the address (undocumented)
+#define METRICS_OPTION				"-metrics"	// File with live transfer metrics in Prometheus text format
+#define METRICS_INTERVAL_OPTION		"-metrics_interval"	// How often the metrics file is rewritten, in seconds
 
 #define SUFFIX(int_value)				((int_value == 1) ? "" : "s")
 #define SUFFIX2(int_value, str1, str2)	((int_value == 1) ? str1 : str2)
@@ -67,11 +71,50 @@
 #define SQLDATA_TRACEFILE				"sqldata.trc"
 #define SQLDATA_CONFIGFILE				"sqldata.cfg"
 
+// Default rewrite interval for metrics file, in seconds
+#define SQLDATA_METRICS_INTERVAL		5
+
+// Time breakdown report: number of slowest tables, batch latency considered slow, minimum batches to detect small ones
+#define SQLDATA_SLOWEST_TABLES			10
+#define SQLDATA_SLOW_BATCH_MS			1000
+#define SQLDATA_SMALL_BATCHES_MIN		1000
+
 // SQL statement logs
 #define SQLDATA_DDL_LOGFILE				"sqldata_ddl.sql"
 #define SQLDATA_FAILED_DDL_LOGFILE		"sqldata_failed.sql"
 #define SQLDATA_FAILED_TABLES_LOGFILE	"sqldata_failed_tables.txt"
 
+// Live transfer metrics for a table (values are accumulated from the start of table transfer)
+struct SqlDataTableMetrics
+{
+	int session_id;
+	bool complete;
+
+	// Transfer, read and write time in milliseconds
+	int time;
+	int time_read;
+	int time_write;
+
+	int rows_read;
+	int rows_written;
+	__int64 bytes_written;
+
+	SqlDataTableMetrics()
+	{
+		session_id = 0; complete = false;
+		time = 0; time_read = 0; time_write = 0;
+		rows_read = 0; rows_written = 0; bytes_written = 0;
+	}
+};
+
+// Per-batch latency of transfer stages for a table
+struct SqlDataTableStages
+{
+	int session_id;
+	int time;
+	SqlDataHistogram stages[SQLDATA_STAGES];
+};
+
 class SqlDataCmd
 {
 	// Options
@@ -166,6 +209,28 @@ class SqlDataCmd
 	// List of tables with different row count (includes table name and row count information)
 	std::list<std::string> _tables_diff_list;
 
+	// Live metrics file, its rewrite interval in seconds and the last write time
+	std::string _metrics_file;
+	int _metrics_interval;
+	size_t _metrics_written;
+	// Metrics for started tables
+	std::map<std::string, SqlDataTableMetrics> _metrics;
+
+	// Writer thread rewrites the metrics file every interval, also when no transfer progress is reported
+	bool _metrics_writer_started;
+#if defined(WIN32) || defined(_WIN64)
+	CRITICAL_SECTION _metrics_critical_section;
+	HANDLE _metrics_stop_event;
+	HANDLE _metrics_writer;
+#else
+	pthread_mutex_t _metrics_critical_section;
+	Event _metrics_stop_event;
+	pthread_t _metrics_writer;
+#endif
+
+	// Per-batch latency of transfer stages for completed tables
+	std::map<std::string, SqlDataTableStages> _table_stages;
+
 	// Current executable file
 	const char *_exe;
 
@@ -185,6 +250,8 @@ public:
 
 	// Run the operations
 	int Run();	
+	// Run as a worker process of another SQLData process
+	int RunWorker(const char *address);
 
 	// Test a connection to the database
 	int TestConnection(std::string &conn, std::string &error, std::string &loaded_path, std::list<std::string> &search_paths, size_t *time_spent);
@@ -244,6 +311,24 @@ private:
 	void CallbackValidationRows(SqlDataReply *reply);
 	void CallbackAssess(SqlDataReply *reply);
 
+	// Update and periodically write live transfer metrics
+	void UpdateMetrics(SqlDataReply *reply);
+	void WriteMetrics(bool force);
+	static double GetMetricValue(SqlDataTableMetrics &m, int metric);
+
+	// Start and stop the metrics writer thread
+	void StartMetricsWriter();
+	void StopMetricsWriter();
+#if defined(WIN32) || defined(_WIN64)
+	static unsigned int __stdcall MetricsWriterS(void *object);
+#else
+	static void* MetricsWriterS(void *object);
+#endif
+
+	// Output where the transfer time went and suggested settings
+	void PrintTimeBreakdown();
+	static int GetPercentile(SqlDataHistogram &h, int percent);
+
 	void AddFailedTable(SqlDataReply *reply, const char *error);
 	void AddWarningsTable(SqlDataReply *reply, const char *error);
 };
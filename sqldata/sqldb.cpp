@@ -62,6 +62,7 @@ SqlDb::SqlDb()
 	_session_id = 0;
 
 	_trace_diff_data = false;
+	_adaptive_batch = true;
 	_validation_not_equal_max_rows = -1;
 	_validation_datetime_fraction = -1;
 	_mysql_validation_collate = NULL;
@@ -97,6 +98,16 @@ int SqlDb::Init(int db_types, const char *source_conn, const char *target_conn,
 	if(t_rc == 0 && db_types != SQLDB_SOURCE_ONLY)
 		t_db_api = CreateDatabaseApi(target_conn, &target_type);
 	
+	// Enable the driver protocol compression for remote databases (ignored if the driver does not support it)
+	if(_parameters != NULL)
+	{
+		if(s_db_api != NULL && _parameters->GetTrue("-source_compress") != NULL)
+			s_db_api->SetCompress(true);
+
+		if(t_db_api != NULL && _parameters->GetTrue("-target_compress") != NULL)
+			t_db_api->SetCompress(true);
+	}
+
 	// Initialize the source database API (do not exit in case of error, allow initializing the target API)
 	if(s_db_api != NULL)
 	{
@@ -702,6 +713,24 @@ std::list<SqlConsColumns>* SqlDb::GetConstraintColumns(int /*db_type*/)
 	return _source_ca.db_api->GetConstraintColumns();
 }
 
+// Get indexed catalog objects of the table
+SqlTableCatalog* SqlDb::GetTableCatalog(int /*db_type*/, const char *schema, const char *table)
+{
+	if(_source_ca.db_api == NULL)
+		return NULL;
+
+	return _source_ca.db_api->GetCatalogTable(schema, table);
+}
+
+// Get columns of the constraint by schema and constraint name
+std::vector<SqlConsColumns*>* SqlDb::GetConstraintColumns(int /*db_type*/, const char *schema, const char *constraint)
+{
+	if(_source_ca.db_api == NULL)
+		return NULL;
+
+	return _source_ca.db_api->GetCatalogConstraintColumns(schema, constraint);
+}
+
 std::list<SqlComments>* SqlDb::GetTableComments(int /*db_type*/)
 {
 	if(_source_ca.db_api == NULL)
@@ -767,6 +796,9 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 
 	size_t start = GetTickCount(), now = start, prev_update = start;
 
+	for(int i = 0; i < SQLDATA_STAGES; i++)
+		reply._stages[i].Reset();
+
 	std::string select, t_select;
 
 	// SELECT query
@@ -788,7 +820,7 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 	size_t time_read = 0, all_time_read = 0;
 	size_t time_write = 0, all_time_write = 0;
 	
-	SqlCol *s_cols = NULL, *s_cols_copy = NULL, *cur_cols = NULL, *t_cols = NULL;
+	SqlCol *s_cols = NULL, *s_cols_copy = NULL, *cur_cols = NULL, *t_cols = NULL, *fetch_cols = NULL;
 
 	bool no_more_data = false;
 	size_t buffer_rows = 0;
@@ -805,6 +837,8 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 	{
 		all_rows_read += rows_fetched;
 		all_time_read += time_read;
+
+		reply._stages[SQLDATA_STAGE_FETCH].Add(time_read);
 	}
 
 	// Notify on opening cursor
@@ -841,12 +875,34 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 		no_more_data = true;
 
 	cur_cols = s_cols;
+	fetch_cols = s_cols;
+
+	// Start from the allocated buffer, and shrink or grow the fetch size while the throughput improves
+	SqlDbBatchControl batch;
+	batch.enabled = (data && _adaptive_batch && no_more_data == false);
+	batch.rows = allocated_array_rows;
+	batch.min_rows = (allocated_array_rows < SQLDB_BATCH_MIN_ROWS) ? allocated_array_rows : SQLDB_BATCH_MIN_ROWS;
+	batch.max_rows = allocated_array_rows;
+	batch.direction = -1;
+	batch.prev_rate = 0;
+	batch.window_rows = 0;
+	batch.window_time = 0;
+
+	// Source and target exchange buffers instead of copying data
+	bool exchange_buffers = false;
 
 	// Allocate a copy of column buffer if data were not fetched in one iteration
 	if(no_more_data == false && parallel_read_write == true)
 	{
 		CopyColumns(s_cols, &s_cols_copy, col_count, allocated_array_rows);
-		cur_cols = s_cols_copy;
+
+		// Source fetches into one buffer while the target writes another, if the target binds the source buffers
+		// it must be able to rebind them
+		if(_source_ca.db_api->IsBufferExchangeSupported() && 
+			(data_bound == false || _target_ca.db_api->IsBufferExchangeSupported()))
+			exchange_buffers = true;
+		else
+			cur_cols = s_cols_copy;
 	}
 
 	bool ddl_error = false;
@@ -894,6 +950,18 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 			// Sybase CT-lib and ODBC return NO DATA after all rows fetched so check for number of rows
 			if(rows_fetched != 0)
 			{
+				// Write the buffer the last rows were fetched into
+				if(exchange_buffers == true)
+				{
+					cur_cols = fetch_cols;
+
+					if(data_bound == true)
+						rc = _target_ca.db_api->SetTransferBuffers(cur_cols);
+
+					if(rc == -1)
+						break;
+				}
+				else
 				// Copy buffer if it is non-single fetch and source data buffer is bound
 				if(s_cols_copy != NULL && data_bound == true)
 					CopyColumnData(s_cols, s_cols_copy, col_count, rows_fetched);
@@ -910,6 +978,8 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 					all_rows_written += rows_written;
 					all_bytes_written += bytes_written;
 					all_time_write += time_write;
+
+					AddWriteStages(reply, time_write);
 				}
 			}
 
@@ -932,9 +1002,26 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 		// Use concurrent threads
 		else
 		{
+			// Pass the fetched buffer to the target, and fetch the next rows into another buffer
+			if(exchange_buffers == true)
+			{
+				cur_cols = fetch_cols;
+				fetch_cols = (fetch_cols == s_cols) ? s_cols_copy : s_cols;
+
+				rc = _source_ca.db_api->SetFetchBuffers(fetch_cols);
+
+				if(rc != -1 && data_bound == true)
+					rc = _target_ca.db_api->SetTransferBuffers(cur_cols);
+
+				if(rc == -1)
+					break;
+			}
 			// Copy data
-			CopyColumnData(s_cols, s_cols_copy, col_count, rows_fetched);
-			cur_cols = s_cols_copy;
+			else
+			{
+				CopyColumnData(s_cols, s_cols_copy, col_count, rows_fetched);
+				cur_cols = s_cols_copy;
+			}
 
 			// Prepare insert command
 			_target_ca._int2 = rows_fetched; 
@@ -959,6 +1046,9 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 		all_bytes_written += bytes_written;
 		all_time_write += time_write;
 
+		reply._stages[SQLDATA_STAGE_FETCH].Add(time_read);
+		AddWriteStages(reply, time_write);
+
 		now = GetTickCount();
 
 		// Notify on transfer in progress every callback_rate milliseconds
@@ -979,15 +1069,21 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 		}
 
 		// it was the last fetch
-		if(rc == 100 || rows_fetched < allocated_array_rows)
+		if(rc == 100 || rows_fetched < batch.rows)
 			no_more_data = true;
+		else
+			AdaptBatchRows(batch, rows_fetched, time_read, time_write, parallel_read_write);
 	}
 
 	// Complete transfer
 	if(bulk_init == true)
 	{
+		size_t close_start = GetTickCount();
+
 		int close_rc = _target_ca.db_api->CloseBulkTransfer();
 
+		reply._stages[SQLDATA_STAGE_COMMIT].Add(GetTickCount() - close_start);
+
 		if(close_rc == -1)
 		{
 			rc = -1;
@@ -1044,6 +1140,87 @@ int SqlDb::TransferRows(SqlDataReply &reply, int options, bool create_tables, bo
 	return (rc == 100) ? 0 : rc;
 }
 
+// Change the number of rows for the next fetch depending on the measured throughput
+void SqlDb::AdaptBatchRows(SqlDbBatchControl &batch, int rows, size_t time_read, size_t time_write, bool parallel)
+{
+	if(!batch.enabled)
+		return;
+
+	// Reading and writing overlap in parallel mode
+	size_t time = parallel ? ((time_read > time_write) ? time_read : time_write) : time_read + time_write;
+
+	batch.window_rows += (size_t)rows;
+	batch.window_time += time;
+
+	size_t next = batch.rows;
+
+	// Batch takes too long, shrink without waiting for the end of the window
+	if(time > SQLDB_BATCH_MAX_LATENCY_MS && batch.rows > batch.min_rows)
+	{
+		batch.direction = -1;
+		batch.prev_rate = 0;
+		next = batch.rows/2;
+	}
+	else
+	{
+		if(batch.window_time < SQLDB_BATCH_WINDOW_MS)
+			return;
+
+		double rate = ((double)batch.window_rows)/((double)batch.window_time)*1000.0;
+		bool change = true;
+
+		if(batch.prev_rate > 0)
+		{
+			// Throughput dropped, go back
+			if(rate < batch.prev_rate * (100 - SQLDB_BATCH_RATE_CHANGE)/100)
+				batch.direction = -batch.direction;
+			else
+			// No significant change, keep the current size
+			if(rate <= batch.prev_rate * (100 + SQLDB_BATCH_RATE_CHANGE)/100)
+				change = false;
+		}
+
+		batch.prev_rate = rate;
+
+		if(change)
+			next = (batch.direction > 0) ? batch.rows * 2 : batch.rows/2;
+	}
+
+	batch.window_rows = 0;
+	batch.window_time = 0;
+
+	if(next < batch.min_rows)
+		next = batch.min_rows;
+	else
+	if(next > batch.max_rows)
+		next = batch.max_rows;
+
+	if(next == batch.rows)
+		return;
+
+	// Source API cannot change the fetch size
+	if(_source_ca.db_api->SetFetchRows(next) == -1)
+	{
+		batch.enabled = false;
+		return;
+	}
+
+	batch.rows = next;
+}
+
+// Split the batch write time into conversion and send stages
+void SqlDb::AddWriteStages(SqlDataReply &reply, size_t time_write)
+{
+	int send = _target_ca.db_api->GetTransferSendTime();
+
+	// API does not measure send time separately
+	if(send < 0 || (size_t)send > time_write)
+		send = (int)time_write;
+
+	reply._stages[SQLDATA_STAGE_ENCODE].Add(time_write - send);
+	reply._stages[SQLDATA_STAGE_SEND].Add((size_t)send);
+}
+
 // Assess table rows
 int SqlDb::AssessRows(SqlDataReply &reply)
 {
@@ -2279,26 +2456,26 @@ int SqlDb::GetInlineIdentityClause(const char *s_table, char *column, std::strin
 	if(target_type != SQLDATA_SQL_SERVER && target_type != SQLDATA_MYSQL)
 		return 0;
 
-	std::list<SqlColMeta> *table_columns = _metaSqlDb->GetTableColumns(SQLDB_SOURCE_ONLY);
-
-	if(table_columns == NULL)
-		return 0;
-
 	std::string schema;
 	std::string table;
 
 	SqlApiBase::SplitQualifiedName(s_table, schema, table);
 
+	SqlTableCatalog *catalog = _metaSqlDb->GetTableCatalog(SQLDB_SOURCE_ONLY, schema.c_str(), table.c_str());
+
+	if(catalog == NULL)
+		return 0;
+
 	// Find mapping record for this table and column
-	for(std::list<SqlColMeta>::iterator i = table_columns->begin(); i != table_columns->end(); i++)
+	for(std::vector<SqlColMeta*>::iterator i = catalog->columns.begin(); i != catalog->columns.end(); i++)
 	{
 		// Not an identity column
-		if((*i).identity == false)
+		if((*i)->identity == false)
 			continue;
 
-		char *col = (*i).column;
-		char *tab = (*i).table;
-		char *sch = (*i).schema;
+		char *col = (*i)->column;
+		char *tab = (*i)->table;
+		char *sch = (*i)->schema;
 
 		if(col == NULL || tab == NULL || sch == NULL)
 			continue;
@@ -2311,9 +2488,9 @@ int SqlDb::GetInlineIdentityClause(const char *s_table, char *column, std::strin
 			if(target_type == SQLDATA_SQL_SERVER)
 			{
 				identity_clause += "IDENTITY(";
-				identity_clause += Str::IntToString((*i).id_next, int1);
+				identity_clause += Str::IntToString((*i)->id_next, int1);
 				identity_clause += ",";
-				identity_clause += Str::IntToString((*i).id_inc, int1);
+				identity_clause += Str::IntToString((*i)->id_inc, int1);
 				identity_clause += ")";
 			}
 			else
@@ -2334,33 +2511,33 @@ bool SqlDb::IsPrimaryKeyColumn(const char *s_table, const char *column)
     if(s_table == NULL || column == NULL)
         return false;
 
-	std::list<SqlColMeta> *table_columns = _metaSqlDb->GetTableColumns(SQLDB_SOURCE_ONLY);
-
-	if(table_columns == NULL)
-		return 0;
-
 	std::string schema;
 	std::string table;
 
 	SqlApiBase::SplitQualifiedName(s_table, schema, table);
 
+	SqlTableCatalog *catalog = _metaSqlDb->GetTableCatalog(SQLDB_SOURCE_ONLY, schema.c_str(), table.c_str());
+
+	if(catalog == NULL)
+		return false;
+
 	// Find mapping record for this table and column
-	for(std::list<SqlColMeta>::iterator i = table_columns->begin(); i != table_columns->end(); i++)
+	for(std::vector<SqlColMeta*>::iterator i = catalog->columns.begin(); i != catalog->columns.end(); i++)
 	{
 		// Not a primary key column
-        if((*i).pk_column == false)
+        if((*i)->pk_column == false)
 			continue;
 
-		char *col = (*i).column;
-		char *tab = (*i).table;
-		char *sch = (*i).schema;
+		char *col = (*i)->column;
+		char *tab = (*i)->table;
+		char *sch = (*i)->schema;
 
 		if(col == NULL || tab == NULL || sch == NULL)
 			continue;
 
 		if(_stricmp(col, column) == 0 && _stricmp(tab, table.c_str()) == 0 &&
 			_stricmp(sch, schema.c_str()) == 0)
-            return (*i).pk_column;
+            return (*i)->pk_column;
 	}
 
     return false;
@@ -3391,20 +3568,20 @@ int SqlDb::BuildQuery(std::string &s_query, std::string &t_query, const char *s_
 		SqlApiBase::SplitQualifiedName(s_table, s_schema, s_object);
 		SqlApiBase::SplitQualifiedName(t_table, t_schema, t_object);
 
-		std::list<SqlColMeta> *table_columns = _source_ca.db_api->GetTableColumns();
+		SqlTableCatalog *catalog = _source_ca.db_api->GetCatalogTable(s_schema.c_str(), s_object.c_str());
 
-		if(table_columns == NULL)
-			return -1;
+		std::vector<SqlColMeta*> no_columns;
+		std::vector<SqlColMeta*> *table_columns = (catalog != NULL) ? &catalog->columns : &no_columns;
 
 		int num = 0;
 
 		// Find table columns (already ordered by column number)
-		for(std::list<SqlColMeta>::iterator i = table_columns->begin(); i != table_columns->end(); i++)
+		for(std::vector<SqlColMeta*>::iterator i = table_columns->begin(); i != table_columns->end(); i++)
 		{
-			char *s = (*i).schema;
-			char *t = (*i).table;
-			char *c = (*i).column;
-			char *d = (*i).data_type;
+			char *s = (*i)->schema;
+			char *t = (*i)->table;
+			char *c = (*i)->column;
+			char *d = (*i)->data_type;
 
 			// Table found
 			if(s != NULL && t != NULL && c != NULL && strcmp(s, s_schema.c_str()) == 0 && 
@@ -3613,20 +3790,20 @@ int SqlDb::BuildQueryAddOrder(std::string &s_query, std::string &s_schema, std::
 
 	bool pk_exists = false;
 
-	std::list<SqlConstraints> *table_cns = db_api->GetTableConstraints();
-	std::list<SqlConsColumns> *table_cns_cols = db_api->GetConstraintColumns();
+	// Catalog objects of the table
+	SqlTableCatalog *catalog = db_api->GetCatalogTable(s_schema.c_str(), s_object.c_str());
 
-	if(table_cns != NULL && table_cns_cols != NULL)
+	if(catalog != NULL)
 	{
 		// Find a primary or unique key
-		for(std::list<SqlConstraints>::iterator i = table_cns->begin(); i != table_cns->end(); i++)
+		for(std::vector<SqlConstraints*>::iterator i = catalog->constraints.begin(); i != catalog->constraints.end(); i++)
 		{
-			if((*i).type != 'P' && (*i).type != 'U')
+			if((*i)->type != 'P' && (*i)->type != 'U')
 				continue;
 
-			char *s = (*i).schema;
-			char *t = (*i).table;
-			char *c = (*i).constraint;
+			char *s = (*i)->schema;
+			char *t = (*i)->table;
+			char *c = (*i)->constraint;
 
 			if(s == NULL || t == NULL || c == NULL)
 				continue;
@@ -3635,7 +3812,7 @@ int SqlDb::BuildQueryAddOrder(std::string &s_query, std::string &s_schema, std::
 					continue;
 	
 			// Now find the key columns
-			db_api->GetKeyConstraintColumns((*i), s_order, &s_order_types);
+			db_api->GetKeyConstraintColumns(*(*i), s_order, &s_order_types);
 			
 			pk_exists = true;
 			break;
@@ -3644,18 +3821,16 @@ int SqlDb::BuildQueryAddOrder(std::string &s_query, std::string &s_schema, std::
 
 	bool unique_exists = false;
 
-	std::list<SqlIndexes> *idx = db_api->GetTableIndexes();
-
-	if(pk_exists == false && idx != NULL)
+	if(pk_exists == false && catalog != NULL)
 	{
 		// Find the first unique index
-		for(std::list<SqlIndexes>::iterator i = idx->begin(); i != idx->end(); i++)
+		for(std::vector<SqlIndexes*>::iterator i = catalog->indexes.begin(); i != catalog->indexes.end(); i++)
 		{
-			if((*i).unique == false)
+			if((*i)->unique == false)
 				continue;
 
-			char *s = (*i).t_schema;
-			char *t = (*i).t_name;
+			char *s = (*i)->t_schema;
+			char *t = (*i)->t_name;
 			
 			if(s == NULL || t == NULL)
 				continue;
@@ -3664,27 +3839,25 @@ int SqlDb::BuildQueryAddOrder(std::string &s_query, std::string &s_schema, std::
 				continue;
 	
 			// Get index columns
-			db_api->GetIndexColumns((*i), s_order, s_order_sorts);
+			db_api->GetIndexColumns(*(*i), s_order, s_order_sorts);
 
 			unique_exists = true;
 			break;
 		}
 	} 
 
-	std::list<SqlColMeta> *table_cols = db_api->GetTableColumns();
-
-	if(pk_exists == false && unique_exists == false && table_cols != NULL)
+	if(pk_exists == false && unique_exists == false && catalog != NULL)
 	{
 		bool found = false;
 
 		// Find table columns
-		for(std::list<SqlColMeta>::iterator i = table_cols->begin(); i != table_cols->end(); i++)
+		for(std::vector<SqlColMeta*>::iterator i = catalog->columns.begin(); i != catalog->columns.end(); i++)
 		{
-			char *s = (*i).schema;
-			char *t = (*i).table;
-			char *c = (*i).column;
-			char *d = (*i).data_type;
-			int dc = (*i).data_type_code;
+			char *s = (*i)->schema;
+			char *t = (*i)->table;
+			char *c = (*i)->column;
+			char *d = (*i)->data_type;
+			int dc = (*i)->data_type_code;
 
 			if(s == NULL || t == NULL || c == NULL)
 				continue;
@@ -4076,6 +4249,10 @@ void SqlDb::SetParameters(Parameters *p)
 	_validation_not_equal_max_rows = _parameters->GetInt("-validation_not_equal_max_rows", -1);
 	_validation_datetime_fraction = _parameters->GetInt("-validation_datetime_fraction", -1);
 	_mysql_validation_collate = _parameters->Get("-mysql_validation_collate");
+
+	// Fetch size is not adapted when it is set explicitly
+	if(_parameters->GetFalse("-batch_adaptive") != NULL || _parameters->Get("-batch_max_rows") != NULL)
+		_adaptive_batch = false;
 }
 
 // Get errors on the DB interface
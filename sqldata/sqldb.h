@@ -41,6 +41,13 @@
 #define SQLDB_SOURCE_ONLY					2
 #define SQLDB_TARGET_ONLY					3
 
+// Adaptive fetch size: minimum rows, time to measure throughput, batch latency that forces shrinking, 
+// throughput change (percent) considered significant
+#define SQLDB_BATCH_MIN_ROWS				100
+#define SQLDB_BATCH_WINDOW_MS				500
+#define SQLDB_BATCH_MAX_LATENCY_MS			2000
+#define SQLDB_BATCH_RATE_CHANGE				5
+
 // Database types
 #define SQLDATA_SQL_SERVER					1
 #define SQLDATA_ORACLE						2
@@ -162,6 +169,80 @@ struct SqlDbThreadCa
 	}
 };
 
+// Data transfer stages measured per batch
+#define SQLDATA_STAGE_FETCH			0		// Fetching rows from the source
+#define SQLDATA_STAGE_ENCODE		1		// Converting rows to the target format
+#define SQLDATA_STAGE_SEND			2		// Sending rows to the target (includes conversion if the API does not measure it)
+#define SQLDATA_STAGE_COMMIT		3		// Completing the bulk transfer in the target
+#define SQLDATA_STAGES				4
+
+// Number of latency histogram buckets, bucket 0 is less than 1 ms, bucket i is [2^(i-1), 2^i) ms, the last one is open
+#define SQLDATA_HIST_BUCKETS		16
+
+// Latency histogram for a transfer stage (milliseconds)
+struct SqlDataHistogram
+{
+	int count;
+	int max;
+	__int64 sum;
+	int buckets[SQLDATA_HIST_BUCKETS];
+
+	void Reset()
+	{
+		count = 0; max = 0; sum = 0;
+
+		for(int i = 0; i < SQLDATA_HIST_BUCKETS; i++)
+			buckets[i] = 0;
+	}
+
+	void Add(size_t ms)
+	{
+		int b = 0;
+
+		while(b < SQLDATA_HIST_BUCKETS - 1 && ((size_t)1 << b) <= ms)
+			b++;
+
+		buckets[b]++;
+		count++;
+		sum += ms;
+
+		if((int)ms > max)
+			max = (int)ms;
+	}
+
+	void Merge(SqlDataHistogram &h)
+	{
+		for(int i = 0; i < SQLDATA_HIST_BUCKETS; i++)
+			buckets[i] += h.buckets[i];
+
+		count += h.count;
+		sum += h.sum;
+
+		if(h.max > max)
+			max = h.max;
+	}
+};
+
+// Adaptive fetch size state for a table transfer
+struct SqlDbBatchControl
+{
+	bool enabled;
+
+	// Rows requested by the next fetch, limits defined by the allocated buffer
+	size_t rows;
+	size_t min_rows;
+	size_t max_rows;
+
+	// Growing (1) or shrinking (-1) the fetch size
+	int direction;
+	// Throughput (rows per second) measured in the previous window
+	double prev_rate;
+
+	// Rows and time in the current measurement window
+	size_t window_rows;
+	size_t window_time;
+};
+
 // SQLData Command packet
 struct SqlDataCommand
 {
@@ -219,6 +300,9 @@ struct SqlDataReply
 	__int64 _s_bigint1;
 	__int64 _t_bigint1;
 
+	// Per-batch latency of transfer stages
+	SqlDataHistogram _stages[SQLDATA_STAGES];
+
 	// Database error code for source and target database
 	int s_error;
 	int t_error;
@@ -246,6 +330,9 @@ struct SqlDataReply
 		_t_int1 = 0; _t_int2 = 0; 
 		_s_bigint1 = 0; _t_bigint1 = 0; 
 
+		for(int i = 0; i < SQLDATA_STAGES; i++)
+			_stages[i].Reset();
+
 		_time_spent = 0; _s_time_spent = 0; _t_time_spent = 0;
 
 		s_error = 0; t_error = 0; 
@@ -298,6 +385,9 @@ class SqlDb
 	
 	bool _trace_diff_data;
 	AppLog _trace_diff;
+
+	// Adapt the fetch size to the measured throughput
+	bool _adaptive_batch;
 	
 	// Session number of the interface
 	int _session_id;
@@ -380,6 +470,7 @@ public:
 	int ReadConstraintTable(int db_types, const char *schema, const char *constraint, std::string &table);
 	int ReadConstraintColumns(int db_types, const char *schema, const char *table, const char *constraint, std::string &cols);
 	int GetKeyConstraintColumns(int db_types, SqlConstraints &cns, std::list<std::string> &key_cols);
+	bool IsIdentityDefined(int db_types, std::string &schema, std::string &table);
 	int GetForeignKeyConstraintColumns(int db_types, SqlConstraints &cns, std::list<std::string> &fcols, std::list<std::string> &pcols, std::string &ptable);
 	int GetIndexColumns(int db_types, SqlIndexes &idx, std::list<std::string> &idx_cols, std::list<std::string> &idx_sorts);
 
@@ -390,6 +481,8 @@ public:
 	std::list<SqlColMeta>* GetTableColumns(int db_type);
 	std::list<SqlConstraints>* GetTableConstraints(int db_type);
 	std::list<SqlConsColumns>* GetConstraintColumns(int db_type);
+	std::vector<SqlConsColumns*>* GetConstraintColumns(int db_type, const char *schema, const char *constraint);
+	SqlTableCatalog* GetTableCatalog(int db_type, const char *schema, const char *table);
 	std::list<SqlComments>* GetTableComments(int db_type);
 	std::list<SqlIndexes>* GetTableIndexes(int db_type);
 	std::list<SqlIndColumns>* GetIndexColumns(int db_type);
@@ -414,6 +507,10 @@ public:
 private:
 	// Check whether we need to drop, create or truncate the table 
 	int PrepareTransfer(SqlCol *s_cols, const char *s_table, const char *t_table, size_t col_count, int options, SqlDataReply &reply);
+	// Split the batch write time into conversion and send stages
+	void AddWriteStages(SqlDataReply &reply, size_t time_write);
+	// Change the number of rows for the next fetch depending on the measured throughput
+	void AdaptBatchRows(SqlDbBatchControl &batch, int rows, size_t time_read, size_t time_write, bool parallel);
 
 	bool IsSpecialIdentifier(const char *s_name);
 
@@ -21,6 +21,7 @@
 #endif
 
 #include <stdio.h>
+#include <limits.h>
 #include "sqlmysqlapi.h"
 #include "str.h"
 #include "os.h"
@@ -70,6 +71,12 @@ SqlMysqlApi::SqlMysqlApi()
 	_ldi_write_newline = false;
 	_ldi_lob_data = NULL;
 	_ldi_lob_size = 0;
+	_ldi_lob_stream = false;
+	_ldi_lob_chunk = NULL;
+	_ldi_conv_data = NULL;
+	_ldi_lob_offset = 0;
+	_ldi_lob_more = false;
+	_ldi_lob_failed = false;
 
 	_ldi_bytes = 0;
 	_ldi_bytes_all = 0;
@@ -313,8 +320,14 @@ int SqlMysqlApi::Connect(size_t *time_spent)
 	if(mysql == NULL)
 		return -1;
 
+	unsigned long flags = CLIENT_LOCAL_FILES;
+
+	// Compress the protocol packets, helps when the server is on a slow link
+	if(_compress)
+		flags |= CLIENT_COMPRESS;
+
 	mysql = _mysql_real_connect(&_mysql, _server.c_str(), _user.c_str(), _pwd.c_str(),
-		_db.c_str(), (unsigned int)_port, NULL, CLIENT_LOCAL_FILES);
+		_db.c_str(), (unsigned int)_port, NULL, flags);
 
 	if(mysql == NULL)
 	{
@@ -770,7 +783,7 @@ int SqlMysqlApi::CloseCursor()
 }
 
 // Initialize the bulk copy from one database into another
-int SqlMysqlApi::InitBulkTransfer(const char *table, size_t col_count, size_t /*allocated_array_rows*/, SqlCol * /*s_cols*/, SqlCol ** /*t_cols*/)
+int SqlMysqlApi::InitBulkTransfer(const char *table, size_t col_count, size_t allocated_array_rows, SqlCol *s_cols, SqlCol ** /*t_cols*/)
 {
 	TRACE("MySQL/C InitBulkTransfer() Entered");
 
@@ -794,6 +807,36 @@ int SqlMysqlApi::InitBulkTransfer(const char *table, size_t col_count, size_t /*
 	_ldi_write_newline = false;
 	_ldi_lob_data = NULL;
 	_ldi_lob_size = 0;
+	_ldi_lob_stream = false;
+	_ldi_lob_offset = 0;
+	_ldi_lob_more = false;
+	_ldi_lob_failed = false;
+
+	// Allocate a buffer to stream LOB values by parts if the source API supports it
+	if(s_cols != NULL && _source_api_provider != NULL && _source_api_provider->IsLobPartReadSupported())
+	{
+		for(size_t i = 0; i < col_count; i++)
+		{
+			if(s_cols[i]._lob)
+			{
+				_ldi_lob_chunk = new char[_lob_chunk_size];
+				break;
+			}
+		}
+	}
+
+	// Allocate buffers to convert date and timestamp columns for the whole batch
+	if(s_cols != NULL)
+	{
+		_ldi_conv_data = new char*[col_count];
+
+		for(size_t i = 0; i < col_count; i++)
+		{
+			int len = GetConvertedLength(&s_cols[i]);
+
+			_ldi_conv_data[i] = (len != 0) ? new char[allocated_array_rows * len + 1] : NULL;
+		}
+	}
 
 	_ldi_bytes = 0;
 	_ldi_bytes_all = 0;
@@ -836,6 +879,19 @@ int SqlMysqlApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_writte
 	_ldi_rows_count = rows_fetched;
 	_ldi_cols = s_cols;
 
+	// Convert date and timestamp columns for all rows at once
+	for(size_t k = 0; _ldi_conv_data != NULL && k < _ldi_cols_count; k++)
+	{
+		if(_ldi_conv_data[k] == NULL)
+			continue;
+
+		if(GetConvertedLength(&s_cols[k]) == SQLDATA_ORA_DATE_STR_LEN)
+			OraDatesToStr(&s_cols[k], (size_t)rows_fetched, _ldi_conv_data[k]);
+		else
+			// In ODBC, fraction is stored in nanoseconds, but now we support only microseconds
+			OdbcTimestampsToStr(&s_cols[k], (size_t)rows_fetched, 1000, false, _ldi_conv_data[k]);
+	}
+
 	_ldi_current_row = 0;
 	_ldi_current_col = 0;
 	_ldi_current_col_len = 0;
@@ -872,6 +928,22 @@ int SqlMysqlApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_writte
 	return _ldi_rc;
 }
 
+// Get the text length if the column is converted for the whole batch, 0 otherwise
+int SqlMysqlApi::GetConvertedLength(SqlCol *col)
+{
+	// Oracle DATE fetched as 7 byte binary sequence
+	if(_source_api_type == SQLDATA_ORACLE && col->_native_fetch_dt == SQLT_DAT)
+		return SQLDATA_ORA_DATE_STR_LEN;
+
+	// ODBC TIMESTAMP fetched as SQL_TIMESTAMP_STRUCT
+	if((_source_api_type == SQLDATA_SQL_SERVER || _source_api_type == SQLDATA_DB2 || 
+		_source_api_type == SQLDATA_INFORMIX || _source_api_type == SQLDATA_ASA || 
+		_source_api_type == SQLDATA_ODBC) && col->_native_fetch_dt == SQL_C_TYPE_TIMESTAMP)
+		return SQLDATA_ODBC_TS_STR_LEN;
+
+	return 0;
+}
+
 // Write LOB data 
 int SqlMysqlApi::WriteLob(SqlCol * /*s_cols*/, int /*row*/, int * /*lob_bytes*/)
 {
@@ -956,7 +1028,7 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 					if(_ldi_cols[k]._native_fetch_dt == SQLT_BLOB || _ldi_cols[k]._native_fetch_dt == SQLT_CLOB)
 					{
 						// Get the size and read LOB value when just switched to new column
-						if(_ldi_current_col_len == 0)
+						if(_ldi_current_col_len == 0 && _ldi_lob_stream == false)
 						{
 							// Get the LOB size in bytes for BLOB, in characters for CLOB
 							int lob_rc = _source_api_provider->GetLobLength(i, k, &_ldi_lob_size);
@@ -965,6 +1037,18 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 							if(lob_rc != -1)
 								len = (int)_ldi_lob_size;
 
+							// Value will be read by parts while it is written, the end is defined by the last part
+							if(lob_rc != -1 && _ldi_lob_size > 0 && _ldi_lob_chunk != NULL)
+							{
+								_ldi_lob_stream = true;
+								_ldi_lob_data = _ldi_lob_chunk;
+								_ldi_lob_size = 0;
+								_ldi_lob_offset = 0;
+								_ldi_lob_more = true;
+
+								len = INT_MAX;
+							}
+							else
 							if(lob_rc != -1 && _ldi_lob_size > 0)
 							{
 								size_t alloc_size = 0;
@@ -991,7 +1075,7 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 							}
 						}
 						else
-							len = (int)_ldi_lob_size;
+							len = _ldi_lob_stream ? INT_MAX : (int)_ldi_lob_size;
 					}
 					// Not a LOB column
 					else
@@ -1064,7 +1148,11 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 					if(_ldi_lob_data == 0)
 						c = (_ldi_cols[k]._data + _ldi_cols[k]._fetch_len * i)[m];
 					else
-						c = _ldi_lob_data[m];
+					// All parts of LOB value were written
+					if(_ldi_lob_stream && ReadLobPart(i, k, (size_t)m) == false)
+						break;
+					else
+						c = _ldi_lob_data[m - _ldi_lob_offset];
 
 					// Duplicate escape \ character
 					if(c == '\\')
@@ -1129,11 +1217,23 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 					}
 				}
 
+				// Terminate LOAD DATA INFILE command if the LOB value cannot be read
+				if(_ldi_lob_failed)
+					return -1;
+
 				// All column data were written
 				if(no_space == false)
 				{
 					_ldi_current_col_len = 0;
 
+					if(_ldi_lob_stream)
+					{
+						_ldi_lob_stream = false;
+						_ldi_lob_data = NULL;
+						_ldi_lob_size = 0;
+						_ldi_lob_offset = 0;
+					}
+					else
 					if(_ldi_lob_data != NULL)
 					{
 						_source_api_provider->FreeLobBuffer(_ldi_lob_data);
@@ -1148,30 +1248,8 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 			{
 				if(remain_len >= 19)
 				{
-					// Unsigned required for proper conversion to int
-					unsigned char *data = (unsigned char*)(_ldi_cols[k]._data + _ldi_cols[k]._fetch_len * i);
-
-					int c = ((int)data[0]) - 100;
-					int y = ((int)data[1]) - 100;
-					int m = (int)data[2];
-					int d = (int)data[3];
-					int h = ((int)data[4]) - 1;
-					int mi = ((int)data[5]) - 1;
-					int s = ((int)data[6]) - 1;
-
-					// Get string representation
-					Str::Dt2Ch(c, cur);
-					Str::Dt2Ch(y, cur + 2);
-					cur[4] = '-';
-					Str::Dt2Ch(m, cur + 5);
-					cur[7] = '-';
-					Str::Dt2Ch(d, cur + 8);
-					cur[10] = ' ';
-					Str::Dt2Ch(h, cur + 11);
-					cur[13] = ':';
-					Str::Dt2Ch(mi, cur + 14);
-					cur[16] = ':';
-					Str::Dt2Ch(s, cur + 17);
+					// Converted to text for the batch in TransferRows
+					memcpy(cur, _ldi_conv_data[k] + SQLDATA_ORA_DATE_STR_LEN * i, SQLDATA_ORA_DATE_STR_LEN);
 
 					cur += 19;
 					remain_len -= 19;
@@ -1190,18 +1268,8 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 			{
 				if(remain_len >= 26)
 				{
-					size_t offset = sizeof(SQL_TIMESTAMP_STRUCT) * i;
-
-					// Informix returns '1200-01-01 11:11:00.0' for 11:11 (HOUR TO MINUTE)
-					SQL_TIMESTAMP_STRUCT *ts = (SQL_TIMESTAMP_STRUCT*)(_ldi_cols[k]._data + offset);
-
-					long fraction = (long)ts->fraction;
-
-					// In ODBC, fraction is stored in nanoseconds, but now we support only microseconds
-					fraction = fraction/1000;
-
-					// Convert SQL_TIMESTAMP_STRUCT to string
-					Str::SqlTs2Str((short)ts->year, (short)ts->month, (short)ts->day, (short)ts->hour, (short)ts->minute, (short)ts->second, fraction, cur);
+					// Converted to text for the batch in TransferRows
+					memcpy(cur, _ldi_conv_data[k] + SQLDATA_ODBC_TS_STR_LEN * i, SQLDATA_ODBC_TS_STR_LEN);
 
 					cur += 26;
 					remain_len -= 26;
@@ -1274,6 +1342,37 @@ int SqlMysqlApi::local_infile_read(char *buf, unsigned int buf_len)
 	return (int)(cur - buf);
 }
 
+// Read LOB parts until the specified position is in the chunk buffer, returns false if there is no more data
+bool SqlMysqlApi::ReadLobPart(size_t row, size_t column, size_t pos)
+{
+	while(pos >= _ldi_lob_offset + _ldi_lob_size)
+	{
+		if(_ldi_lob_more == false)
+			return false;
+
+		int read_size = 0;
+
+		// Returns 1 if more parts remain
+		int rc = _source_api_provider->GetLobPart(row, column, _ldi_lob_chunk, _lob_chunk_size, &read_size);
+
+		if(rc == -1)
+		{
+			TRACE_P("MySQL/C LOAD DATA INFILE Read callback() Reading LOB part failed: %s", _source_api_provider->GetNativeErrorText());
+
+			_ldi_lob_more = false;
+			_ldi_lob_failed = true;
+
+			return false;
+		}
+
+		_ldi_lob_offset += _ldi_lob_size;
+		_ldi_lob_size = (size_t)read_size;
+		_ldi_lob_more = (rc == 1) ? true : false;
+	}
+
+	return true;
+}
+
 void SqlMysqlApi::local_infile_end(void * /*ptr*/)
 {
 	TRACE("MySQL/C LOAD DATA INFILE - End callback()");
@@ -1389,6 +1488,18 @@ int SqlMysqlApi::CloseBulkTransfer()
 #endif
 	}
 
+	delete [] _ldi_lob_chunk;
+	_ldi_lob_chunk = NULL;
+
+	if(_ldi_conv_data != NULL)
+	{
+		for(size_t i = 0; i < _ldi_cols_count; i++)
+			delete [] _ldi_conv_data[i];
+
+		delete [] _ldi_conv_data;
+		_ldi_conv_data = NULL;
+	}
+
 	// Check warnings and errors
 	ShowWarnings(_load_command.c_str());
 
@@ -96,6 +96,14 @@ class SqlMysqlApi : public SqlApiBase
 	// Buffer for the current LOB value
 	char *_ldi_lob_data;
 	size_t _ldi_lob_size;
+	// LOB value is streamed by parts: chunk buffer, offset of the current part in value, and whether more parts remain
+	bool _ldi_lob_stream;
+	char *_ldi_lob_chunk;
+	size_t _ldi_lob_offset;
+	bool _ldi_lob_more;
+	bool _ldi_lob_failed;
+	// Date and timestamp columns converted to text for the whole batch (NULL for other columns)
+	char **_ldi_conv_data;
 
 	// Bytes written during last transfer iteration (last batch)
 	int _ldi_bytes;
@@ -193,6 +201,9 @@ public:
 	// Specifies whether API allows to parallel reading from this API and write to another API
 	virtual bool CanParallelReadWrite() { return true; }
 
+	// Enable the client/server protocol compression for next connections
+	virtual int SetCompress(bool compress) { _compress = compress; return 0; }
+
 	// Complete bulk transfer
 	virtual int CloseBulkTransfer();
 
@@ -248,6 +259,10 @@ private:
 
 	// Write LOB data using BCP API
 	int WriteLob(SqlCol *s_cols, int row, int *lob_bytes);
+	// Get the text length if the column is converted for the whole batch, 0 otherwise
+	int GetConvertedLength(SqlCol *col);
+	// Read LOB parts until the specified position is in the chunk buffer
+	bool ReadLobPart(size_t row, size_t column, size_t pos);
 
 	// LOAD DATA INFILE callbacks
 	int local_infile_read(char *buf, unsigned int buf_len);
@@ -16,7 +16,12 @@
 
 // SqlOciApi Oracle OCI API
 
+#if defined(WIN32) || defined(_WIN64)
+#include <process.h>
+#endif
+
 #include <stdio.h>
+#include <algorithm>
 #include "sqlociapi.h"
 #include "str.h"
 #include "os.h"
@@ -61,6 +66,8 @@ SqlOciApi::SqlOciApi()
 	_ociLobFreeTemporary = NULL;
 	_ociLobGetLength2 = NULL;
 	_ociLobRead2 = NULL;
+	_ociBreak = NULL;
+	_ociReset = NULL;
 	_ociLobTrim = NULL;
 	_ociLobWrite = NULL;
 	_ociLobWriteAppend = NULL;
@@ -74,6 +81,14 @@ SqlOciApi::SqlOciApi()
 	_ociTransCommit = NULL;
 
 	_bind_long_inplace = 0;
+	_lob_prefetch_size = 32768;
+
+	_lob_part_row = 0;
+	_lob_part_column = 0;
+	_lob_part_more = false;
+
+	_meta_sessions = 1;
+	_meta_schema_batch = 0;
 }
 
 // Initialize API
@@ -179,6 +194,8 @@ int SqlOciApi::Init()
 	_ociLobWrite = (OCILobWriteFunc)Os::GetProcAddress(_oci_dll, "OCILobWrite");
 	_ociLobWriteAppend = (OCILobWriteAppendFunc)Os::GetProcAddress(_oci_dll, "OCILobWriteAppend");
 	_ociParamGet = (OCIParamGetFunc)Os::GetProcAddress(_oci_dll, "OCIParamGet");
+	_ociBreak = (OCIBreakFunc)Os::GetProcAddress(_oci_dll, "OCIBreak");
+	_ociReset = (OCIResetFunc)Os::GetProcAddress(_oci_dll, "OCIReset");
 	_ociServerAttach = (OCIServerAttachFunc)Os::GetProcAddress(_oci_dll, "OCIServerAttach");
 	_ociServerDetach = (OCIServerDetachFunc)Os::GetProcAddress(_oci_dll, "OCIServerDetach");
 	_ociSessionBegin = (OCISessionBeginFunc)Os::GetProcAddress(_oci_dll, "OCISessionBegin");
@@ -321,6 +338,10 @@ int SqlOciApi::InitSession()
 		(_stricmp(value, "yes") == 0 || _stricmp(value, "true") == 0))
 		_cursor_fetch_lob_as_varchar = true;
 
+	// Prefetch LOB length and data with rows to avoid round trips for each LOB, 0 disables prefetch
+	if(_parameters != NULL)
+		_lob_prefetch_size = _parameters->GetInt("-oracle_lob_prefetch_size", _lob_prefetch_size);
+
 	return 0;
 }
 
@@ -748,6 +769,21 @@ int SqlOciApi::OpenCursor(const char *query, size_t buffer_rows, int buffer_memo
 				TRACE("OCI OpenCursor() Failed");
 		        return -1;
 	        }
+
+			// LOB prefetch is available since Oracle 11g (client and server), it returns the LOB length and 
+			// the first bytes of LOB data together with locators, so GetLobLength and reading small LOBs do not 
+			// require a round trip for each LOB value. Errors are ignored as prefetch is just an optimization
+			if(_bind_long_inplace == 0 && _lob_prefetch_size > 0 && IsVersionEqualOrHigher(11) &&
+				(_cursor_cols[i]._native_dt == SQLT_BLOB || _cursor_cols[i]._native_dt == SQLT_CLOB))
+			{
+				boolean prefetch_length = TRUE;
+				ub4 prefetch_size = (ub4)_lob_prefetch_size;
+
+				_ociAttrSet(defnpp, OCI_HTYPE_DEFINE, &prefetch_length, 0, OCI_ATTR_LOBPREFETCH_LENGTH, _errhp);
+				_ociAttrSet(defnpp, OCI_HTYPE_DEFINE, &prefetch_size, 0, OCI_ATTR_LOBPREFETCH_SIZE, _errhp);
+
+				TRACE_P("OCI OpenCursor() LOB prefetch %d bytes for column %d", _lob_prefetch_size, i + 1);
+			}
 		}
 	}
 
@@ -796,8 +832,13 @@ int SqlOciApi::Fetch(int *rows_fetched, size_t *time_spent)
 	TRACE("OCI Fetch() Entered");
 	size_t start = GetTickCount();
 
+	size_t rows = (_cursor_fetch_rows != 0) ? _cursor_fetch_rows : _cursor_allocated_rows;
+
+	// LOB locators of the previous rows are overwritten by the fetch
+	CancelLobPart();
+
 	// Fetch the data
-	int rc = _ociStmtFetch2(_stmtp_cursor, _errhp, (ub4)_cursor_allocated_rows, OCI_DEFAULT, 0, OCI_DEFAULT);
+	int rc = _ociStmtFetch2(_stmtp_cursor, _errhp, (ub4)rows, OCI_DEFAULT, 0, OCI_DEFAULT);
 
 	int fetched = 0;
 
@@ -822,10 +863,13 @@ int SqlOciApi::CloseCursor()
 
 	TRACE("OCI CloseCursor() Entered");
 
+	CancelLobPart();
+
 	// Close the statement handle
 	int rc = _ociHandleFree(_stmtp_cursor, OCI_HTYPE_STMT);
 
 	_stmtp_cursor = NULL;
+	_cursor_fetch_rows = 0;
 
 	if(_cursor_cols == NULL)
 		return 0;
@@ -858,6 +902,50 @@ bool SqlOciApi::CanParallelReadWrite()
 	return true;
 }
 
+// Set the number of rows for next fetches (OCI fetches the requested number of rows into the array)
+int SqlOciApi::SetFetchRows(size_t rows)
+{
+	if(rows == 0 || rows > _cursor_allocated_rows)
+		return -1;
+
+	_cursor_fetch_rows = rows;
+	return 0;
+}
+
+// Fetch next rows into the specified buffers
+int SqlOciApi::SetFetchBuffers(SqlCol *cols)
+{
+	// LOB locators are allocated for cursor buffers only
+	if(cols == NULL || _cursor_cols == NULL || _cursor_lob_exists == true || _ociDefineByPos == NULL)
+		return -1;
+
+	TRACE("OCI SetFetchBuffers() Entered");
+
+	int rc = 0;
+
+	// Redefine only columns defined in OpenCursor, the type and length remain the same
+	for(size_t i = 0; i < _cursor_cols_count; i++)
+	{
+		if(_cursor_cols[i]._data == NULL)
+			continue;
+
+		OCIDefine *defnpp = NULL;
+
+		rc = _ociDefineByPos(_stmtp_cursor, &defnpp, _errhp, (ub4)(i + 1), cols[i]._data, (sb4)_cursor_cols[i]._fetch_len, 
+							(ub2)_cursor_cols[i]._native_fetch_dt, (ub2*)cols[i]._ind2, 
+							(ub2*)cols[i]._len_ind2, NULL, OCI_DEFAULT);
+
+		if(rc == -1)
+		{
+			SetError();
+			break;
+		}
+	}
+
+	TRACE("OCI SetFetchBuffers() Left");
+	return rc;
+}
+
 // Get the length of LOB column in the open cursor 
 int SqlOciApi::GetLobLength(size_t row, size_t column, size_t *length)
 {
@@ -940,6 +1028,101 @@ int SqlOciApi::GetLobContent(size_t row, size_t column, void *data, size_t lengt
 	return rc;
 }
 
+// Get partial LOB content, returns 1 if more pieces remain, 0 if the last piece was read
+int SqlOciApi::GetLobPart(size_t row, size_t column, void *data, size_t length, int *len_ind)
+{
+	if(data == NULL || length == 0 || _cursor_cols == NULL || _cursor_cols_count <= column || 
+		row >= _cursor_allocated_rows || _ociLobRead2 == NULL)
+		return -1;
+
+	OCILobLocator *loc = ((OCILobLocator**)_cursor_cols[column]._data)[row];
+
+	// Amounts are 0 to read the whole LOB in streaming mode, on return contains the number of bytes in piece
+	oraub8 byte_amt = 0;
+	oraub8 char_amt = 0;
+
+	ub1 csfrm = 0;
+	ub1 piece = OCI_NEXT_PIECE;
+
+	// Another LOB requested before all pieces of the previous one are read
+	if(_lob_part_more == true && (_lob_part_row != row || _lob_part_column != column))
+		CancelLobPart();
+
+	// Start reading a new LOB value
+	if(_lob_part_more == false)
+	{
+		piece = OCI_FIRST_PIECE;
+
+		_lob_part_row = row;
+		_lob_part_column = column;
+	}
+
+	// SQLCS_IMPLICIT for CLOB and SQLCS_NCHAR for NCLOB locator 
+	if(_cursor_cols[column]._native_dt == SQLT_CLOB)
+		_ociLobCharSetForm(_envhp, _errhp, loc, &csfrm);
+
+	// Polling mode, OCI_NEED_DATA is returned while there are more pieces
+	int rc = _ociLobRead2(_svchp, _errhp, loc, &byte_amt, &char_amt, 1, data, (oraub8)length, piece, NULL, NULL, 0, csfrm);
+
+	if(len_ind != NULL)
+		*len_ind = (int)byte_amt;
+
+	if(rc == OCI_NEED_DATA)
+	{
+		_lob_part_more = true;
+		return 1;
+	}
+
+	_lob_part_more = false;
+
+	if(rc < 0)
+	{
+		SetError();
+		return -1;
+	}
+
+	return 0;
+}
+
+// Stop reading the LOB by parts before all pieces are read
+void SqlOciApi::CancelLobPart()
+{
+	if(_lob_part_more == false)
+		return;
+
+	_lob_part_more = false;
+
+	// OCIBreak followed by OCIReset terminates the polling read on the server
+	if(_ociBreak != NULL && _ociReset != NULL)
+	{
+		_ociBreak(_svchp, _errhp);
+		_ociReset(_svchp, _errhp);
+		return;
+	}
+
+	if(_cursor_cols == NULL || _lob_part_column >= _cursor_cols_count || _lob_part_row >= _cursor_allocated_rows)
+		return;
+
+	// Otherwise read and discard the remaining pieces
+	OCILobLocator *loc = ((OCILobLocator**)_cursor_cols[_lob_part_column]._data)[_lob_part_row];
+
+	char buf[8192];
+	ub1 csfrm = 0;
+
+	if(_cursor_cols[_lob_part_column]._native_dt == SQLT_CLOB)
+		_ociLobCharSetForm(_envhp, _errhp, loc, &csfrm);
+
+	int rc = OCI_NEED_DATA;
+
+	while(rc == OCI_NEED_DATA)
+	{
+		oraub8 byte_amt = 0;
+		oraub8 char_amt = 0;
+
+		rc = _ociLobRead2(_svchp, _errhp, loc, &byte_amt, &char_amt, 1, buf, (oraub8)sizeof(buf), OCI_NEXT_PIECE, NULL, NULL, 0, csfrm);
+	}
+}
+
 // Get the list of available tables
 int SqlOciApi::GetAvailableTables(std::string &select, std::string &exclude, 
 										std::list<std::string> &tables)
@@ -1040,12 +1223,313 @@ int SqlOciApi::GetAvailableTables(std::string &select, std::string &exclude,
 // Read schema information
 int SqlOciApi::ReadSchema(const char *select, const char *exclude, bool read_cns, bool read_idx)
 {
+	ClearSchema();
+
+	const char *meta_cache = NULL;
+
+	if(_parameters != NULL)
+	{
+		_meta_sessions = _parameters->GetInt("-oracle_meta_sessions", _meta_sessions);
+		_meta_schema_batch = _parameters->GetInt("-oracle_meta_schema_batch", _meta_schema_batch);
+
+		meta_cache = _parameters->Get("-meta_cache");
+	}
+
+	size_t start = Os::GetTickCount();
+
+	std::string cache_key;
+	std::string fingerprint;
+
+	// Use the metadata snapshot from the previous run, and re-read only tables changed since then
+	if(meta_cache != NULL)
+	{
+		GetSchemaCacheKey(select, exclude, read_cns, read_idx, cache_key);
+		GetCatalogFingerprint(select, exclude, fingerprint);
+
+		if(ReadSchemaCache(meta_cache, cache_key, fingerprint, select, exclude, read_cns, read_idx) == 0)
+		{
+			CloseMetaSessions();
+
+			TRACE_P("OCI ReadSchema() Catalog read using snapshot %s in %d ms", meta_cache, (int)(Os::GetTickCount() - start));
+			return 0;
+		}
+	}
+
+	std::list<std::string> batches;
+
+	// Read a large list of schemas by batches to limit the size of catalog queries and result sets
+	if(_meta_schema_batch > 0)
+		GetSchemaBatches(select, _meta_schema_batch, batches);
+
+	int rc = 0;
+
+	if(batches.empty() == true)
+		rc = ReadSchemaBatch(select, exclude, read_cns, read_idx, true);
+	else
+	{
+		for(std::list<std::string>::iterator i = batches.begin(); i != batches.end(); i++)
+		{
+			TRACE_P("OCI ReadSchema() Reading batch: %s", (*i).c_str());
+
+			rc = ReadSchemaBatch((*i).c_str(), exclude, read_cns, read_idx, true);
+		}
+	}
+
+	CloseMetaSessions();
+
+	TRACE_P("OCI ReadSchema() Catalog read in %d ms, %d columns, %d constraints, %d indexes", 
+		(int)(Os::GetTickCount() - start), (int)_table_columns.size(), (int)_table_constraints.size(), 
+		(int)_table_indexes.size());
+
+	// Fingerprint is taken before reading the catalog, so changes made during the read are found next time
+	if(meta_cache != NULL && rc != -1 && fingerprint.empty() == false)
+	{
+		if(SaveSchemaCache(meta_cache, cache_key.c_str(), fingerprint.c_str()) == -1)
+			TRACE_P("OCI ReadSchema() Failed to write snapshot %s", meta_cache);
+	}
+
+	return rc;
+}
+
+// Load the metadata snapshot, and refresh tables changed after the snapshot was taken
+int SqlOciApi::ReadSchemaCache(const char *file, std::string &key, std::string &fingerprint, const char *select, 
+								const char *exclude, bool read_cns, bool read_idx)
+{
+	if(file == NULL || fingerprint.empty() == true)
+		return -1;
+
+	std::string cached;
+
+	if(LoadSchemaCache(file, key.c_str(), cached) == -1)
+	{
+		TRACE_P("OCI ReadSchema() Snapshot %s not found or cannot be used", file);
+		return -1;
+	}
+
 	std::string selection;
 	std::string selection2;
 
-	ClearSchema();
+	GetSchemaSelection(select, exclude, selection, selection2);
 
-	// Build WHERE clause to select rows from catalog
+	// Sequence values change without DDL, so sequences are always read
+	_sequences.clear();
+
+	if(cached == fingerprint)
+		return ReadSchemaStep(SQLOCI_META_SEQUENCES, selection, selection2);
+
+	// Fingerprint is <number of tables and indexes>;<max DDL time>
+	size_t cached_sep = cached.find(';');
+	size_t sep = fingerprint.find(';');
+
+	// Objects were added or dropped, read the entire catalog
+	if(cached_sep == std::string::npos || sep == std::string::npos || 
+		cached.compare(0, cached_sep, fingerprint, 0, sep) != 0 || cached_sep + 1 == cached.length())
+	{
+		TRACE_P("OCI ReadSchema() Snapshot %s is outdated, %s found, %s expected", file, cached.c_str(), fingerprint.c_str());
+
+		ClearSchema();
+		return -1;
+	}
+
+	std::list<std::string> changed;
+
+	// Tables with DDL time equal to the snapshot time are also refreshed as DDL time is stored in seconds
+	if(GetChangedTables(select, exclude, cached.c_str() + cached_sep + 1, changed) == -1 || 
+		changed.size() > SQLOCI_META_CACHE_MAX_CHANGED)
+	{
+		ClearSchema();
+		return -1;
+	}
+
+	std::set<std::string> tables;
+	std::string list;
+	std::string table_key;
+
+	for(std::list<std::string>::iterator i = changed.begin(); i != changed.end(); i++)
+	{
+		std::string schema;
+		std::string table;
+
+		SplitQualifiedName((*i).c_str(), schema, table);
+
+		GetCatalogKey(schema.c_str(), table.c_str(), table_key);
+
+		// Selection condition converts names to upper case, so mixed case names cannot be selected
+		if(table_key != (*i))
+		{
+			ClearSchema();
+			return -1;
+		}
+
+		tables.insert(table_key);
+
+		if(list.empty() == false)
+			list += ", ";
+
+		list += (*i);
+	}
+
+	TRACE_P("OCI ReadSchema() Snapshot %s, refreshing %d changed tables", file, (int)tables.size());
+
+	RemoveSchemaTables(tables);
+
+	if(list.empty() == false)
+		ReadSchemaBatch(list.c_str(), exclude, read_cns, read_idx, false);
+
+	int rc = ReadSchemaStep(SQLOCI_META_SEQUENCES, selection, selection2);
+
+	if(SaveSchemaCache(file, key.c_str(), fingerprint.c_str()) == -1)
+		TRACE_P("OCI ReadSchema() Failed to write snapshot %s", file);
+
+	return rc;
+}
+
+// Get the key identifying the database and selection the snapshot was created for
+void SqlOciApi::GetSchemaCacheKey(const char *select, const char *exclude, bool read_cns, bool read_idx, std::string &key)
+{
+	key = "oracle:";
+	key += _user;
+	key += "@";
+	key += _db;
+	key += "|";
+
+	if(select != NULL)
+		key += select;
+
+	key += "|";
+
+	if(exclude != NULL)
+		key += exclude;
+
+	key += read_cns ? "|C" : "|";
+	key += read_idx ? "|I" : "|";
+}
+
+// Get query returning tables and indexes with their DDL time, indexes are returned with their table names
+void SqlOciApi::GetCatalogObjectsQuery(const char *select, const char *exclude, std::string &query)
+{
+	std::string selection;
+	std::string selection2;
+
+	GetSchemaSelection(select, exclude, selection, selection2);
+
+	query = "SELECT owner, table_name, last_ddl_time FROM ";
+	query += "(SELECT owner, object_name table_name, last_ddl_time FROM all_objects WHERE object_type = 'TABLE'";
+	query += " UNION ALL SELECT i.table_owner, i.table_name, o.last_ddl_time FROM all_indexes i, all_objects o";
+	query += " WHERE o.owner = i.owner AND o.object_name = i.index_name AND o.object_type = 'INDEX')";
+
+	if(selection.empty() == false)
+	{
+		query += " WHERE ";
+		query += selection;
+	}
+}
+
+// Get the catalog fingerprint: number of tables and indexes, and the latest DDL time
+int SqlOciApi::GetCatalogFingerprint(const char *select, const char *exclude, std::string &fingerprint)
+{
+	std::string objects;
+	GetCatalogObjectsQuery(select, exclude, objects);
+
+	std::string query = "SELECT TO_CHAR(COUNT(*)), TO_CHAR(MAX(last_ddl_time), 'YYYY-MM-DD HH24:MI:SS') FROM (";
+	query += objects;
+	query += ")";
+
+	size_t col_count = 0;
+	size_t allocated_rows = 0;
+	int rows_fetched = 0; 
+	size_t time_read = 0;
+	
+	SqlCol *cols = NULL;
+
+	fingerprint.clear();
+
+	// Open cursor allocating 1 row buffer
+	int rc = OpenCursor(query.c_str(), 1, 0, &col_count, &allocated_rows, &rows_fetched, &cols, &time_read);
+
+	if(rc >= 0 && rows_fetched > 0 && col_count == 2)
+	{
+		if(cols[0]._ind2[0] != -1)
+			fingerprint.assign(cols[0]._data, (size_t)cols[0]._len_ind2[0]);
+
+		fingerprint += ';';
+
+		if(cols[1]._ind2[0] != -1)
+			fingerprint.append(cols[1]._data, (size_t)cols[1]._len_ind2[0]);
+	}
+
+	CloseCursor();
+
+	if(rc < 0)
+	{
+		fingerprint.clear();
+		return -1;
+	}
+
+	TRACE_P("OCI ReadSchema() Catalog fingerprint %s", fingerprint.c_str());
+	return 0;
+}
+
+// Get tables (SCHEMA.TABLE) with table or index DDL time equal or later than the specified time
+int SqlOciApi::GetChangedTables(const char *select, const char *exclude, const char *since, std::list<std::string> &tables)
+{
+	if(since == NULL)
+		return -1;
+
+	std::string objects;
+	GetCatalogObjectsQuery(select, exclude, objects);
+
+	std::string query = "SELECT DISTINCT owner, table_name FROM (";
+	query += objects;
+	query += ") WHERE last_ddl_time >= TO_DATE('";
+	query += since;
+	query += "', 'YYYY-MM-DD HH24:MI:SS')";
+
+	size_t col_count = 0;
+	size_t allocated_rows = 0;
+	int rows_fetched = 0; 
+	size_t time_read = 0;
+	
+	SqlCol *cols = NULL;
+
+	// Open cursor allocating 100 rows buffer
+	int rc = OpenCursor(query.c_str(), 100, 0, &col_count, &allocated_rows, &rows_fetched, &cols, &time_read);
+
+	if(rc < 0)
+	{
+		CloseCursor();
+		return -1;
+	}
+
+	while(rc >= 0)
+	{
+		for(int i = 0; i < rows_fetched; i++)
+		{
+			if(cols[0]._ind2[i] == -1 || cols[1]._ind2[i] == -1)
+				continue;
+
+			std::string name(cols[0]._data + cols[0]._fetch_len * i, (size_t)cols[0]._len_ind2[i]);
+			name += '.';
+			name.append(cols[1]._data + cols[1]._fetch_len * i, (size_t)cols[1]._len_ind2[i]);
+
+			tables.push_back(name);
+		}
+
+		// No more rows
+		if(rc == 100)
+			break;
+
+		rc = Fetch(&rows_fetched, &time_read);
+	}
+
+	CloseCursor();
+
+	return 0;
+}
+
+// Build WHERE clauses to select rows from catalog views having owner and table_owner columns
+void SqlOciApi::GetSchemaSelection(const char *select, const char *exclude, std::string &selection, std::string &selection2)
+{
 	GetSelectionCriteria(select, exclude, "owner", "table_name", selection, _user.c_str(), true);
 	GetSelectionCriteria(select, exclude, "table_owner", "table_name", selection2, _user.c_str(), true);
 
@@ -1060,27 +1544,352 @@ int SqlOciApi::ReadSchema(const char *select, const char *exclude, bool read_cns
 		selection2 += " 'SYSTEM','XDB')";
 		selection2 += " AND table_owner NOT LIKE 'APEX%'";
 	}
+}
+
+// Read catalog for the specified selection using one or more sessions
+int SqlOciApi::ReadSchemaBatch(const char *select, const char *exclude, bool read_cns, bool read_idx, bool read_seq)
+{
+	std::string selection;
+	std::string selection2;
+
+	GetSchemaSelection(select, exclude, selection, selection2);
+
+	// Catalog queries do not depend on each other, so they can be executed in any order and in any session
+	std::vector<int> steps;
 
-	int rc = ReadTableColumns(selection);
-	rc = ReadComments(selection);
+	steps.push_back(SQLOCI_META_COLUMNS);
+	steps.push_back(SQLOCI_META_COMMENTS);
 
 	if(read_cns)
 	{
-		rc = ReadTableConstraints(selection, "'P', 'U', 'R', 'C'");
-		rc = ReadConstraintColumns(selection);
+		steps.push_back(SQLOCI_META_CONSTRAINTS);
+		steps.push_back(SQLOCI_META_CONS_COLUMNS);
 	}
 
 	if(read_idx)
+	{
+		steps.push_back(SQLOCI_META_INDEXES);
+		steps.push_back(SQLOCI_META_IND_COLUMNS);
+		steps.push_back(SQLOCI_META_IND_EXPRESSIONS);
+	}
+
+	if(read_seq)
+		steps.push_back(SQLOCI_META_SEQUENCES);
+
+	size_t sessions = (_meta_sessions > 1) ? (size_t)_meta_sessions : 1;
+
+	if(sessions > steps.size())
+		sessions = steps.size();
+
+	// Additional sessions (the current session is not included) are opened by the first batch
+	size_t opened = OpenMetaSessions(sessions - 1);
+
+	std::vector<SqlOciMetaSession> meta(opened);
+
+	for(size_t i = 0; i < opened; i++)
+	{
+		meta[i].api = _meta_apis[i];
+		meta[i].selection = &selection;
+		meta[i].selection2 = &selection2;
+		meta[i].rc = 0;
+		meta[i]._started = false;
+	}
+
+	std::vector<int> own_steps;
+
+	// Distribute catalog queries between the current and additional sessions
+	for(size_t i = 0; i < steps.size(); i++)
+	{
+		size_t session = i % (opened + 1);
+
+		if(session == 0)
+			own_steps.push_back(steps[i]);
+		else
+			meta[session - 1].steps.push_back(steps[i]);
+	}
+
+	// Start threads for additional sessions
+	for(size_t i = 0; i < opened; i++)
+	{
+#if defined(WIN32) || defined(_WIN64)
+		meta[i]._thread = (HANDLE)_beginthreadex(NULL, 0, &SqlOciApi::StartMetaSessionS, &meta[i], 0, NULL);
+		meta[i]._started = (meta[i]._thread != 0);
+#else
+		meta[i]._started = (pthread_create(&meta[i]._thread, NULL, &SqlOciApi::StartMetaSessionS, &meta[i]) == 0);
+#endif
+		// Execute the queries in the current thread if the thread cannot be started
+		if(meta[i]._started == false)
+			StartMetaSessionS(&meta[i]);
+	}
+
+	int rc = 0;
+	int seq_rc = 0;
+
+	// Execute remaining queries in the current session
+	for(std::vector<int>::iterator i = own_steps.begin(); i != own_steps.end(); i++)
+	{
+		rc = ReadSchemaStep(*i, selection, selection2);
+
+		if(*i == SQLOCI_META_SEQUENCES)
+			seq_rc = rc;
+	}
+
+	// Wait for additional sessions and take their rows
+	for(size_t i = 0; i < opened; i++)
+	{
+		if(meta[i]._started == true)
+		{
+#if defined(WIN32) || defined(_WIN64)
+			WaitForSingleObject(meta[i]._thread, INFINITE);
+			CloseHandle(meta[i]._thread);
+#else
+			pthread_join(meta[i]._thread, NULL);
+#endif
+		}
+
+		if(meta[i].steps.back() == SQLOCI_META_SEQUENCES)
+			seq_rc = meta[i].rc;
+
+		MoveSchema(meta[i].api);
+	}
+
+	return seq_rc;
+}
+
+// Open additional catalog sessions up to the specified number, returns the number of open sessions
+size_t SqlOciApi::OpenMetaSessions(size_t count)
+{
+	while(_meta_apis.size() < count)
+	{
+		SqlOciApi *api = new SqlOciApi();
+
+		api->_user = _user;
+		api->_pwd = _pwd;
+		api->_db = _db;
+
+		api->SetParameters(_parameters);
+		api->SetAppLog(_log);
+
+		int rc = api->Init();
+
+		if(rc != -1)
+			rc = api->Connect(NULL);
+
+		// Continue with already opened sessions
+		if(api->_connected == false)
+		{
+			TRACE_P("OCI ReadSchema() Failed to open catalog session: %s", api->GetNativeErrorText());
+
+			delete api;
+			break;
+		}
+
+		_meta_apis.push_back(api);
+	}
+
+	return (_meta_apis.size() < count) ? _meta_apis.size() : count;
+}
+
+// Close additional catalog sessions
+void SqlOciApi::CloseMetaSessions()
+{
+	for(std::vector<SqlOciApi*>::iterator i = _meta_apis.begin(); i != _meta_apis.end(); i++)
+	{
+		(*i)->Deallocate();
+		delete (*i);
+	}
+
+	_meta_apis.clear();
+}
+
+// Execute a catalog query and log its execution time
+int SqlOciApi::ReadSchemaStep(int step, std::string &selection, std::string &selection2)
+{
+	size_t start = Os::GetTickCount();
+	int rc = 0;
+
+	const char *name = NULL;
+	size_t rows = 0;
+
+	if(step == SQLOCI_META_COLUMNS)
+	{
+		rc = ReadTableColumns(selection);
+		name = "columns";
+		rows = _table_columns.size();
+	}
+	else
+	if(step == SQLOCI_META_COMMENTS)
+	{
+		rc = ReadComments(selection);
+		name = "comments";
+		rows = _table_comments.size();
+	}
+	else
+	if(step == SQLOCI_META_CONSTRAINTS)
+	{
+		rc = ReadTableConstraints(selection, "'P', 'U', 'R', 'C'");
+		name = "constraints";
+		rows = _table_constraints.size();
+	}
+	else
+	if(step == SQLOCI_META_CONS_COLUMNS)
+	{
+		rc = ReadConstraintColumns(selection);
+		name = "constraint columns";
+		rows = _table_cons_columns.size();
+	}
+	else
+	if(step == SQLOCI_META_INDEXES)
 	{
 		rc = ReadIndexes(selection2);
+		name = "indexes";
+		rows = _table_indexes.size();
+	}
+	else
+	if(step == SQLOCI_META_IND_COLUMNS)
+	{
 		rc = ReadIndColumns(selection2);
+		name = "index columns";
+		rows = _table_ind_columns.size();
+	}
+	else
+	if(step == SQLOCI_META_IND_EXPRESSIONS)
+	{
 		rc = ReadIndExpressions(selection2);
+		name = "index expressions";
+		rows = _table_ind_expressions.size();
 	}
+	else
+	if(step == SQLOCI_META_SEQUENCES)
+	{
+		rc = ReadSequences(selection);
+		name = "sequences";
+		rows = _sequences.size();
+	}
+
+	if(name != NULL)
+		TRACE_P("OCI ReadSchema() Read %d %s in %d ms (rc %d)", (int)rows, name, (int)(Os::GetTickCount() - start), rc);
 
-	rc = ReadSequences(selection); 
 	return rc;
 }
 
+// Move catalog rows read by another session
+void SqlOciApi::MoveSchema(SqlOciApi *api)
+{
+	if(api == NULL)
+		return;
+
+	// Each query fills its own list, so the order of rows is the same as if the query is executed in this session
+	_table_columns.splice(_table_columns.end(), api->_table_columns);
+	_table_comments.splice(_table_comments.end(), api->_table_comments);
+	_table_constraints.splice(_table_constraints.end(), api->_table_constraints);
+	_table_cons_columns.splice(_table_cons_columns.end(), api->_table_cons_columns);
+	_table_indexes.splice(_table_indexes.end(), api->_table_indexes);
+	_table_ind_columns.splice(_table_ind_columns.end(), api->_table_ind_columns);
+	_table_ind_expressions.splice(_table_ind_expressions.end(), api->_table_ind_expressions);
+	_sequences.splice(_sequences.end(), api->_sequences);
+
+	// Rows were moved out of the other session's lists
+	ClearCatalogIndex();
+	api->ClearCatalogIndex();
+}
+
+// Split the selection list into batches containing the specified number of schemas
+void SqlOciApi::GetSchemaBatches(const char *select, int batch, std::list<std::string> &batches)
+{
+	if(select == NULL || batch <= 0)
+		return;
+
+	std::list<std::string> schemas;
+	std::map<std::string, std::string> items;
+
+	const char *cur = select;
+
+	// Group selection items by schema, so the same table cannot be read in different batches
+	while(true)
+	{
+		std::string item;
+
+		cur = Str::GetNextInList(cur, item);
+
+		if(item.empty() == true)
+			break;
+
+		const char *dot = strchr(item.c_str(), '.');
+		std::string schema = (dot != NULL) ? std::string(item.c_str(), (size_t)(dot - item.c_str())) : _user;
+
+		// Schema templates can match any schema, do not use batches
+		if(strchr(schema.c_str(), '*') != NULL)
+			return;
+
+		std::transform(schema.begin(), schema.end(), schema.begin(), ::toupper);
+
+		std::map<std::string, std::string>::iterator i = items.find(schema);
+
+		if(i == items.end())
+		{
+			schemas.push_back(schema);
+			items[schema] = item;
+		}
+		else
+		{
+			i->second += ", ";
+			i->second += item;
+		}
+	}
+
+	// All schemas fit one batch
+	if(schemas.size() <= (size_t)batch)
+		return;
+
+	std::string list;
+	int count = 0;
+
+	for(std::list<std::string>::iterator i = schemas.begin(); i != schemas.end(); i++)
+	{
+		if(list.empty() == false)
+			list += ", ";
+
+		list += items[*i];
+		count++;
+
+		if(count == batch)
+		{
+			batches.push_back(list);
+
+			list.clear();
+			count = 0;
+		}
+	}
+
+	if(list.empty() == false)
+		batches.push_back(list);
+}
+
+// Execute catalog queries in an additional session
+#if defined(WIN32) || defined(_WIN64)
+unsigned int __stdcall SqlOciApi::StartMetaSessionS(void *object)
+{
+	if(object == NULL)
+		return (unsigned int)-1;
+#else
+void* SqlOciApi::StartMetaSessionS(void *object)
+{
+	if(object == NULL)
+		return NULL;
+#endif
+	SqlOciMetaSession *meta = (SqlOciMetaSession*)object;
+
+	for(std::vector<int>::iterator i = meta->steps.begin(); i != meta->steps.end(); i++)
+		meta->rc = meta->api->ReadSchemaStep(*i, *meta->selection, *meta->selection2);
+
+#if defined(WIN32) || defined(_WIN64)
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
 // Read schema when Oracle is the target database for transfer
 int SqlOciApi::ReadSchemaForTransferTo(const char * /*select*/, const char * /*exclude*/)
 {
@@ -2008,12 +2817,20 @@ int SqlOciApi::GetKeyConstraintColumns(SqlConstraints &cns, std::list<std::strin
 	if(cns.schema == NULL || cns.table == NULL || cns.constraint == NULL)
 		return -1;
 
-	for(std::list<SqlConsColumns>::iterator i = _table_cons_columns.begin(); i != _table_cons_columns.end(); i++)
+	std::vector<SqlConsColumns*> *cns_columns = GetCatalogConstraintColumns(cns.schema, cns.constraint);
+
+	if(cns_columns == NULL)
+		return 0;
+
+	// Columns of the constraint table to find data types
+	SqlTableCatalog *catalog = (types != NULL) ? GetCatalogTable(cns.schema, cns.table) : NULL;
+
+	for(std::vector<SqlConsColumns*>::iterator i = cns_columns->begin(); i != cns_columns->end(); i++)
 	{
-		char *s = (*i).schema;
-		char *t = (*i).table;
-		char *c = (*i).constraint;
-		char *col = (*i).column;
+		char *s = (*i)->schema;
+		char *t = (*i)->table;
+		char *c = (*i)->constraint;
+		char *col = (*i)->column;
 
 		if(s == NULL || t == NULL || c == NULL || col == NULL)
 			continue;
@@ -2025,14 +2842,14 @@ int SqlOciApi::GetKeyConstraintColumns(SqlConstraints &cns, std::list<std::strin
 			found = true;
 
 			// Find data type
-			if(types != NULL)
+			if(types != NULL && catalog != NULL)
 			{
-				for(std::list<SqlColMeta>::iterator m = _table_columns.begin(); m != _table_columns.end(); m++)
+				for(std::vector<SqlColMeta*>::iterator m = catalog->columns.begin(); m != catalog->columns.end(); m++)
 				{
-					char *cs = (*m).schema;
-					char *ct = (*m).table;
-					char *ccol = (*m).column;
-					char *dt = (*m).data_type;
+					char *cs = (*m)->schema;
+					char *ct = (*m)->table;
+					char *ccol = (*m)->column;
+					char *dt = (*m)->data_type;
 
 					if(cs == NULL || ct == NULL || ccol == NULL || dt == NULL)
 						break;
@@ -2062,18 +2879,25 @@ int SqlOciApi::GetIndexColumns(SqlIndexes &idx, std::list<std::string> &idx_cols
 {
 	int c = 0;
 
+	std::vector<SqlIndColumns*> *ind_columns = GetCatalogIndexColumns(idx.schema, idx.index);
+
+	if(ind_columns == NULL)
+		return 0;
+
 	// Find index columns
-	for(std::list<SqlIndColumns>::iterator i = _table_ind_columns.begin(); i != _table_ind_columns.end(); i++)
+	for(std::vector<SqlIndColumns*>::iterator m = ind_columns->begin(); m != ind_columns->end(); m++)
 	{
+		SqlIndColumns *i = *m;
+
 		// Compare schema and index names (columns are already ordered)
-		if((*i).schema != NULL && strcmp((*i).schema, idx.schema) == 0 &&
-			(*i).index != NULL && strcmp((*i).index, idx.index) == 0)
+		if(i->schema != NULL && strcmp(i->schema, idx.schema) == 0 &&
+			i->index != NULL && strcmp(i->index, idx.index) == 0)
 		{
 			std::string column;
 			std::string sort;
 
 			// For DESC columns Oracle uses an expression, find the real column name
-			if((*i).asc == false && strncmp((*i).column, "SYS_NC0", 7) == 0)
+			if(i->asc == false && strncmp(i->column, "SYS_NC0", 7) == 0)
 			{
 				int p = 0;
 				
@@ -2103,9 +2927,9 @@ int SqlOciApi::GetIndexColumns(SqlIndexes &idx, std::list<std::string> &idx_cols
 				}
 			}
 			else
-				column = (*i).column;
+				column = i->column;
 
-			if((*i).asc == false)
+			if(i->asc == false)
 				sort = "DESC";
 
 			idx_cols.push_back(column);
@@ -2177,13 +3001,18 @@ int SqlOciApi::GetComment(const char *table, const char *column, std::string &co
 
 	SplitQualifiedName(table, schema, object);
 
+	SqlTableCatalog *catalog = GetCatalogTable(schema.c_str(), object.c_str());
+
+	if(catalog == NULL)
+		return 0;
+
 	// Find table columns (already ordered by column number)
-	for(std::list<SqlComments>::iterator i = _table_comments.begin(); i != _table_comments.end(); i++)
+	for(std::vector<SqlComments*>::iterator i = catalog->comments.begin(); i != catalog->comments.end(); i++)
 	{
-		char *s = (*i).schema;
-		char *t = (*i).table;
-		char *c = (*i).column;
-		char *cm = (*i).comment;
+		char *s = (*i)->schema;
+		char *t = (*i)->table;
+		char *c = (*i)->column;
+		char *cm = (*i)->comment;
 		
 		// Table found
 		if(s != NULL && t != NULL && strcmp(s, schema.c_str()) == 0 && strcmp(t, object.c_str()) == 0)
@@ -2196,7 +3025,7 @@ int SqlOciApi::GetComment(const char *table, const char *column, std::string &co
 			}
 			else
 			// Table comment
-			if(column == NULL && c == NULL && cm != NULL && (*i).type == 'T')
+			if(column == NULL && c == NULL && cm != NULL && (*i)->type == 'T')
 			{
 				comment = cm;
 				break;
@@ -2705,6 +3534,50 @@ int SqlOciApi::InitBulkTransfer(const char *table, size_t col_count, size_t allo
 	return rc;
 }
 
+// Rebind source buffers bound in InitBulkTransfer to the specified buffers
+int SqlOciApi::SetTransferBuffers(SqlCol *s_cols)
+{
+	if(s_cols == NULL || _ins_cols == NULL || _stmtp_insert == NULL || _ociBindByPos == NULL)
+		return -1;
+
+	TRACE("OCI SetTransferBuffers() Entered");
+
+	int rc = 0;
+
+	for(size_t i = 0; i < _ins_cols_count; i++)
+	{
+		// Target buffer is allocated for converted data or LOB locator, source data are not bound
+		if(_ins_cols[i]._data != NULL)
+			continue;
+
+		short *ind = (_source_api_type != SQLDATA_SYBASE) ? _ins_cols[i]._ind2 : s_cols[i]._ind2;
+
+		OCIBind *bindpp = NULL;
+
+		rc = _ociBindByPos(_stmtp_insert, &bindpp, _errhp, (ub4)(i + 1), s_cols[i]._data, (sb4)_ins_cols[i]._fetch_len, 
+				(ub2)_ins_cols[i]._native_dt, ind, (ub2*)_ins_cols[i]._len_ind2, NULL, 0, NULL, OCI_DEFAULT);
+
+		// Data extracted in UTF-16
+		if(rc != -1 && _ins_cols[i]._nchar)
+		{
+			ub1 cform = SQLCS_NCHAR;
+			ub2 csid = OCI_UTF16ID;
+
+			rc = _ociAttrSet(bindpp, OCI_HTYPE_BIND, (void*)&cform, 0, OCI_ATTR_CHARSET_FORM, _errhp);
+			rc = _ociAttrSet(bindpp, OCI_HTYPE_BIND, (void *)&csid, 0, OCI_ATTR_CHARSET_ID, _errhp);
+		}
+
+		if(rc == -1)
+		{
+			SetError();
+			break;
+		}
+	}
+
+	TRACE("OCI SetTransferBuffers() Left");
+	return rc;
+}
+
 // Transfer rows between databases
 int SqlOciApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written, size_t *bytes_written,
 							size_t *time_spent)
@@ -21,6 +21,8 @@
 
 #if defined(WIN32) || defined(_WIN64)
 #include <windows.h>
+#else
+#include <pthread.h>
 #endif
 
 #include <oci.h>
@@ -40,6 +42,7 @@
 typedef sword (*OCIArrayDescriptorAllocFunc)(void *, void **, ub4, ub4, size_t, void **);
 typedef sword (*OCIAttrGetFunc)(void *, ub4, void *, ub4 *, ub4, OCIError *);
 typedef sword (*OCIAttrSetFunc)(void *, ub4, void *, ub4, ub4, OCIError *);
+typedef sword (*OCIBreakFunc)(void *hndlp, OCIError *errhp);
 typedef sword (*OCIBindByPosFunc)(OCIStmt *stmtp, OCIBind **bindpp, OCIError *errhp, ub4 position, dvoid *valuep, sb4 value_sz, ub2 dty, dvoid *indp, ub2 *alenp, ub2 *rcodep, ub4 maxarr_len, ub4 *curelep, ub4 mode);
 typedef sword (*OCIDefineByPosFunc)(OCIStmt *, OCIDefine **, OCIError *, ub4, dvoid *, sb4, ub2, dvoid *, ub2 *, ub2 *, ub4);
 typedef sword (*OCIDescriptorAllocFunc)(void *, void **, ub4, size_t, void **);
@@ -58,6 +61,7 @@ typedef sword (*OCILobTrimFunc)(OCISvcCtx *, OCIError *, OCILobLocator *, ub4 ne
 typedef sword (*OCILobWriteFunc)(OCISvcCtx *, OCIError *, OCILobLocator *, ub4 *amtp, ub4 offset, dvoid *bufp, ub4 buflen, ub1 piece, dvoid *ctxp, OCICallbackLobWrite (cbfp)(dvoid *, dvoid *, ub4 *, ub1 *), ub2 csid, ub1 csfrm);
 typedef sword (*OCILobWriteAppendFunc)(OCISvcCtx *, OCIError *, OCILobLocator *locp, ub4 *amtp, dvoid *bufp, ub4 buflen, ub1 piece, dvoid *ctxp, OCICallbackLobWrite(cbfp)(dvoid *, dvoid *, ub4 *, ub1 *), ub2 csid, ub1 csfrm);
 typedef sword (*OCIParamGetFunc)(const void *hndlp, ub4, OCIError *, void **, ub4);
+typedef sword (*OCIResetFunc)(void *hndlp, OCIError *errhp);
 typedef sword (*OCIServerAttachFunc)(OCIServer *, OCIError *, const OraText *, sb4, ub4);
 typedef sword (*OCIServerDetachFunc)(OCIServer *srvhp, OCIError *errhp, ub4 mode);
 typedef sword (*OCISessionBeginFunc)(OCISvcCtx *, OCIError *, OCISession *, ub4, ub4);
@@ -67,6 +71,41 @@ typedef sword (*OCIStmtFetch2Func)(OCIStmt *, OCIError *, ub4, ub2, sb4, ub4);
 typedef sword (*OCIStmtPrepareFunc)(OCIStmt *, OCIError *, CONST text *, ub4, ub4, ub4);
 typedef sword (*OCITransCommitFunc)(OCISvcCtx *svchp, OCIError *errhp, ub4 flags);
 
+// Catalog queries executed by ReadSchema
+#define SQLOCI_META_COLUMNS				1
+#define SQLOCI_META_COMMENTS			2
+#define SQLOCI_META_CONSTRAINTS			3
+#define SQLOCI_META_CONS_COLUMNS		4
+#define SQLOCI_META_INDEXES				5
+#define SQLOCI_META_IND_COLUMNS			6
+#define SQLOCI_META_IND_EXPRESSIONS		7
+#define SQLOCI_META_SEQUENCES			8
+
+// Maximum number of changed tables refreshed in the metadata snapshot, otherwise the entire catalog is read
+#define SQLOCI_META_CACHE_MAX_CHANGED	500
+
+class SqlOciApi;
+
+// Catalog queries executed in a separate session
+struct SqlOciMetaSession
+{
+	SqlOciApi *api;
+	std::vector<int> steps;
+
+	std::string *selection;
+	std::string *selection2;
+
+	int rc;
+
+	// Thread executing the queries, it is joined before the rows are taken
+	bool _started;
+#if defined(WIN32) || defined(_WIN64)
+	HANDLE _thread;
+#else
+	pthread_t _thread;
+#endif
+};
+
 class SqlOciApi : public SqlApiBase
 {
 	// OCI DLL handle
@@ -96,6 +135,21 @@ class SqlOciApi : public SqlApiBase
 	// Whether to bind LONG in place without using locators (used in metadata read of short LONG columns)
 	size_t _bind_long_inplace;
 
+	// Number of bytes of LOB data prefetched with the row (Oracle 11g), 0 if LOB prefetch is disabled
+	int _lob_prefetch_size;
+
+	// LOB currently read by parts (row and column), and whether more pieces remain 
+	size_t _lob_part_row;
+	size_t _lob_part_column;
+	bool _lob_part_more;
+
+	// Number of sessions to read the catalog concurrently, and number of schemas read by one set of catalog queries
+	int _meta_sessions;
+	int _meta_schema_batch;
+
+	// Additional catalog sessions, opened once for all schema batches of ReadSchema
+	std::vector<SqlOciApi*> _meta_apis;
+
 public:
 	SqlOciApi();
 
@@ -149,6 +203,15 @@ public:
 	// OCI bounds the source buffers, so the same buffers must be passed to TransferRows
 	virtual bool IsDataBufferBound() { return true; }
 
+	// Defines and binds can be redone to buffers allocated by the caller
+	virtual bool IsBufferExchangeSupported() { return true; }
+	// Fetch next rows into the specified buffers
+	virtual int SetFetchBuffers(SqlCol *cols);
+	// Set the number of rows for next fetches
+	virtual int SetFetchRows(size_t rows);
+	// Rebind source buffers bound in InitBulkTransfer to the specified buffers
+	virtual int SetTransferBuffers(SqlCol *s_cols);
+
 	// Get the maximum size of a character in the client character set in bytes (4 for UTF-8)
 	virtual int GetCharMaxSizeInBytes();
 
@@ -170,7 +233,10 @@ public:
 	// Get LOB content
 	virtual int GetLobContent(size_t row, size_t column, void *data, size_t length, int *len_ind);
 	// Get partial LOB content
-	virtual int GetLobPart(size_t /*row*/, size_t /*column*/, void * /*data*/, size_t /*length*/, int * /*len_ind*/) { return -1; }
+	virtual int GetLobPart(size_t row, size_t column, void *data, size_t length, int *len_ind);
+	virtual bool IsLobPartReadSupported() { return true; }
+	// Stop reading the LOB by parts before all pieces are read
+	void CancelLobPart();
 
 	// Get the list of available tables
 	virtual int GetAvailableTables(std::string &select, std::string &exclude, std::list<std::string> &tables);
@@ -220,6 +286,34 @@ private:
 	int ReadSequences(std::string &selection);
 	int ReadReservedWords();
 
+	// Build WHERE clauses to select rows from catalog
+	void GetSchemaSelection(const char *select, const char *exclude, std::string &selection, std::string &selection2);
+	// Read catalog for the specified selection using one or more sessions
+	int ReadSchemaBatch(const char *select, const char *exclude, bool read_cns, bool read_idx, bool read_seq);
+	// Execute a catalog query and log its execution time
+	int ReadSchemaStep(int step, std::string &selection, std::string &selection2);
+	// Move catalog rows read by another session
+	void MoveSchema(SqlOciApi *api);
+	// Open additional catalog sessions up to the specified number, returns the number of open sessions
+	size_t OpenMetaSessions(size_t count);
+	void CloseMetaSessions();
+	// Load the metadata snapshot, and refresh tables changed after the snapshot was taken
+	int ReadSchemaCache(const char *file, std::string &key, std::string &fingerprint, const char *select, 
+		const char *exclude, bool read_cns, bool read_idx);
+	void GetSchemaCacheKey(const char *select, const char *exclude, bool read_cns, bool read_idx, std::string &key);
+	// Get the catalog fingerprint and tables changed since the specified DDL time
+	void GetCatalogObjectsQuery(const char *select, const char *exclude, std::string &query);
+	int GetCatalogFingerprint(const char *select, const char *exclude, std::string &fingerprint);
+	int GetChangedTables(const char *select, const char *exclude, const char *since, std::list<std::string> &tables);
+	// Split the selection list into batches containing the specified number of schemas
+	void GetSchemaBatches(const char *select, int batch, std::list<std::string> &batches);
+
+#if defined(WIN32) || defined(_WIN64)
+	static unsigned int __stdcall StartMetaSessionS(void *object);
+#else
+	static void* StartMetaSessionS(void *object);
+#endif
+
     int InitSession();
 	// Set session attributes
 	int SetSession();
@@ -231,6 +325,7 @@ private:
 	OCIAttrGetFunc _ociAttrGet;
 	OCIAttrSetFunc _ociAttrSet;
 	OCIBindByPosFunc _ociBindByPos;
+	OCIBreakFunc _ociBreak;
 	OCIDescriptorAllocFunc _ociDescriptorAlloc;
 	OCIDescriptorFreeFunc _ociDescriptorFree;
 	OCIDefineByPosFunc _ociDefineByPos;
@@ -249,6 +344,7 @@ private:
 	OCILobWriteFunc _ociLobWrite;
 	OCILobWriteAppendFunc _ociLobWriteAppend;
 	OCIParamGetFunc _ociParamGet;
+	OCIResetFunc _ociReset;
 	OCIServerAttachFunc _ociServerAttach;
 	OCIServerDetachFunc _ociServerDetach;
 	OCISessionBeginFunc _ociSessionBegin;
@@ -118,6 +118,13 @@ void SqlOdbcApi::SetOracleConnectionString(const char *conn)
 // Connect to the database
 int SqlOdbcApi::Connect(size_t * /*time_spent*/)
 {
+	// Check if already connected
+	if(_connected == true)
+		return 0;
+
+	// Free handles left by a previous failed attempt
+	Deallocate();
+
 	// Allocate environment handle
 	int rc = SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &_henv);
 
@@ -439,6 +446,7 @@ int SqlOdbcApi::CloseCursor()
 	int rc = SQLFreeHandle(SQL_HANDLE_STMT, _hstmt_cursor);
 
 	_hstmt_cursor = SQL_NULL_HANDLE;
+	_cursor_fetch_rows = 0;
 
 	if(_cursor_cols == NULL)
 		return 0;
@@ -493,6 +501,51 @@ bool SqlOdbcApi::CanParallelReadWrite()
 	return true;
 }
 
+// Set the number of rows for next fetches (rowset size can be changed between fetches)
+int SqlOdbcApi::SetFetchRows(size_t rows)
+{
+	if(rows == 0 || rows > _cursor_allocated_rows)
+		return -1;
+
+	if(rows == _cursor_fetch_rows)
+		return 0;
+
+	int rc = SQLSetStmtAttr(_hstmt_cursor, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)rows, 0);
+
+	if(rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO)
+		return -1;
+
+	_cursor_fetch_rows = rows;
+	return 0;
+}
+
+// Fetch next rows into the specified buffers
+int SqlOdbcApi::SetFetchBuffers(SqlCol *cols)
+{
+	if(cols == NULL || _cursor_cols == NULL || _cursor_lob_exists == true)
+		return -1;
+
+	int rc = 0;
+
+	// Rebind only columns bound in OpenCursor, the type and length remain the same
+	for(size_t i = 0; i < _cursor_cols_count; i++)
+	{
+		if(_cursor_cols[i]._data == NULL)
+			continue;
+
+		rc = SQLBindCol(_hstmt_cursor, (SQLUSMALLINT)(i + 1), (SQLSMALLINT)_cursor_cols[i]._native_fetch_dt, cols[i]._data, (SQLLEN)_cursor_cols[i]._fetch_len,
+							(SQLLEN*)cols[i].ind);
+
+		if(rc == -1)
+		{
+			SetError(SQL_HANDLE_STMT, _hstmt_cursor);
+			break;
+		}
+	}
+
+	return rc;
+}
+
 // Drop the table
 int SqlOdbcApi::DropTable(const char* /*table*/, size_t * /*time_spent*/, std::string & /*drop_stmt*/)
 {
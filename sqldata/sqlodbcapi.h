@@ -101,6 +101,13 @@ public:
 	// Specifies whether API allows to parallel reading from this API and write to another API
 	virtual bool CanParallelReadWrite();
 
+	// Columns can be rebound to buffers allocated by the caller
+	virtual bool IsBufferExchangeSupported() { return true; }
+	// Fetch next rows into the specified buffers
+	virtual int SetFetchBuffers(SqlCol *cols);
+	// Set the number of rows for next fetches
+	virtual int SetFetchRows(size_t rows);
+
 	// Complete bulk transfer
 	virtual int CloseBulkTransfer();
 
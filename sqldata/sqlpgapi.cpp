@@ -22,6 +22,9 @@ SqlPgApi::SqlPgApi()
 
 	_copy_cols_count = 0;
 	_copy_data = NULL;
+	_copy_lob_data = NULL;
+	_copy_conv_data = NULL;
+	_copy_conv_len = NULL;
 
 	_conn = NULL;
 	_dll = NULL;
@@ -538,7 +541,7 @@ int SqlPgApi::CloseCursor()
 }
 
 // Initialize the bulk copy from one database into another
-int SqlPgApi::InitBulkTransfer(const char *table, size_t col_count, size_t /*allocated_array_rows*/, SqlCol * /*s_cols*/, SqlCol ** /*t_cols*/)
+int SqlPgApi::InitBulkTransfer(const char *table, size_t col_count, size_t allocated_array_rows, SqlCol *s_cols, SqlCol ** /*t_cols*/)
 {
 	std::string command = "COPY ";
 	command += table;
@@ -557,6 +560,45 @@ int SqlPgApi::InitBulkTransfer(const char *table, size_t col_count, size_t /*all
 
 	_copy_data = new char[LIBPQ_COPY_DATA_BUFFER_LEN];
 
+	// Allocate a buffer to stream LOB values by parts if the source API supports it
+	if(s_cols != NULL && _source_api_provider != NULL && _source_api_provider->IsLobPartReadSupported())
+	{
+		for(size_t i = 0; i < col_count; i++)
+		{
+			if(s_cols[i]._lob)
+			{
+				_copy_lob_data = new char[_lob_chunk_size];
+				break;
+			}
+		}
+	}
+
+	// Allocate buffers to convert date and timestamp columns for the whole batch
+	if(s_cols != NULL)
+	{
+		_copy_conv_data = new char*[col_count];
+		_copy_conv_len = new int[col_count];
+
+		for(size_t i = 0; i < col_count; i++)
+		{
+			_copy_conv_data[i] = NULL;
+			_copy_conv_len[i] = 0;
+
+			// Oracle DATE fetched as 7 byte binary sequence
+			if(_source_api_type == SQLDATA_ORACLE && s_cols[i]._native_fetch_dt == SQLT_DAT)
+				_copy_conv_len[i] = SQLDATA_ORA_DATE_STR_LEN;
+			else
+			// ODBC TIMESTAMP fetched as SQL_TIMESTAMP_STRUCT
+			if((_source_api_type == SQLDATA_SQL_SERVER || _source_api_type == SQLDATA_INFORMIX || 
+				_source_api_type == SQLDATA_ASA || _source_api_type == SQLDATA_ODBC) && 
+				s_cols[i]._native_fetch_dt == SQL_C_TYPE_TIMESTAMP)
+				_copy_conv_len[i] = SQLDATA_ODBC_TS_STR_LEN;
+
+			if(_copy_conv_len[i] != 0)
+				_copy_conv_data[i] = new char[allocated_array_rows * _copy_conv_len[i] + 1];
+		}
+	}
+
 	_PQclear(result);
 		
 	return 0;
@@ -574,9 +616,27 @@ int SqlPgApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written,
 	int rc = 0;
 	size_t bytes = 0;
 
+	_transfer_send_time = 0;
+
 	char *cur = _copy_data;
 	int remain_len = LIBPQ_COPY_DATA_BUFFER_LEN;
 
+	bool lob_failed = false;
+
+	// Convert date and timestamp columns for all rows at once
+	for(size_t k = 0; _copy_conv_data != NULL && k < _copy_cols_count; k++)
+	{
+		if(_copy_conv_data[k] == NULL)
+			continue;
+
+		if(_copy_conv_len[k] == SQLDATA_ORA_DATE_STR_LEN)
+			OraDatesToStr(&s_cols[k], (size_t)rows_fetched, _copy_conv_data[k]);
+		else
+			// Sybase ASA 9 stores 6-digit fraction multiplied by 1000, i.e. 123456 stored as 123456000
+			OdbcTimestampsToStr(&s_cols[k], (size_t)rows_fetched, (_source_api_type == SQLDATA_ASA) ? 1000 : 1, true, 
+				_copy_conv_data[k]);
+	}
+
 	// Copy rows
 	for(size_t i = 0; i < rows_fetched; i++)
 	{
@@ -585,6 +645,7 @@ int SqlPgApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written,
 		{
 			int len = -1;
 			char *lob_data = NULL;
+			bool lob_stream = false;
 
 			// Check whether column is null
 			if(_source_api_type == SQLDATA_ORACLE && s_cols[k]._ind2 != NULL)
@@ -607,6 +668,10 @@ int SqlPgApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written,
 						if(lob_rc != -1)
 							len = (int)lob_size;
 
+						// Value will be streamed by parts using the chunk buffer 
+						if(lob_rc != -1 && lob_size > 0 && _copy_lob_data != NULL)
+							lob_stream = true;
+						else
 						if(lob_rc != -1 && lob_size > 0)
 						{
 							size_t alloc_size = 0;
@@ -648,11 +713,15 @@ int SqlPgApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written,
 			{
 				len = (int)s_cols[k].ind[i];
 			}
+
+			// Converted date or timestamp (indicator contains the length of the binary value)
+			if(len != -1 && _copy_conv_data != NULL && _copy_conv_data[k] != NULL)
+				len = _copy_conv_len[k];
 			
 			// Check if we still have space to write column data, NULL value and delimiters
-			if(remain_len < 5 || (len != -1 && remain_len < len + 3))
+			if(remain_len < 5 || (len != -1 && !lob_stream && remain_len < len + 3))
 			{
-				rc = _PQputCopyData(_conn, _copy_data, (int)(cur - _copy_data));
+				rc = PutCopyData(_copy_data, (int)(cur - _copy_data));
 
 				cur = _copy_data;
 				remain_len = LIBPQ_COPY_DATA_BUFFER_LEN;
@@ -693,141 +762,61 @@ int SqlPgApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written,
 				(_source_api_type == SQLDATA_MYSQL && s_cols[k]._native_fetch_dt == MYSQL_TYPE_STRING))
 			{
 
-				// Copy data handling escape characaters
-				for(int m = 0; m < len; m++)
+				// Read LOB by parts and write each part
+				if(lob_stream)
 				{
-					char c = 0;
-
-					if(lob_data == NULL)
-						c = (s_cols[k]._data + s_cols[k]._fetch_len * i)[m];
-					else
-						c = lob_data[m];
+					bool more = true;
 
-					// Duplicate escape \ character
-					if(c == '\\')
-					{
-						cur[0] = c;
-						cur[1] = c;
-						
-						cur += 2;
-						remain_len -= 2;
-						bytes += 2;
-					}
-					else
-					// Escape delimiter or new line in data
-					if(c == '\t' || c == '\r' || c == '\n')
-					{
-						cur[0] = '\\';
-
-						if(c == '\t')
-							cur[1] = 't';
-						if(c == '\r')
-							cur[1] = 'r';
-						if(c == '\n')
-							cur[1] = 'n';
-
-						cur += 2;
-						remain_len -= 2;
-						bytes += 2;
-					}
-					else
-					// Zero byte must be escaped (can appear in binary data)
-					if(c == '\x0')
+					while(more)
 					{
-						// '\' must be itself escaped
-						cur[0] = '\\';
-						cur[1] = '\\';
-						cur[2] = '0';
-						cur[3] = '0';
-						cur[4] = '0';
-
-						cur += 5;
-						remain_len -= 5;
-						bytes += 5;
-					}
-					else
-					{
-						*cur = c;
+						int read_size = 0;
+						int lob_rc = _source_api_provider->GetLobPart(i, k, _copy_lob_data, _lob_chunk_size, &read_size);
 
-						cur++;
-						remain_len--;
-						bytes++;
-					}
+						if(lob_rc == -1)
+						{
+							_error = -1;
+							strcpy(_native_error_text, _source_api_provider->GetNativeErrorText());
 
-					// Check if we still have space to write the next byte of column data (can explode due to escape sequences)
-					if(m + 1 < len && remain_len < 5)
-					{
-						rc = _PQputCopyData(_conn, _copy_data, (int)(cur - _copy_data));
+							lob_failed = true;
+							break;
+						}
 
-						cur = _copy_data;
-						remain_len = LIBPQ_COPY_DATA_BUFFER_LEN;
+						WriteCopyData(_copy_lob_data, read_size, &cur, &remain_len, &bytes);
+
+						// No more pieces
+						if(lob_rc != 1)
+							more = false;
 					}
+
+					if(lob_failed)
+						break;
 				}
+				else
+				if(lob_data != NULL)
+					WriteCopyData(lob_data, len, &cur, &remain_len, &bytes);
+				else
+					WriteCopyData(s_cols[k]._data + s_cols[k]._fetch_len * i, len, &cur, &remain_len, &bytes);
 			}
 			else
-			// Oracle DATE fetched as 7 byte binary sequence
-			if(_source_api_type == SQLDATA_ORACLE && s_cols[k]._native_fetch_dt == SQLT_DAT)
+			// Oracle DATE and ODBC TIMESTAMP already converted to text for the batch
+			if(_copy_conv_data != NULL && _copy_conv_data[k] != NULL)
 			{
-				// Unsigned required for proper conversion to int
-				unsigned char *data = (unsigned char*)(s_cols[k]._data + s_cols[k]._fetch_len * i);
-
-				int c = ((int)data[0]) - 100;
-				int y = ((int)data[1]) - 100;
-				int m = (int)data[2];
-				int d = (int)data[3];
-				int h = ((int)data[4]) - 1;
-				int mi = ((int)data[5]) - 1;
-				int s = ((int)data[6]) - 1;
-
-				// Get string representation
-				Str::Dt2Ch(c, cur);
-				Str::Dt2Ch(y, cur + 2);
-				cur[4] = '-';
-				Str::Dt2Ch(m, cur + 5);
-				cur[7] = '-';
-				Str::Dt2Ch(d, cur + 8);
-				cur[10] = ' ';
-				Str::Dt2Ch(h, cur + 11);
-				cur[13] = ':';
-				Str::Dt2Ch(mi, cur + 14);
-				cur[16] = ':';
-				Str::Dt2Ch(s, cur + 17);
-
-				cur += 19;
-				remain_len -= 19;
-
-				bytes += 19;
-			}
-			else
-			// ODBC TIMESTAMP fetched as SQL_TIMESTAMP_STRUCT
-			if((_source_api_type == SQLDATA_SQL_SERVER || _source_api_type == SQLDATA_INFORMIX || 
-				_source_api_type == SQLDATA_ASA || _source_api_type == SQLDATA_ODBC) && 
-				s_cols[k]._native_fetch_dt == SQL_C_TYPE_TIMESTAMP)
-			{
-				size_t offset = sizeof(SQL_TIMESTAMP_STRUCT) * i;
-				
-				// Informix returns '1200-01-01 11:11:00.0' for 11:11 (HOUR TO MINUTE)
-				SQL_TIMESTAMP_STRUCT *ts = (SQL_TIMESTAMP_STRUCT*)(s_cols[k]._data + offset);
-
-				long fraction = (long)ts->fraction;
-
-				// Sybase ASA 9 stores 6-digit fraction multiplied by 1000, i.e. 123456 stored as 123456000
-				if(_source_api_type == SQLDATA_ASA && fraction % 1000 == 0)
-					fraction = fraction/1000;
-
-				// Convert SQL_TIMESTAMP_STRUCT to string (puts terminating 0)
-				Str::SqlTs2Str((short)ts->year, (short)ts->month, (short)ts->day, (short)ts->hour, (short)ts->minute, (short)ts->second, fraction, cur);
+				memcpy(cur, _copy_conv_data[k] + _copy_conv_len[k] * i, (size_t)len);
 
-				cur += 26;
-				remain_len -= 26;
+				cur += len;
+				remain_len -= len;
 
-				bytes += 26;
+				bytes += len;
 			}
 
 			if(lob_data != NULL)
 				_source_api_provider->FreeLobBuffer(lob_data);
 		}
 
+		// Reading LOB failed in the middle of the value
+		if(lob_failed)
+			break;
+
 		// Add row delimiter (no need to write \r for Windows)
 		*cur = '\n';
 		cur++;
@@ -837,7 +826,7 @@ int SqlPgApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written,
 	}
 
 	// Write last portion of data
-	rc = _PQputCopyData(_conn, _copy_data, (int)(cur - _copy_data));
+	rc = PutCopyData(_copy_data, (int)(cur - _copy_data));
 
 	if(time_spent)
 		*time_spent = GetTickCount() - start;
@@ -851,7 +840,96 @@ int SqlPgApi::TransferRows(SqlCol *s_cols, int rows_fetched, int *rows_written,
 	if(time_spent)
 		*time_spent = GetTickCount() - start;
 
-	return 0;
+	return lob_failed ? -1 : 0;
+}
+
+// Write column data to COPY buffer handling escape characters, the buffer is sent when full
+void SqlPgApi::WriteCopyData(const char *data, int len, char **cur_inout, int *remain_len_inout, size_t *bytes_inout)
+{
+	char *cur = *cur_inout;
+	int remain_len = *remain_len_inout;
+	size_t bytes = *bytes_inout;
+
+	for(int m = 0; m < len; m++)
+	{
+		char c = data[m];
+
+		// Duplicate escape \ character
+		if(c == '\\')
+		{
+			cur[0] = c;
+			cur[1] = c;
+			
+			cur += 2;
+			remain_len -= 2;
+			bytes += 2;
+		}
+		else
+		// Escape delimiter or new line in data
+		if(c == '\t' || c == '\r' || c == '\n')
+		{
+			cur[0] = '\\';
+
+			if(c == '\t')
+				cur[1] = 't';
+			if(c == '\r')
+				cur[1] = 'r';
+			if(c == '\n')
+				cur[1] = 'n';
+
+			cur += 2;
+			remain_len -= 2;
+			bytes += 2;
+		}
+		else
+		// Zero byte must be escaped (can appear in binary data)
+		if(c == '\x0')
+		{
+			// '\' must be itself escaped
+			cur[0] = '\\';
+			cur[1] = '\\';
+			cur[2] = '0';
+			cur[3] = '0';
+			cur[4] = '0';
+
+			cur += 5;
+			remain_len -= 5;
+			bytes += 5;
+		}
+		else
+		{
+			*cur = c;
+
+			cur++;
+			remain_len--;
+			bytes++;
+		}
+
+		// Check if we still have space to write the next byte of column data (can explode due to escape sequences)
+		if(remain_len < 5)
+		{
+			PutCopyData(_copy_data, (int)(cur - _copy_data));
+
+			cur = _copy_data;
+			remain_len = LIBPQ_COPY_DATA_BUFFER_LEN;
+		}
+	}
+
+	*cur_inout = cur;
+	*remain_len_inout = remain_len;
+	*bytes_inout = bytes;
+}
+
+// Send COPY buffer to the server measuring the send time
+int SqlPgApi::PutCopyData(const char *data, int len)
+{
+	size_t start = Os::GetTickCount();
+
+	int rc = _PQputCopyData(_conn, data, len);
+
+	_transfer_send_time += (int)(Os::GetTickCount() - start);
+
+	return rc;
 }
 
 // Write LOB data 
@@ -883,6 +961,21 @@ int SqlPgApi::CloseBulkTransfer()
 	delete _copy_data;
 	_copy_data = NULL;
 
+	delete [] _copy_lob_data;
+	_copy_lob_data = NULL;
+
+	if(_copy_conv_data != NULL)
+	{
+		for(size_t i = 0; i < _copy_cols_count; i++)
+			delete [] _copy_conv_data[i];
+
+		delete [] _copy_conv_data;
+		delete [] _copy_conv_len;
+
+		_copy_conv_data = NULL;
+		_copy_conv_len = NULL;
+	}
+
 	return rc;
 }
 
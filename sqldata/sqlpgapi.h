@@ -93,6 +93,11 @@ class SqlPgApi : public SqlApiBase
 	size_t _copy_cols_count;
 	// Buffer for COPY data
 	char *_copy_data;
+	// Buffer to read LOB values by parts
+	char *_copy_lob_data;
+	// Date and timestamp columns converted to text for the whole batch (NULL for other columns), text length per row
+	char **_copy_conv_data;
+	int *_copy_conv_len;
 
 	// PostgreSQL libpq C library DDL
 #if defined(WIN32) || defined(_WIN64)
@@ -219,6 +224,10 @@ private:
 
 	// Write LOB data using BCP API
 	int WriteLob(SqlCol *s_cols, int row, int *lob_bytes);
+	// Write column data to COPY buffer handling escape characters
+	void WriteCopyData(const char *data, int len, char **cur, int *remain_len, size_t *bytes);
+	// Send COPY buffer to the server measuring the send time
+	int PutCopyData(const char *data, int len);
 
 	// Set error code and message for the last API call
 	void SetError();
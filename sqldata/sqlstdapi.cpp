@@ -53,6 +53,13 @@ void SqlStdApi::SetConnectionString(const char* /*conn*/)
 // Connect to the database
 int SqlStdApi::Connect(size_t * /*time_spent*/)
 {
+	// Check if already connected
+	if(_connected == true)
+		return 0;
+
+	// Standard output does not require a connection
+	_connected = true;
+
 	return 0;
 }
 
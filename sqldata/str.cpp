@@ -195,6 +195,24 @@ char* Str::IntToString(int int_value, char *output)
 	return output;
 }
 
+// Get a field until one of delimiters or end of string, trailing spaces are not included
+char* Str::GetField(const char *input, const char *delimiters, std::string &output)
+{
+	if(input == NULL || delimiters == NULL)
+		return (char*)input;
+
+	size_t len = strcspn(input, delimiters);
+	size_t nlen = len;
+
+	while(nlen && input[nlen-1] == ' ')
+		nlen--;
+
+	// Copy the field at once
+	output.assign(input, nlen);
+
+	return (char*)input + len;
+}
+
 // Replace the first occurrence of a substring
 void Str::ReplaceFirst(std::string &str, std::string what, std::string with)
 {
@@ -347,7 +365,16 @@ void Str::SqlTs2Str(short year, short month, short day, short hour, short minute
 		out[26] = '\x0';
 	}
 	else
-		sprintf(out + 20, "%06d", fraction);		// puts terminating 0
+	{
+		// Zero padded 6 digits
+		for(int i = 25; i >= 20; i--)
+		{
+			out[i] = char('0' + fraction % 10);
+			fraction /= 10;
+		}
+
+		out[26] = '\x0';
+	}
 }
 
 // Convert 7-byte packed Oracle DATE to string (non-null terminated, exactly 19 characters)
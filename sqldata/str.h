@@ -47,6 +47,9 @@ public:
 	// Convert int to string
 	static char* IntToString(int int_value, char *output);
 
+	// Get a field until one of delimiters or end of string, trailing spaces are not included
+	static char* GetField(const char *input, const char *delimiters, std::string &output);
+
 	// Replace the first occurrence of a substring
 	static void ReplaceFirst(std::string &str, std::string what, std::string with);
 
@@ -1 +1 @@
-g++ -m32 --all-warnings applog.cpp file.cpp filelist.cpp main.cpp os.cpp parameters.cpp sqlines.cpp ../sqlparser/sqlparser.a -o sqlines
+g++ -m32 --all-warnings applog.cpp file.cpp filelist.cpp main.cpp os.cpp parameters.cpp sqlines.cpp ../sqlparser/sqlparser.a -o sqlines -lpthread
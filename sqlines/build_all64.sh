@@ -1 +1 @@
-g++ -m64 --all-warnings applog.cpp file.cpp filelist.cpp license.cpp main.cpp os.cpp parameters.cpp sqlines.cpp ../sqlparser/sqlparser.a -o sqlines
+g++ -m64 --all-warnings applog.cpp file.cpp filelist.cpp license.cpp main.cpp os.cpp parameters.cpp sqlines.cpp ../sqlparser/sqlparser.a -o sqlines -lpthread
@@ -62,6 +62,9 @@ public:
 	// Get the size of the file
 	static int GetFileSize(const char* file);
 
+	// Get the last modification time of the file
+	static long long GetModifiedTime(const char* file);
+
 	// Get content of the file (without terminating with 'x0')
 	static int GetContent(const char* file, void *input, size_t len);
 
@@ -71,6 +74,9 @@ public:
 	// Write the buffer to the file
     static int Write(const char *file, const char* content, size_t size);
 
+	// Get a temporary name for the file unique for the current process and thread
+	static void GetTempName(const char *file, std::string &tmp);
+
 	// Create directories (supports nested directories)
 	static void CreateDirectories(const char *path);
 };
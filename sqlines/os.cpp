@@ -18,13 +18,36 @@
 
 #ifdef WIN32
 #include <windows.h>
+#include <psapi.h>
 #else
+#include <pthread.h>
 #include <sys/time.h>
+#include <sys/resource.h>
 #endif
 
 #include <stdio.h>
 #include "os.h"
 
+// Enter the critical section
+void Os::EnterCriticalSection(void *section)
+{
+#ifdef WIN32
+	::EnterCriticalSection((CRITICAL_SECTION*)section);
+#else
+	pthread_mutex_lock((pthread_mutex_t*)section);
+#endif
+}
+
+// Leave the critical section
+void Os::LeaveCriticalSection(void *section)
+{
+#ifdef WIN32
+	::LeaveCriticalSection((CRITICAL_SECTION*)section);
+#else
+	pthread_mutex_unlock((pthread_mutex_t*)section);
+#endif
+}
+
 // Get procedure address
 void* Os::GetProcAddress(int module, const char *name)
 {
@@ -73,4 +96,44 @@ void Os::GetLastErrorText(const char *prefix, char *output, int len)
 	strcat(output, error);
 
 #endif
-}
\ No newline at end of file
+}
+
+// Get CPU time (user and system, seconds) and peak resident memory (bytes) of the current process
+int Os::GetProcessUsage(double *cpu_seconds, size_t *peak_rss)
+{
+#ifdef WIN32
+	FILETIME create_time, exit_time, kernel_time, user_time;
+
+	if(!GetProcessTimes(GetCurrentProcess(), &create_time, &exit_time, &kernel_time, &user_time))
+		return -1;
+
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernel_time.dwLowDateTime;
+	kernel.HighPart = kernel_time.dwHighDateTime;
+	user.LowPart = user_time.dwLowDateTime;
+	user.HighPart = user_time.dwHighDateTime;
+
+	// FILETIME is in 100-nanosecond units
+	if(cpu_seconds != NULL)
+		*cpu_seconds = ((double)(kernel.QuadPart + user.QuadPart))/10000000.0;
+
+	PROCESS_MEMORY_COUNTERS pmc;
+
+	if(peak_rss != NULL)
+		*peak_rss = GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? (size_t)pmc.PeakWorkingSetSize : 0;
+#else
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+
+	if(cpu_seconds != NULL)
+		*cpu_seconds = (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + 
+			((double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec))/1000000.0;
+
+	// Linux reports the maximum resident set size in kilobytes
+	if(peak_rss != NULL)
+		*peak_rss = (size_t)usage.ru_maxrss * 1024;
+#endif
+	return 0;
+}
@@ -19,9 +19,15 @@
 #ifndef sqlines_os_h
 #define sqlines_os_h
 
+#include <stddef.h>
+
 class Os
 {
 public:
+	// Enter and leave critical section
+	static void EnterCriticalSection(void *section);
+	static void LeaveCriticalSection(void *section);
+
 	// Get procedure address
 	static void* GetProcAddress(int module, const char *name);
 
@@ -30,6 +36,9 @@ public:
 
 	// Get error message of the last system error
 	static void GetLastErrorText(const char *prefix, char *output, int len);
+
+	// Get CPU time (user and system, seconds) and peak resident memory (bytes) of the current process
+	static int GetProcessUsage(double *cpu_seconds, size_t *peak_rss);
 };
 
 #endif // sqlines_os_h
\ No newline at end of file
@@ -19,9 +19,11 @@
 #ifdef WIN32
 #include <windows.h>
 #include <conio.h>
+#include <process.h>
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "sqlines.h"
 #include "filelist.h"
@@ -38,8 +40,20 @@ Sqlines::Sqlines()
 
     _a = false;
 	_stdin = false;
+	_eval_mode = false;
+
+	_threads = 1;
+	_next_file = 0;
+	_next_merge = 0;
+	_merged_lines = 0;
     
 	_exe = NULL;
+
+#ifdef WIN32
+	InitializeCriticalSection(&_files_critical_section);
+#else
+	pthread_mutex_init(&_files_critical_section, NULL);
+#endif
 }
 
 // Run the tool with command line parameters
@@ -86,6 +100,13 @@ int Sqlines::ProcessFiles()
 
 	int all_start = Os::GetTickCount();
 
+	if(!_cache.empty())
+		GetCacheOptions();
+
+	// Convert files by worker threads
+	if(_threads > 1 && _total_files > 1)
+		rc = ProcessFilesParallel(fileList.Get(), &total_lines);
+	else
 	// Handle each file
 	for(std::list<std::string>::iterator i = fileList.Get().begin(); i != fileList.Get().end(); i++, num++)
 	{
@@ -104,7 +125,7 @@ int Sqlines::ProcessFiles()
 		SetParserOption(_parser, SQLINES_CURRENT_FILE, relative_name.c_str());
 
 		// Convert the current file
-	    rc = ProcessFile(current, out_name, &in_size, &in_lines);
+	    rc = ProcessFile(_parser, current, out_name, &in_size, &in_lines);
 
 		total_lines += in_lines;
 
@@ -117,10 +138,17 @@ int Sqlines::ProcessFiles()
 		Str::FormatByteSize(in_size, size_fmt);
 
 		_log.Log("...Ok (%s, %d line%s, %s)", size_fmt, in_lines, SUFFIX(in_lines), time_fmt); 
+
+		LogPerf(relative_name.c_str(), in_size, in_lines, end, false);
 	}
 
+	int all_time = Os::GetTickCount() - all_start;
+
 	char total_time_fmt[21];
-	Str::FormatTime(Os::GetTickCount() - all_start, total_time_fmt);
+	Str::FormatTime(all_time, total_time_fmt);
+
+	if(_total_files > 0)
+		LogPerf("*", fileList.GetSize(), total_lines, all_time, true);
 
     if(_total_files > 0)
     {
@@ -146,6 +174,203 @@ int Sqlines::ProcessFiles()
 	return rc;
 }
 
+// Process files by worker threads, each with its own parser
+int Sqlines::ProcessFilesParallel(std::list<std::string> &files, int *total_lines)
+{
+	_files.clear();
+	_files.resize(files.size());
+
+	size_t num = 0;
+
+	// Output names are defined before starting threads as target directories are created
+	for(std::list<std::string>::iterator i = files.begin(); i != files.end(); i++, num++)
+	{
+		SqlinesFile &file = _files[num];
+
+		file.file = *i;
+		file.relative_name = File::GetRelativeName(_in.c_str(), i->c_str());
+		file.out_name = GetOutFileName(*i, file.relative_name);
+	}
+
+	_next_file = 0;
+	_next_merge = 0;
+	_merged_lines = 0;
+
+	int threads = (_threads < _total_files) ? _threads : _total_files;
+
+	std::vector<void*> parsers;
+#ifdef WIN32
+	std::vector<HANDLE> handles;
+#else
+	std::vector<pthread_t> handles;
+#endif
+
+	// Start workers, the main parser only collects assessment statistics of all files
+	for(int i = 0; i < threads; i++)
+	{
+		void *parser = CreateWorkerParser();
+
+		void **data = new void*[2];
+		data[0] = this;
+		data[1] = parser;
+
+#ifdef WIN32
+		HANDLE handle = (HANDLE)_beginthreadex(NULL, 0, &Sqlines::StartWorkerS, data, 0, NULL);
+
+		if(handle == 0)
+#else
+		pthread_t handle;
+
+		if(pthread_create(&handle, NULL, &Sqlines::StartWorkerS, data) != 0)
+#endif
+		{
+			delete [] data;
+			DeleteParserObject(parser);
+			break;
+		}
+
+		parsers.push_back(parser);
+		handles.push_back(handle);
+	}
+
+	// Process files in the current thread if no worker started
+	if(handles.empty())
+	{
+		void *parser = CreateWorkerParser();
+
+		ProcessFilesWorker(parser);
+		DeleteParserObject(parser);
+	}
+
+	// Wait for all workers
+	for(size_t i = 0; i < handles.size(); i++)
+	{
+#ifdef WIN32
+		WaitForSingleObject(handles[i], INFINITE);
+		CloseHandle(handles[i]);
+#else
+		pthread_join(handles[i], NULL);
+#endif
+		DeleteParserObject(parsers[i]);
+	}
+
+	if(total_lines != NULL)
+		*total_lines = _merged_lines;
+
+	int rc = _files.empty() ? 0 : _files.back().rc;
+
+	_files.clear();
+
+	return rc;
+}
+
+// Create a parser for a worker thread with the same types and options as the main parser
+void* Sqlines::CreateWorkerParser()
+{
+	void *parser = CreateParserObject();
+
+	SetTypes(parser);
+
+	if(_eval_mode)
+		SetParserOption(parser, SQLINES_EVAL_MODE, "TRUE");
+
+	SetOptions(parser);
+
+	// Assessment statistics of each file are merged to the main parser in file order
+	if(_a)
+		SetParserOption(parser, SQLINES_FILE_STATS, "TRUE");
+
+	return parser;
+}
+
+// Start a worker thread
+#ifdef WIN32
+unsigned int __stdcall Sqlines::StartWorkerS(void *data)
+#else
+void* Sqlines::StartWorkerS(void *data)
+#endif
+{
+	void **params = (void**)data;
+
+	Sqlines *sqlines = (Sqlines*)params[0];
+	void *parser = params[1];
+
+	delete [] params;
+
+	sqlines->ProcessFilesWorker(parser);
+
+#ifdef WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+// Convert files until all files are taken by workers
+void Sqlines::ProcessFilesWorker(void *parser)
+{
+	while(true)
+	{
+		Os::EnterCriticalSection(&_files_critical_section);
+
+		size_t num = _next_file++;
+
+		Os::LeaveCriticalSection(&_files_critical_section);
+
+		if(num >= _files.size())
+			break;
+
+		SqlinesFile &file = _files[num];
+
+		int start = Os::GetTickCount();
+
+		SetParserOption(parser, SQLINES_CURRENT_FILE, file.relative_name.c_str());
+
+		file.rc = ProcessFile(parser, file.file, file.out_name, &file.size, &file.lines);
+
+		if(_a)
+			file.stats = GetAssessmentStats(parser);
+
+		file.time = Os::GetTickCount() - start;
+
+		Os::EnterCriticalSection(&_files_critical_section);
+
+		file.done = true;
+		MergeProcessedFiles();
+
+		Os::LeaveCriticalSection(&_files_critical_section);
+	}
+}
+
+// Log processed files and merge their statistics in file order (called in the critical section)
+void Sqlines::MergeProcessedFiles()
+{
+	while(_next_merge < _files.size() && _files[_next_merge].done)
+	{
+		SqlinesFile &file = _files[_next_merge];
+
+		if(file.stats != NULL)
+		{
+			MergeAssessmentStats(_parser, file.stats);
+			file.stats = NULL;
+		}
+
+		char time_fmt[21];
+		char size_fmt[21];
+
+		Str::FormatTime(file.time, time_fmt);
+		Str::FormatByteSize(file.size, size_fmt);
+
+		_log.Log("\n%5d. %s", (int)_next_merge + 1, file.relative_name.c_str()); 
+		_log.Log("...Ok (%s, %d line%s, %s)", size_fmt, file.lines, SUFFIX(file.lines), time_fmt); 
+
+		LogPerf(file.relative_name.c_str(), file.size, file.lines, file.time, false);
+
+		_merged_lines += file.lines;
+		_next_merge++;
+	}
+}
+
 // Get output name of the file
 std::string Sqlines::GetOutFileName(std::string &input, std::string &relative_name)
 {
@@ -211,9 +436,9 @@ std::string Sqlines::GetOutFileName(std::string &input, std::string &relative_na
 }
 
 // Process a file
-int Sqlines::ProcessFile(std::string &file, std::string &out_file, int *in_size, int *in_lines)
+int Sqlines::ProcessFile(void *parser, std::string &file, std::string &out_file, int *in_size, int *in_lines)
 {
-	if(_parser == NULL)
+	if(parser == NULL)
 		return -1;
 
 	int size = File::GetFileSize(file.c_str());
@@ -229,7 +454,7 @@ int Sqlines::ProcessFile(std::string &file, std::string &out_file, int *in_size,
 
 	if(rc == -1)
 	{
-		delete input;
+		delete [] input;
 		return -1;
 	}
 
@@ -237,12 +462,45 @@ int Sqlines::ProcessFile(std::string &file, std::string &out_file, int *in_size,
 	int out_size = 0;
 	int lines;
 
+	std::string cache_key;
+
+	// Output and assessment results of an unchanged file are taken from the cache
+	if(!_cache.empty())
+	{
+		GetCacheKey(file, input, size, cache_key);
+
+		std::string cached_output;
+
+		if(LoadCachedOutput(cache_key, cached_output, &lines) == 0 && 
+			(!_a || LoadAssessmentStats(parser, cache_key.c_str(), &lines) == 0))
+		{
+			rc = WriteOutFile(out_file, cached_output.c_str(), (int)cached_output.size());
+
+			if(in_size != NULL)
+				*in_size = size;
+
+			if(in_lines != NULL)
+				*in_lines = lines;
+
+			delete [] input;
+			return rc;
+		}
+	}
+
 	// Convert the file
-    rc = ConvertSql(_parser, input, size, &output, &out_size, &lines);
+    rc = ConvertSql(parser, input, size, &output, &out_size, &lines);
 
     // Write the target content to the file
     rc = File::Write(out_file.c_str(), output, out_size);
 
+	if(!cache_key.empty())
+	{
+		SaveCachedOutput(cache_key, output, out_size, lines);
+
+		if(_a)
+			SaveAssessmentStats(parser, cache_key.c_str(), lines);
+	}
+
     FreeOutput(output);
 
 	if(in_size != NULL)
@@ -251,11 +509,30 @@ int Sqlines::ProcessFile(std::string &file, std::string &out_file, int *in_size,
 	if(in_lines != NULL)
 		*in_lines = lines;
 
-	delete input;
+	delete [] input;
 
 	return rc;
 }
 
+// Write the output file, an existing file with the same content is left untouched
+int Sqlines::WriteOutFile(std::string &out_file, const char *output, int size)
+{
+	if(File::GetFileSize(out_file.c_str()) == size)
+	{
+		char *existing = new char[size + 1];
+
+		bool same = (File::GetContent(out_file.c_str(), existing, (size_t)size) != -1 && 
+			memcmp(existing, output, (size_t)size) == 0);
+
+		delete [] existing;
+
+		if(same)
+			return size;
+	}
+
+	return File::Write(out_file.c_str(), output, (size_t)size);
+}
+
 // Convert input from STDIN
 int Sqlines::ProcessStdin()
 {
@@ -326,6 +603,8 @@ int Sqlines::SetParameters(int argc, char **argv)
 			{
 				_log.Log("\n\nThe product is FOR EVALUATION USE ONLY.");
 				SetParserOption(_parser, SQLINES_EVAL_MODE, "TRUE");
+
+				_eval_mode = true;
 			}
 			else
 				_log.Log("\n\nThe product is licensed to %s.", _license.GetName().c_str());
@@ -362,6 +641,27 @@ int Sqlines::SetParameters(int argc, char **argv)
 	if(value != NULL)
 		_a = true;
 
+	// Get -perf option
+	value = _parameters.Get(PERF_OPTION);
+
+	if(value != NULL)
+		_perf = value;
+
+	// Get -cache option
+	value = _parameters.Get(CACHE_OPTION);
+
+	if(value != NULL && *value != '\x0')
+	{
+		_cache = value;
+		File::CreateDirectories(_cache.c_str());
+	}
+
+	// Get -threads option
+	value = _parameters.Get(THREADS_OPTION);
+
+	if(value != NULL && atoi(value) > 1)
+		_threads = atoi(value);
+
 	if(_parameters.Get(HELP_PARAMETER))
 	{
 		PrintHowToUse();
@@ -386,28 +686,28 @@ int Sqlines::SetParameters(int argc, char **argv)
 		return -1;
 	}
 
-	SetTypes();
-	SetOptions();
+	SetTypes(_parser);
+	SetOptions(_parser);
 
 	return rc;
 }
 
 // Set source and target types
-void Sqlines::SetTypes()
+void Sqlines::SetTypes(void *parser)
 {
 	int source = DefineType(_s.c_str());
 	int target = DefineType(_t.c_str());
 
-	SetParserTypes(_parser, source, target);
+	SetParserTypes(parser, source, target);
 }
 
 // Set conversion options
-void Sqlines::SetOptions()
+void Sqlines::SetOptions(void *parser)
 {
 	ParametersMap &map = _parameters.GetMap();
 
 	for(ParametersMap::iterator i = map.begin(); i != map.end(); ++i)
-		SetParserOption(_parser, i->first.c_str(), i->second.c_str());
+		SetParserOption(parser, i->first.c_str(), i->second.c_str());
 }
 
 // Define SQL dialect type by name
@@ -472,6 +772,186 @@ short Sqlines::DefineType(const char *name)
 	return type;
 }
 
+// Get the fingerprint of options that affect results saved to the cache
+void Sqlines::GetCacheOptions()
+{
+	_cache_options = SQLINES_VERSION;
+
+	ParametersMap &map = _parameters.GetMap();
+
+	for(ParametersMap::iterator i = map.begin(); i != map.end(); ++i)
+	{
+		// Output and log locations do not affect results
+		if(i->first == OUT_OPTION || i->first == LOG_OPTION || i->first == PERF_OPTION || i->first == CACHE_OPTION || 
+			i->first == THREADS_OPTION)
+			continue;
+
+		_cache_options += '\n';
+		_cache_options += i->first;
+		_cache_options += '=';
+		_cache_options += i->second;
+
+		// Mapping files are identified by their size and modification time
+		if(i->first == META_OPTION || i->first == OMAPF_OPTION || i->first == FSPMAPF_OPTION)
+		{
+			char fingerprint[64];
+			sprintf(fingerprint, ",%d,%lld", File::GetFileSize(i->second.c_str()), File::GetModifiedTime(i->second.c_str()));
+
+			_cache_options += fingerprint;
+		}
+	}
+}
+
+// Get the cache key for the file content
+void Sqlines::GetCacheKey(std::string &file, const char *input, int size, std::string &key)
+{
+	unsigned long long hash = Str::Hash(_cache_options.c_str(), _cache_options.size());
+
+	// File name is referenced in assessment results, converted output depends on the content only
+	if(_a)
+		hash = Str::Hash(file.c_str(), file.size() + 1, hash);
+
+	hash = Str::Hash(input, (size_t)size, hash);
+
+	char hash_str[21];
+	sprintf(hash_str, "%016llx", hash);
+
+	key = hash_str;
+}
+
+// Get the cache file name for the key
+void Sqlines::GetCacheFileName(std::string &key, const char *ext, std::string &file)
+{
+	file = _cache;
+
+	if(!file.empty() && file[file.size() - 1] != DIR_SEPARATOR_CHAR && file[file.size() - 1] != '/')
+		file += DIR_SEPARATOR_CHAR;
+
+	file += key;
+	file += ext;
+}
+
+// Get converted output of an unchanged file from the cache
+int Sqlines::LoadCachedOutput(std::string &key, std::string &output, int *lines)
+{
+	std::string file;
+	GetCacheFileName(key, OUTPUT_CACHE_EXT, file);
+
+	int size = File::GetFileSize(file.c_str());
+
+	if(size < (int)sizeof(OutputCacheHeader))
+		return -1;
+
+	char *data = new char[size];
+
+	if(File::GetContent(file.c_str(), data, (size_t)size) == -1)
+	{
+		delete [] data;
+		return -1;
+	}
+
+	OutputCacheHeader header;
+	memcpy(&header, data, sizeof(header));
+
+	// Check the format and that the file was completely written
+	if(strncmp(header.magic, OUTPUT_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != OUTPUT_CACHE_VERSION || 
+		header.size < 0 || header.size != size - (int)sizeof(header))
+	{
+		delete [] data;
+		return -1;
+	}
+
+	output.assign(data + sizeof(header), (size_t)header.size);
+
+	if(lines != NULL)
+		*lines = header.lines;
+
+	delete [] data;
+
+	return 0;
+}
+
+// Save converted output to the cache
+int Sqlines::SaveCachedOutput(std::string &key, const char *output, int size, int lines)
+{
+	if(output == NULL || size < 0)
+		return -1;
+
+	std::string file;
+	GetCacheFileName(key, OUTPUT_CACHE_EXT, file);
+
+	OutputCacheHeader header;
+	memset(&header, 0, sizeof(header));
+
+	strncpy(header.magic, OUTPUT_CACHE_MAGIC, sizeof(header.magic) - 1);
+	header.version = OUTPUT_CACHE_VERSION;
+	header.lines = lines;
+	header.size = size;
+
+	std::string content;
+	content.reserve(sizeof(header) + (size_t)size);
+
+	content.append((const char*)&header, sizeof(header));
+	content.append(output, (size_t)size);
+
+	// Write to a temporary file first, so concurrent runs never read a partially written output
+	std::string tmp;
+	File::GetTempName(file.c_str(), tmp);
+
+	if(File::Write(tmp.c_str(), content.c_str(), content.size()) != (int)content.size())
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+#ifdef WIN32
+	// rename() does not replace an existing file on Windows
+	remove(file.c_str());
+#endif
+
+	if(rename(tmp.c_str(), file.c_str()) != 0)
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+	return 0;
+}
+
+// Append a record to the performance file
+void Sqlines::LogPerf(const char *file, int size, int lines, int time, bool total)
+{
+	if(_perf.empty() || file == NULL)
+		return;
+
+	// Check whether the header must be written
+	bool exists = File::IsFile(_perf.c_str(), NULL);
+
+	FILE *perf = fopen(_perf.c_str(), "a");
+
+	if(perf == NULL)
+		return;
+
+	if(!exists)
+		fprintf(perf, "source\ttarget\tfile\tbytes\tlines\ttime_ms\tmb_per_sec\tlines_per_sec\tcpu_sec\tpeak_rss_bytes\n");
+
+	double seconds = (time > 0) ? ((double)time)/1000.0 : 0.001;
+
+	fprintf(perf, "%s\t%s\t%s\t%d\t%d\t%d\t%.3f\t%.0f\t", _s.c_str(), _t.c_str(), file, size, lines, time, 
+		((double)size)/1048576.0/seconds, ((double)lines)/seconds);
+
+	double cpu_seconds = 0;
+	size_t peak_rss = 0;
+
+	// CPU time and memory are reported for the whole run
+	if(total && Os::GetProcessUsage(&cpu_seconds, &peak_rss) == 0)
+		fprintf(perf, "%.3f\t%.0f\n", cpu_seconds, (double)peak_rss);
+	else
+		fprintf(perf, "\t\n");
+
+	fclose(perf);
+}
+
 // Output how to use the tool if /? or incorrect parameters are specified
 void Sqlines::PrintHowToUse()
 {
@@ -484,6 +964,9 @@ void Sqlines::PrintHowToUse()
 	printf("\n   -in       - List of files (wildcards *.* are allowed)");
 	printf("\n   -out      - Output directory (the current directory by default)");
 	printf("\n   -log      - Log file (sqlines.log by default)");
+	printf("\n   -perf     - Append conversion timings to the file (tab-separated)");
+	printf("\n   -threads  - Number of threads converting files in parallel (1 by default)");
+	printf("\n   -cache    - Directory for compiled -meta and -omapf files, converted output and assessment results of unchanged files reused by next runs");
 	printf("\n   -?        - Print how to use");
 
 	printf("\n\nExample:");
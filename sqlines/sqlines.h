@@ -17,7 +17,15 @@
 #ifndef sqlines_sqlines_h
 #define sqlines_sqlines_h
 
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 #include <string>
+#include <list>
+#include <vector>
 #include "applog.h"
 #include "parameters.h"
 #include "license.h"
@@ -34,13 +42,58 @@
 #define SL_OPTION                   "-sl"       // Source programming language (COBOL i.e.)
 #define TL_OPTION                   "-tl"       // Target programming language (Java i.e.)
 #define LOG_OPTION                  "-log"      // Log file
+#define PERF_OPTION                 "-perf"     // Append conversion timings to the file (tab-separated)
+#define CACHE_OPTION                "-cache"    // Directory for results reused by next runs
+#define THREADS_OPTION              "-threads"  // Number of threads converting files in parallel
+
+// Parser options with mapping files
+#define META_OPTION                 "-meta"
+#define OMAPF_OPTION                "-omapf"
+#define FSPMAPF_OPTION              "-fspmapf"
 
 #define SQLINES_CURRENT_FILE        "__cur_file__"    // Relative path for the current file
 #define SQLINES_EVAL_MODE           "__eval_mode__"   // Evaluation mode
+#define SQLINES_FILE_STATS          "__file_stats__"  // Keep assessment statistics of each file to merge them in file order
 
 // Default log file name
 #define SQLINES_LOGFILE             "sqlines.log"
 
+// Converted output saved to the cache
+#define OUTPUT_CACHE_MAGIC          "SQLINES_OUTPUT"
+#define OUTPUT_CACHE_VERSION        1
+#define OUTPUT_CACHE_EXT            ".out"
+
+// Cache file header, followed by the converted output
+struct OutputCacheHeader
+{
+	char magic[16];
+	int version;
+	// Number of lines in the source file
+	int lines;
+	// Size of the output
+	int size;
+};
+
+// File processed by a worker thread
+struct SqlinesFile
+{
+	std::string file;
+	std::string relative_name;
+	std::string out_name;
+
+	// Results, set when the file is processed
+	int rc;
+	int size;
+	int lines;
+	int time;
+	bool done;
+
+	// Assessment statistics of the file merged in file order
+	void *stats;
+
+	SqlinesFile() { rc = 0; size = 0; lines = 0; time = 0; done = false; stats = NULL; }
+};
+
 #define SUFFIX(int_value)           ((int_value == 1) ? "" : "s")
 
 class Sqlines
@@ -51,9 +104,18 @@ class Sqlines
     std::string _in;
     std::string _out;
 	std::string _logfile;
+	std::string _perf;
+	std::string _cache;
+
+	// Fingerprint of options that affect results saved to the cache
+	std::string _cache_options;
 
     bool _a;
     bool _stdin;
+	bool _eval_mode;
+
+	// Number of threads converting files in parallel
+	int _threads;
 
     // Current executable file
     const char *_exe;
@@ -72,6 +134,18 @@ class Sqlines
 	// License information
 	License _license;
 
+	// Files processed by worker threads, the next file to process and the next file to merge in order
+	std::vector<SqlinesFile> _files;
+	size_t _next_file;
+	size_t _next_merge;
+	int _merged_lines;
+
+#ifdef WIN32
+	CRITICAL_SECTION _files_critical_section;
+#else
+	pthread_mutex_t _files_critical_section;
+#endif
+
 public:
     Sqlines();
 
@@ -84,17 +158,43 @@ private:
 
     int ProcessFiles();
     int ProcessStdin();
-    int ProcessFile(std::string &file, std::string &out_file, int *in_size, int *in_lines);
+    int ProcessFile(void *parser, std::string &file, std::string &out_file, int *in_size, int *in_lines);
+
+    // Process files by worker threads, each with its own parser
+    int ProcessFilesParallel(std::list<std::string> &files, int *total_lines);
+    void ProcessFilesWorker(void *parser);
+    void* CreateWorkerParser();
+    void MergeProcessedFiles();
+#ifdef WIN32
+	static unsigned int __stdcall StartWorkerS(void *data);
+#else
+	static void* StartWorkerS(void *data);
+#endif
 
     // Get output name of the file
     std::string GetOutFileName(std::string &input, std::string &relative_name);
 
     // Set source and target types
-    void SetTypes();
+    void SetTypes(void *parser);
     short DefineType(const char *name);
 
     // Set conversion options
-    void SetOptions();
+    void SetOptions(void *parser);
+
+    // Get the fingerprint of options, and the cache key for the file content
+    void GetCacheOptions();
+    void GetCacheKey(std::string &file, const char *input, int size, std::string &key);
+    void GetCacheFileName(std::string &key, const char *ext, std::string &file);
+
+    // Get and save converted output of an unchanged file in the cache
+    int LoadCachedOutput(std::string &key, std::string &output, int *lines);
+    int SaveCachedOutput(std::string &key, const char *output, int size, int lines);
+
+    // Write the output file, an existing file with the same content is left untouched
+    int WriteOutFile(std::string &out_file, const char *output, int size);
+
+    // Append a record to the performance file
+    void LogPerf(const char *file, int size, int lines, int time, bool total);
 
     // Output how to use the tool if /? or incorrect parameters are specified
     void PrintHowToUse();
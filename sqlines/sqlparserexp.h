@@ -39,10 +39,15 @@
 #define SQL_MARIADB_ORA         17
 
 extern void* CreateParserObject();
+extern void DeleteParserObject(void *parser);
 extern void SetParserTypes(void *parser, short source, short target);
 extern int SetParserOption(void *parser, const char *option, const char *value);
 extern int ConvertSql(void *parser, const char *input, int size, const char **output, int *out_size, int *lines);
 extern void FreeOutput(const char *output);
 extern int CreateAssessmentReport(void *parser, const char *summary);
+extern int SaveAssessmentStats(void *parser, const char *key, int lines);
+extern int LoadAssessmentStats(void *parser, const char *key, int *lines);
+extern void* GetAssessmentStats(void *parser);
+extern int MergeAssessmentStats(void *parser, void *stats);
 
 #endif // sqlines_sqlparserexp_h
\ No newline at end of file
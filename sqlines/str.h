@@ -61,6 +61,9 @@ public:
 	// Convert int to string
 	static char* IntToString(int int_value, char *output);
 
+	// Get 64-bit FNV-1a hash of the data, the previous hash can be passed to continue hashing
+	static unsigned long long Hash(const char *input, size_t len, unsigned long long hash = 14695981039346656037ULL);
+
 	// Replace the first occurrence of a substring
 	static void ReplaceFirst(std::string &str, std::string what, std::string with);
 
@@ -1,2 +1,2 @@
-g++ -m32 --all-warnings -c dllmain.cpp cobol.cpp file.cpp clauses.cpp datatypes.cpp db2.cpp functions.cpp greenplum.cpp guess.cpp java.cpp informix.cpp language.cpp mysql.cpp oracle.cpp postgresql.cpp select.cpp helpers.cpp patterns.cpp post.cpp procedures.cpp report.cpp storage.cpp sqlparser.cpp sqlserver.cpp statements.cpp stats.cpp str.cpp sybase.cpp teradata.cpp token.cpp 
-ar rcs sqlparser.a dllmain.o cobol.o file.o clauses.o datatypes.o db2.o functions.o greenplum.o guess.o java.o informix.o language.o mysql.o oracle.o postgresql.o select.o helpers.o patterns.o post.o procedures.o report.o storage.o sqlparser.o sqlserver.o statements.o stats.o str.o sybase.o teradata.o token.o
+g++ -m32 --all-warnings -c dllmain.cpp cobol.cpp file.cpp clauses.cpp datatypes.cpp db2.cpp functions.cpp greenplum.cpp guess.cpp java.cpp informix.cpp language.cpp mapcache.cpp mysql.cpp oracle.cpp postgresql.cpp select.cpp helpers.cpp patterns.cpp post.cpp procedures.cpp report.cpp storage.cpp sqlparser.cpp sqlserver.cpp statements.cpp stats.cpp str.cpp sybase.cpp teradata.cpp token.cpp 
+ar rcs sqlparser.a dllmain.o cobol.o file.o clauses.o datatypes.o db2.o functions.o greenplum.o guess.o java.o informix.o language.o mapcache.o mysql.o oracle.o postgresql.o select.o helpers.o patterns.o post.o procedures.o report.o storage.o sqlparser.o sqlserver.o statements.o stats.o str.o sybase.o teradata.o token.o
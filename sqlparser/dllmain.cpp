@@ -27,6 +27,11 @@ void* CreateParserObject()
 	return new SqlParser();
 }
 
+void DeleteParserObject(void *parser)
+{
+	delete (SqlParser*)parser;
+}
+
 void SetParserTypes(void *parser, short source, short target)
 {
 	if(parser == NULL)
@@ -74,6 +79,56 @@ int CreateAssessmentReport(void *parser, const char *summary)
 	return sql_parser->CreateReport(summary);
 }
 
+// Save assessment statistics of the last converted file to the cache
+int SaveAssessmentStats(void *parser, const char *key, int lines)
+{
+	if(parser == NULL)
+		return -1;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	return sql_parser->SaveFileStats(key, lines);
+}
+
+// Add assessment statistics of an unchanged file from the cache
+int LoadAssessmentStats(void *parser, const char *key, int *lines)
+{
+	if(parser == NULL)
+		return -1;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	return sql_parser->LoadFileStats(key, lines);
+}
+
+// Get assessment statistics of the last converted file (parallel assessment), they are passed to MergeAssessmentStats
+void* GetAssessmentStats(void *parser)
+{
+	if(parser == NULL)
+		return NULL;
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	return sql_parser->DetachFileStats();
+}
+
+// Add assessment statistics of a file converted by another parser and free them
+int MergeAssessmentStats(void *parser, void *stats)
+{
+	if(parser == NULL)
+	{
+		delete (Stats*)stats;
+		return -1;
+	}
+
+	SqlParser *sql_parser = (SqlParser*)parser;
+
+	int rc = sql_parser->MergeFileStats((Stats*)stats);
+
+	delete (Stats*)stats;
+	return rc;
+}
+
 // Free allocated result
 void FreeOutput(const char *output)
 {
@@ -22,12 +22,14 @@
 #include <stdlib.h>
 
 #ifdef WIN32
+#include <windows.h>
 #include <io.h>
 #include <direct.h>
 #else
 #include <sys/stat.h>
 #include <sys/io.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #define _read read
 #define _write write
@@ -266,6 +268,44 @@ int File::GetFileSize(const char* file)
 	return size;
 }
 
+// Get the last modification time of the file
+long long File::GetModifiedTime(const char* file)
+{
+	long long mtime = -1;
+
+	if(file == NULL)
+		return -1;
+
+#ifdef WIN32
+
+	struct _finddata_t fileData;
+
+	int findHandle = _findfirst(file, &fileData); 
+
+	if(findHandle == -1)
+	{
+		return -1;
+	}
+
+	mtime = (long long)fileData.time_write;
+
+	_findclose(findHandle);
+
+#else
+
+	struct stat info;
+  
+	if(stat(file, &info) != -1)
+	{
+		if(S_ISREG(info.st_mode))
+ 			mtime = (long long)info.st_mtime;
+	}
+
+#endif
+
+	return mtime;
+}
+
 // Get content of the file (without terminating with 'x0')
 int File::GetContent(const char *file, void *input, size_t len)
 {
@@ -332,7 +372,7 @@ int File::Write(const char *file, const char* content, size_t size)
   int fileh = _open(file, _O_CREAT | _O_RDWR | _O_BINARY | _O_TRUNC, _S_IREAD | _S_IWRITE);
 #else
   // open the file
-  int fileh = open(file, O_CREAT | O_RDWR, 0666);
+  int fileh = open(file, O_CREAT | O_RDWR | O_TRUNC, 0666);
 #endif
 
    if(fileh == -1)
@@ -345,3 +385,18 @@ int File::Write(const char *file, const char* content, size_t size)
 
    return rc;
 }
+
+// Get a temporary name for the file unique for the current process and thread
+void File::GetTempName(const char *file, std::string &tmp)
+{
+	char suffix[64];
+
+#ifdef WIN32
+	sprintf(suffix, ".%lu.%lu.tmp", (unsigned long)GetCurrentProcessId(), (unsigned long)GetCurrentThreadId());
+#else
+	sprintf(suffix, ".%lu.%lu.tmp", (unsigned long)getpid(), (unsigned long)pthread_self());
+#endif
+
+	tmp = file;
+	tmp += suffix;
+}
@@ -59,6 +59,9 @@ public:
 	// Get the size of the file
 	static int GetFileSize(const char* file);
 
+	// Get the last modification time of the file
+	static long long GetModifiedTime(const char* file);
+
 	// Get content of the file (without terminating with 'x0')
 	static int GetContent(const char* file, void *input, size_t len);
 
@@ -67,6 +70,9 @@ public:
 
 	// Write the buffer to the file
     static int Write(const char *file, const char* content, size_t size);
+
+	// Get a temporary name for the file unique for the current process and thread
+	static void GetTempName(const char *file, std::string &tmp);
 };
 
 #endif // sqlines_file_h
\ No newline at end of file
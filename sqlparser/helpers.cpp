@@ -299,13 +299,7 @@ void SqlParser::SetObjectMappingFromFile(const char *file)
 		std::string target;
 
 		// Get the source name until ,
-		while(*cur && *cur != ',')
-		{
-			source += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(source);
+		cur = Str::GetField(cur, ",", source);
 
 		if(*cur == ',')
 			cur++;
@@ -315,16 +309,14 @@ void SqlParser::SetObjectMappingFromFile(const char *file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get the target name until new line
-		while(*cur && *cur != '\r' && *cur != '\n' && *cur != '\t')
-		{
-			target += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(target);
+		cur = Str::GetField(cur, "\r\n\t", target);
 
+		// Source names are looked up case-insensitively
+		std::transform(source.begin(), source.end(), source.begin(), ::tolower);
 		_object_map.insert(StringMapPair(source, target));
 	}
+
+	delete [] input;
 }
 
 // Meta information about tables, columns
@@ -352,6 +344,11 @@ void SqlParser::SetMetaFromFile(const char *file)
 
 	char *cur = input;
 
+	std::string object;
+	std::string column;
+	std::string dtype;
+	std::string key;
+
 	// Process input
 	while(*cur)
 	{
@@ -360,18 +357,8 @@ void SqlParser::SetMetaFromFile(const char *file)
 		if(*cur == '\x0')
 			break;
 
-		std::string object;
-		std::string column;
-        std::string dtype;
-
 		// Get the object name until ,
-		while(*cur && *cur != ',')
-		{
-			object += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(object);
+		cur = Str::GetField(cur, ",", object);
 
 		if(*cur == ',')
 			cur++;
@@ -381,13 +368,7 @@ void SqlParser::SetMetaFromFile(const char *file)
 		cur = Str::SkipSpaces(cur);
 
         // Get the column name until ,
-		while(*cur && *cur != ',')
-		{
-			column += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(column);
+		cur = Str::GetField(cur, ",", column);
 
 		if(*cur == ',')
 			cur++;
@@ -397,30 +378,19 @@ void SqlParser::SetMetaFromFile(const char *file)
 		cur = Str::SkipSpaces(cur);
 
 		// Get the data type until new line
-		while(*cur && *cur != '\r' && *cur != '\n' && *cur != '\t')
-		{
-			dtype += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(dtype);
+		cur = Str::GetField(cur, "\r\n\t", dtype);
 
-        std::transform(object.begin(), object.end(), object.begin(), ::tolower);
+		// Index by lower case object,column, the first entry has priority
+		key.clear();
 
-        // Check if any metadata for this object already exists
-        ListT<Meta> *m = NULL;
-        std::map<std::string, ListT<Meta>*>::iterator i = _meta.find(object);
-        
-        if(i == _meta.end())
-        {
-            m = new ListT<Meta>();
-            _meta.insert(std::make_pair(object, m));
-        }
-        else 
-            m = i->second;
+		Str::AppendLower(key, object.c_str(), object.size());
+		key += ',';
+		Str::AppendLower(key, column.c_str(), column.size());
 
-        m->Add(new Meta(object, column, dtype));
+		_meta.insert(StringMapPair(key, dtype));
 	}
+
+	delete [] input;
 }
 
 // Functions mapped to stored procedures
@@ -459,54 +429,142 @@ void SqlParser::SetFuncToSpMappingFromFile(const char *file)
 		std::string source;
 		
 		// Get the name until new line
-		while(*cur && *cur != '\r' && *cur != '\n' && *cur != '\t')
-		{
-			source += *cur;
-			cur++;
-		}
-
-		Str::TrimTrailingSpaces(source);
+		cur = Str::GetField(cur, "\r\n\t", source);
 
 		std::transform(source.begin(), source.end(), source.begin(), ::tolower);
 		_func_to_sp_map.insert(StringMapPair(source, ""));
 	}
+
+	delete [] input;
 }
 
 // Read the data type from available meta information
 const char* SqlParser::GetMetaType(Token *object, Token *column)
 {
-    if(object == NULL)
-        return NULL;
+	if(object == NULL)
+		return NULL;
+
+	if(!_meta_file.empty())
+		LoadMeta();
 
-    TokenStr obj;
-    TokenStr col;
+	if(_meta.empty() && _meta_cache == NULL)
+		return NULL;
+
+	_meta_key.clear();
+
+	// Build the key from the source names directly when possible
+	if(object->t_str == NULL && object->str != NULL && 
+		(column == NULL || (column->t_str == NULL && column->str != NULL)))
+	{
+		if(column == NULL)
+		{
+			Str::AppendLower(_meta_key, object->str, object->len);
+
+			// Separate object and column names by the first .
+			size_t dot = _meta_key.find('.');
 
-    // Separate object and column names
-	if(column == NULL)
-		SplitIdentifierByLastPart(object, obj, col, 2);
+			if(dot != std::string::npos)
+				_meta_key[dot] = ',';
+			else
+				_meta_key += ',';
+		}
+		else
+		{
+			Str::AppendLower(_meta_key, object->str, object->len);
+			_meta_key += ',';
+			Str::AppendLower(_meta_key, column->str, column->len);
+		}
+	}
 	else
 	{
-		obj.Append(object);
-		col.Append(column);
+		TokenStr obj;
+		TokenStr col;
+
+		// Separate object and column names
+		if(column == NULL)
+			SplitIdentifierByLastPart(object, obj, col, 2);
+		else
+		{
+			obj.Append(object);
+			col.Append(column);
+		}
+
+		Str::AppendLower(_meta_key, obj.str.c_str(), obj.str.size());
+		_meta_key += ',';
+		Str::AppendLower(_meta_key, col.str.c_str(), col.str.size());
 	}
 
-    std::transform(obj.str.begin(), obj.str.end(), obj.str.begin(), ::tolower);
-    std::map<std::string, ListT<Meta>*>::iterator i = _meta.find(obj.str);
+	if(_meta_cache != NULL)
+		return _meta_cache->Find(_meta_key.c_str(), _meta_key.size());
+
+	StringMap::iterator i = _meta.find(_meta_key);
+
+	if(i != _meta.end())
+		return i->second.c_str();
+
+	return NULL;
+}
+
+// Load meta information on the first lookup
+void SqlParser::LoadMeta()
+{
+	std::string file = _meta_file;
+	_meta_file.clear();
+
+	delete _meta_cache;
+	_meta_cache = OpenMapCache(file.c_str(), "meta");
+
+	if(_meta_cache != NULL)
+		return;
+
+	SetMetaFromFile(file.c_str());
+	WriteMapCache(file.c_str(), "meta", _meta);
+}
+
+// Load object name mapping on the first lookup
+void SqlParser::LoadObjectMapping()
+{
+	std::string file = _object_map_file;
+	_object_map_file.clear();
+
+	delete _object_map_cache;
+	_object_map_cache = OpenMapCache(file.c_str(), "omap");
+
+	if(_object_map_cache != NULL)
+		return;
+
+	SetObjectMappingFromFile(file.c_str());
+	WriteMapCache(file.c_str(), "omap", _object_map);
+}
+
+// Open the compiled cache of the mapping file if it is up to date
+MapCache* SqlParser::OpenMapCache(const char *file, const char *type)
+{
+	if(_option_cache_dir.empty())
+		return NULL;
+
+	std::string cache_file;
+	MapCache::GetFileName(_option_cache_dir.c_str(), file, type, cache_file);
+
+	MapCache *cache = new MapCache();
+
+	if(cache->Open(cache_file.c_str(), file) == 0)
+		return cache;
 
-     if(i != _meta.end())
-     {
-         Meta *meta = i->second->GetFirstNoCurrent();
+	delete cache;
+	return NULL;
+}
 
-	     while(meta != NULL)
-	     {
-             if(_stricmp(meta->column.c_str(), col.str.c_str()) == 0)
-                 return meta->dtype.c_str();
+// Compile the mapping loaded from the file, so next runs can skip parsing it
+void SqlParser::WriteMapCache(const char *file, const char *type, StringMap &map)
+{
+	if(_option_cache_dir.empty())
+		return;
 
-		     meta = meta->next;
-         }
-     }
+	std::string cache_file;
+	MapCache::GetFileName(_option_cache_dir.c_str(), file, type, cache_file);
 
-     return NULL;
+	MapCache::Write(cache_file.c_str(), file, map);
 }
 
 // Schema name mapping in format s1:t1, s2:t2, s3, ...
@@ -569,23 +627,39 @@ void SqlParser::SetSchemaMapping(const char *mapping)
 // Map object name for identifier
 bool SqlParser::MapObjectName(Token *token)
 {
-	if(token == NULL)
+	if(token == NULL || token->str == NULL)
+		return false;
+
+	if(!_object_map_file.empty())
+		LoadObjectMapping();
+
+	if(_object_map.empty() && _object_map_cache == NULL)
 		return false;
 
-	// Find an identifier
-	for(StringMap::iterator i = _object_map.begin(); i != _object_map.end(); i++)
+	_meta_key.clear();
+	Str::AppendLower(_meta_key, token->str, token->len);
+
+	const char *target = NULL;
+
+	// Source names are in lower case
+	if(_object_map_cache != NULL)
+		target = _object_map_cache->Find(_meta_key.c_str(), _meta_key.size());
+	else
 	{
-		if(CompareIdentifiers(token, i->first.c_str()) == true)
-		{
-			// Change name
-			token->t_str = Str::GetCopy(i->second.c_str());
-			token->t_len = strlen(token->t_str);
+		StringMap::iterator i = _object_map.find(_meta_key);
 
-			return true;
-		}
-	}	
+		if(i != _object_map.end())
+			target = i->second.c_str();
+	}
 
-	return false;
+	if(target == NULL)
+		return false;
+
+	// Change name
+	token->t_str = Str::GetCopy(target);
+	token->t_len = strlen(token->t_str);
+
+	return true;
 }
 
 // Compare identifiers
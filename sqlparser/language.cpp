@@ -359,42 +359,32 @@ bool SqlParser::ConvertRecordVariable(Token *token)
 
 	bool exists = false;
 
-	ListwItem *item = _spl_rowtype_vars.GetFirst();
+	// Find the record name that is the prefix of rec.field identifier
+	Token *rec = _spl_rowtype_vars.FindPrefix(token, '.');
 
-	// Compare identifier prefix with existing record name
-	while(item != NULL)
+	if(rec != NULL)
 	{
-		Token *rec = (Token*)item->value;
-
-		// Check for rec. prefix
-		if(rec != NULL && Token::Compare(rec, token, rec->len) == true && 
-			token->Compare(".", L".", rec->len, 1) == true)
+		// Change to @rec_field in SQL Server, rec_field in MySQL
+		if(Target(SQL_SQL_SERVER, SQL_MARIADB, SQL_MYSQL) == true)
 		{
-			// Change to @rec_field in SQL Server, rec_field in MySQL
-			if(Target(SQL_SQL_SERVER, SQL_MARIADB, SQL_MYSQL) == true)
-			{
-				TokenStr ident;
-
-				if(_target == SQL_SQL_SERVER)
-					ident.Append("@", L"@", 1);
-
-				// Append record name _ and field name 
-				ident.Append(token, 0, rec->len);
-				ident.Append("_", L"_", 1);
-				ident.Append(token, rec->len + 1, token->len - rec->len - 1);
+			TokenStr ident;
 
-				Token::ChangeNoFormat(token, ident);
-			}
+			if(_target == SQL_SQL_SERVER)
+				ident.Append("@", L"@", 1);
 
-			// Save referenced record fields (once only)
-			if(Find(_spl_rowtype_fields, rec, token) == NULL)
-				_spl_rowtype_fields.Add(rec, token);
+			// Append record name _ and field name 
+			ident.Append(token, 0, rec->len);
+			ident.Append("_", L"_", 1);
+			ident.Append(token, rec->len + 1, token->len - rec->len - 1);
 
-			exists = true;
-			break;
+			Token::ChangeNoFormat(token, ident);
 		}
 
-		item = item->next;
+		// Save referenced record fields (once only)
+		if(Find(_spl_rowtype_fields, rec, token) == NULL)
+			_spl_rowtype_fields.Add(rec, token);
+
+		exists = true;
 	}
 
 	return exists;
@@ -0,0 +1,272 @@
+/**
+ * Copyright (c) 2016 SQLines
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// ListWS - Stores a list of name tokens with case-insensitive index (Symbol table), supports nested blocks
+
+#ifndef sqlines_listws_h
+#define sqlines_listws_h
+
+#include <ctype.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "token.h"
+#include "listw.h"
+
+class ListWS
+{
+	// Names in the order they were added
+	ListW list;
+
+	// Items for each name in the order they were added
+	std::map<std::string, std::vector<ListwItem*> > index;
+
+	// Number of names without string value (single char tokens i.e.), lookups scan the list then
+	int not_indexed;
+
+	// The last item before each open block
+	std::vector<ListwItem*> blocks;
+
+public:
+	ListWS()
+	{
+		not_indexed = 0;
+	}
+
+	// Delete all names and blocks
+	void DeleteAll()
+	{
+		list.DeleteAll();
+		index.clear();
+		blocks.clear();
+
+		not_indexed = 0;
+	}
+
+	// Add a name to the current block
+	void Add(Token *name)
+	{
+		list.Add(name);
+
+		std::string key;
+
+		if(GetKey(name, key) == true)
+			index[key].push_back(list.GetLast());
+		else
+			not_indexed++;
+	}
+
+	// Enter a block, its names are removed by LeaveBlock()
+	void EnterBlock()
+	{
+		blocks.push_back(list.GetLast());
+	}
+
+	// Leave the current block and remove its names
+	void LeaveBlock()
+	{
+		// No block entered, only outer names exist
+		if(blocks.empty())
+			return;
+
+		ListwItem *boundary = blocks.back();
+		blocks.pop_back();
+
+		ListwItem *since = (boundary != NULL) ? boundary->next : list.GetFirst();
+
+		if(since == NULL)
+			return;
+
+		// Block names are the last items for their keys
+		for(ListwItem *i = list.GetLast(); i != boundary; i = i->prev)
+		{
+			std::string key;
+
+			if(GetKey((Token*)i->value, key) == false)
+			{
+				not_indexed--;
+				continue;
+			}
+
+			std::map<std::string, std::vector<ListwItem*> >::iterator k = index.find(key);
+
+			if(k == index.end())
+				continue;
+
+			if(!k->second.empty() && k->second.back() == i)
+				k->second.pop_back();
+
+			if(k->second.empty())
+				index.erase(k);
+		}
+
+		list.DeleteSince(since);
+	}
+
+	// Find the name added first
+	Token* Find(Token *what)
+	{
+		if(what == NULL)
+			return NULL;
+
+		if(not_indexed > 0)
+		{
+			for(ListwItem *i = list.GetFirst(); i != NULL; i = i->next)
+				if(Token::Compare((Token*)i->value, what) == true)
+					return (Token*)i->value;
+
+			return NULL;
+		}
+
+		std::vector<ListwItem*> *items = Get(what);
+
+		return (items != NULL) ? (Token*)items->front()->value : NULL;
+	}
+
+	// Find the name added last (local block names have priority)
+	Token* FindLast(Token *what)
+	{
+		if(what == NULL)
+			return NULL;
+
+		if(not_indexed > 0)
+		{
+			for(ListwItem *i = list.GetLast(); i != NULL; i = i->prev)
+				if(Token::Compare((Token*)i->value, what) == true)
+					return (Token*)i->value;
+
+			return NULL;
+		}
+
+		std::vector<ListwItem*> *items = Get(what);
+
+		return (items != NULL) ? (Token*)items->back()->value : NULL;
+	}
+
+	// Find the name added first that is a prefix of the identifier followed by the delimiter (rec.field i.e.)
+	Token* FindPrefix(Token *what, char delimiter)
+	{
+		if(what == NULL || what->str == NULL)
+			return NULL;
+
+		if(not_indexed > 0)
+		{
+			for(ListwItem *i = list.GetFirst(); i != NULL; i = i->next)
+			{
+				Token *name = (Token*)i->value;
+
+				if(name != NULL && Token::Compare(name, what, name->len) == true &&
+					what->Compare(&delimiter, NULL, name->len, 1) == true)
+					return name;
+			}
+
+			return NULL;
+		}
+
+		ListwItem *found = NULL;
+		int candidates = 0;
+
+		for(size_t i = 0; i < what->len; i++)
+		{
+			if(what->str[i] != delimiter)
+				continue;
+
+			std::vector<ListwItem*> *items = Get(what->str, i);
+
+			if(items != NULL)
+			{
+				found = items->front();
+				candidates++;
+			}
+		}
+
+		// Several prefixes are names (a and a.b i.e.), return the one added first
+		if(candidates > 1)
+		{
+			for(ListwItem *i = list.GetFirst(); i != NULL; i = i->next)
+			{
+				Token *name = (Token*)i->value;
+
+				if(name != NULL && Token::Compare(name, what, name->len) == true &&
+					what->Compare(&delimiter, NULL, name->len, 1) == true)
+					return name;
+			}
+		}
+
+		return (found != NULL) ? (Token*)found->value : NULL;
+	}
+
+	// Get the first item
+	ListwItem* GetFirst()
+	{
+		return list.GetFirst();
+	}
+
+	// Get the last item
+	ListwItem* GetLast()
+	{
+		return list.GetLast();
+	}
+
+	// Get the total number of names
+	int GetCount()
+	{
+		return list.GetCount();
+	}
+
+private:
+	// Get the index key, only names compared by string value (Token::Compare) are indexed
+	static bool GetKey(Token *name, std::string &key)
+	{
+		if(name == NULL || name->str == NULL || name->chr != 0 || name->wchr != 0)
+			return false;
+
+		GetKey(name->str, name->len, key);
+		return true;
+	}
+
+	static void GetKey(const char *str, size_t len, std::string &key)
+	{
+		key.resize(len);
+
+		for(size_t i = 0; i < len; i++)
+			key[i] = (char)tolower((unsigned char)str[i]);
+	}
+
+	// Get items for the name
+	std::vector<ListwItem*>* Get(Token *what)
+	{
+		if(what->str == NULL)
+			return NULL;
+
+		return Get(what->str, what->len);
+	}
+
+	std::vector<ListwItem*>* Get(const char *str, size_t len)
+	{
+		std::string key;
+		GetKey(str, len, key);
+
+		std::map<std::string, std::vector<ListwItem*> >::iterator i = index.find(key);
+
+		if(i == index.end())
+			return NULL;
+
+		return &i->second;
+	}
+};
+
+#endif // sqlines_listws_h
@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2016 SQLines
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MapCache - Compiled cache of mapping files (-meta, -omapf) shared between runs
+
+#include <stdio.h>
+#include <string.h>
+#include "mapcache.h"
+#include "file.h"
+
+// Constructor
+MapCache::MapCache()
+{
+	_data = NULL;
+	_size = 0;
+	_entries = NULL;
+	_count = 0;
+	_pool = NULL;
+	_pool_size = 0;
+}
+
+MapCache::~MapCache()
+{
+	delete [] _data;
+}
+
+// Open the cache file if it was compiled from the current version of the source file
+int MapCache::Open(const char *file, const char *source)
+{
+	if(file == NULL || source == NULL)
+		return -1;
+
+	int size = File::GetFileSize(file);
+
+	if(size < (int)sizeof(MapCacheHeader))
+		return -1;
+
+	long long source_size = File::GetFileSize(source);
+	long long source_mtime = File::GetModifiedTime(source);
+
+	if(source_size == -1 || source_mtime == -1)
+		return -1;
+
+	char *data = new char[(size_t)size];
+
+	if(File::GetContent(file, data, (size_t)size) == -1)
+	{
+		delete [] data;
+		return -1;
+	}
+
+	MapCacheHeader *header = (MapCacheHeader*)data;
+	size_t entries_size = (header->count > 0) ? (size_t)header->count * sizeof(MapCacheEntry) : 0;
+
+	// Check the format, completeness and that the source file was not changed since the cache was compiled
+	bool valid = (memcmp(header->magic, MAPCACHE_MAGIC, sizeof(header->magic)) == 0 &&
+		header->version == MAPCACHE_VERSION && header->count >= 0 && header->size == size &&
+		sizeof(MapCacheHeader) + entries_size <= (size_t)size &&
+		header->source_size == source_size && header->source_mtime == source_mtime);
+
+	const char *pool = data + sizeof(MapCacheHeader) + entries_size;
+	size_t pool_size = (size_t)size - sizeof(MapCacheHeader) - entries_size;
+
+	// Check that the cache was compiled from the same path
+	if(valid)
+		valid = ((size_t)header->source_offset + header->source_len < pool_size &&
+			header->source_len == strlen(source) && memcmp(pool + header->source_offset, source, header->source_len) == 0);
+
+	if(!valid)
+	{
+		delete [] data;
+		return -1;
+	}
+
+	delete [] _data;
+
+	_data = data;
+	_size = (size_t)size;
+	_entries = (MapCacheEntry*)(data + sizeof(MapCacheHeader));
+	_count = header->count;
+	_pool = pool;
+	_pool_size = pool_size;
+
+	return 0;
+}
+
+// Find the value by key, entries are sorted by key
+const char* MapCache::Find(const char *key, size_t len)
+{
+	if(key == NULL || _count == 0)
+		return NULL;
+
+	int low = 0;
+	int high = _count - 1;
+
+	while(low <= high)
+	{
+		int mid = low + (high - low)/2;
+
+		MapCacheEntry *entry = &_entries[mid];
+
+		if((size_t)entry->key_offset + entry->key_len >= _pool_size)
+			return NULL;
+
+		size_t key_len = entry->key_len;
+		int rc = memcmp(_pool + entry->key_offset, key, (key_len < len) ? key_len : len);
+
+		if(rc == 0 && key_len != len)
+			rc = (key_len < len) ? -1 : 1;
+
+		if(rc == 0)
+		{
+			if((size_t)entry->value_offset + entry->value_len >= _pool_size)
+				return NULL;
+
+			return _pool + entry->value_offset;
+		}
+
+		if(rc < 0)
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+
+	return NULL;
+}
+
+// Compile the map to the cache file
+int MapCache::Write(const char *file, const char *source, std::map<std::string, std::string> &map)
+{
+	if(file == NULL || source == NULL)
+		return -1;
+
+	long long source_size = File::GetFileSize(source);
+	long long source_mtime = File::GetModifiedTime(source);
+
+	if(source_size == -1 || source_mtime == -1)
+		return -1;
+
+	MapCacheHeader header;
+	memset(&header, 0, sizeof(header));
+
+	memcpy(header.magic, MAPCACHE_MAGIC, sizeof(header.magic));
+	header.version = MAPCACHE_VERSION;
+	header.count = (int)map.size();
+	header.source_size = source_size;
+	header.source_mtime = source_mtime;
+
+	std::string entries;
+	std::string pool;
+
+	entries.reserve(map.size() * sizeof(MapCacheEntry));
+
+	header.source_offset = 0;
+	header.source_len = (unsigned int)strlen(source);
+
+	pool.append(source, header.source_len + 1);
+
+	// Map keys are already sorted in the lookup order
+	for(std::map<std::string, std::string>::iterator i = map.begin(); i != map.end(); i++)
+	{
+		MapCacheEntry entry;
+
+		entry.key_offset = (unsigned int)pool.size();
+		entry.key_len = (unsigned int)i->first.size();
+		pool.append(i->first.c_str(), i->first.size() + 1);
+
+		entry.value_offset = (unsigned int)pool.size();
+		entry.value_len = (unsigned int)i->second.size();
+		pool.append(i->second.c_str(), i->second.size() + 1);
+
+		entries.append((const char*)&entry, sizeof(entry));
+	}
+
+	header.size = (long long)(sizeof(header) + entries.size() + pool.size());
+
+	std::string content;
+	content.reserve((size_t)header.size);
+
+	content.append((const char*)&header, sizeof(header));
+	content.append(entries);
+	content.append(pool);
+
+	// Write to a temporary file first, so concurrent runs never read a partially written cache
+	std::string tmp;
+	File::GetTempName(file, tmp);
+
+	if(File::Write(tmp.c_str(), content.c_str(), content.size()) != (int)content.size())
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+#ifdef WIN32
+	// rename() does not replace an existing file on Windows
+	remove(file);
+#endif
+
+	if(rename(tmp.c_str(), file) != 0)
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+	return 0;
+}
+
+// Get the cache file name for the source file in the cache directory
+void MapCache::GetFileName(const char *dir, const char *source, const char *type, std::string &file)
+{
+	file.clear();
+
+	if(dir == NULL || source == NULL || type == NULL)
+		return;
+
+	std::string source_dir;
+	std::string source_file;
+
+	File::SplitDirectoryAndFile(source, source_dir, source_file);
+
+	// Files with the same name in different directories get different caches
+	unsigned int hash = 2166136261u;
+
+	for(const char *c = source; *c; c++)
+	{
+		hash ^= (unsigned char)*c;
+		hash *= 16777619u;
+	}
+
+	char hash_str[11];
+	sprintf(hash_str, "%08x", hash);
+
+	file = dir;
+
+	if(!file.empty() && file[file.size() - 1] != DIR_SEPARATOR_CHAR && file[file.size() - 1] != '/')
+		file += DIR_SEPARATOR_CHAR;
+
+	file += source_file;
+	file += '.';
+	file += type;
+	file += '.';
+	file += hash_str;
+	file += MAPCACHE_EXT;
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2016 SQLines
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MapCache - Compiled cache of mapping files (-meta, -omapf) shared between runs
+
+#ifndef sqlines_mapcache_h
+#define sqlines_mapcache_h
+
+#include <string>
+#include <map>
+
+#define MAPCACHE_MAGIC			"SQLINES_MAPCACHE"
+#define MAPCACHE_VERSION		1
+#define MAPCACHE_EXT			".mapcache"
+
+// Cache file header, followed by sorted entries and the string pool
+struct MapCacheHeader
+{
+	char magic[16];
+	int version;
+	// Number of entries
+	int count;
+	// Size of the cache file
+	long long size;
+	// Size and modification time of the source mapping file
+	long long source_size;
+	long long source_mtime;
+	// Source file path in the string pool
+	unsigned int source_offset;
+	unsigned int source_len;
+};
+
+// Key and value in the string pool, strings are terminated with '\x0'
+struct MapCacheEntry
+{
+	unsigned int key_offset;
+	unsigned int key_len;
+	unsigned int value_offset;
+	unsigned int value_len;
+};
+
+class MapCache
+{
+	// Content of the cache file
+	char *_data;
+	size_t _size;
+
+	MapCacheEntry *_entries;
+	int _count;
+
+	const char *_pool;
+	size_t _pool_size;
+
+public:
+	MapCache();
+	~MapCache();
+
+	// Open the cache file if it was compiled from the current version of the source file
+	int Open(const char *file, const char *source);
+
+	// Find the value by key, entries are sorted by key
+	const char* Find(const char *key, size_t len);
+
+	// Compile the map to the cache file
+	static int Write(const char *file, const char *source, std::map<std::string, std::string> &map);
+
+	// Get the cache file name for the source file in the cache directory
+	static void GetFileName(const char *dir, const char *source, const char *type, std::string &file);
+};
+
+#endif // sqlines_mapcache_h
@@ -30,6 +30,13 @@ Report::Report()
 	_report_snippets_path = SQLEXEC_REPORT_SNIPPETS;
 
     _summary = "";
+
+	_file = NULL;
+	_snippets_file = NULL;
+
+	_snippets_shard = 1;
+	_snippets_shard_file = NULL;
+	_snippets_size = 0;
 	
 	_source = 0;
 	_target = 0;
@@ -75,21 +82,38 @@ void Report::CreateReport(Stats *stats, int source, int target, const char *summ
 
 	const char *cur = tpl_input;
 
-    FILE *file = fopen(_report_path, "w+");
-	FILE *snippets_file = fopen(_report_snippets_path, "wb+");
+    _file = fopen(_report_path, "w+");
+	_snippets_file = fopen(_report_snippets_path, "wb+");
     
-    if(file == NULL)
+    if(_file == NULL)
     {
         printf("\n\nError: Cannot create report file %s", _report_path);
         return;
     }
 
-	if(snippets_file == NULL)
+	if(_snippets_file == NULL)
     {
         printf("\n\nError: Cannot create report snippets file %s", _report_snippets_path);
         return;
     }
 
+	setvbuf(_file, NULL, _IOFBF, SQLEXEC_REPORT_FILE_BUFFER);
+	setvbuf(_snippets_file, NULL, _IOFBF, SQLEXEC_REPORT_FILE_BUFFER);
+
+	_snippets_shard = 1;
+	_snippets_shard_path = _report_snippets_path;
+	_snippets_size = 0;
+
+	// Snippets shards start with the template styles
+	const char *body = strstr(tpl_input, "<body");
+
+	if(body != NULL && strchr(body, '>') != NULL)
+		_snippets_shard_head.assign(tpl_input, strchr(body, '>') + 1 - tpl_input);
+	else
+		_snippets_shard_head = "<html>\n<body>";
+
+	_snippets_shard_head += "\n";
+
     while(*cur != '\x0')
     {
         // Check for <?macro?> replacement macro
@@ -114,28 +138,115 @@ void Report::CreateReport(Stats *stats, int source, int target, const char *summ
 			{
 				GetReportSection(stats, macro, data, snippets); 
 
-				fprintf(file, "%s", data.c_str());
-				fprintf(snippets_file, "%s", snippets.c_str());
+				Flush(data, true);
+				FlushSnippets(snippets, true);
 			}
 
 			// Consume closing ?>
 			if(*cur == '?' && cur[1] == '>')
 				cur += 2;
        }
-       // Forward character to the report file as is
+       // Forward the text until the next macro to the report file as is
        else
        {
-			fputc(*cur, file);
-			fputc(*cur, snippets_file);
+			const char *start = cur;
+
+			while(*cur != '\x0' && !(cur[0] == '<' && cur[1] == '?'))
+				cur++;
 
-			cur++;
+			fwrite(start, 1, cur - start, _file);
+			fwrite(start, 1, cur - start, _snippets_file);
 		}
     }
 
 	delete tpl_input;
 
-    fclose(file);
-	fclose(snippets_file);
+	CloseSnippetsShard();
+
+	// Remove shards left by a previous larger report
+	for(int i = _snippets_shard + 1; ; i++)
+	{
+		char path[64];
+		sprintf(path, SQLEXEC_REPORT_SNIPPETS_SHARD, i);
+
+		if(remove(path) != 0)
+			break;
+	}
+
+    fclose(_file);
+	fclose(_snippets_file);
+
+	_file = NULL;
+	_snippets_file = NULL;
+}
+
+// Write the buffered content to the report file
+void Report::Flush(std::string &data, bool all)
+{
+	if(_file == NULL || data.empty() || (!all && data.size() < SQLEXEC_REPORT_BUFFER_SIZE))
+		return;
+
+	fwrite(data.c_str(), 1, data.size(), _file);
+	data.clear();
+}
+
+// Write the buffered snippets to the current snippets shard
+void Report::FlushSnippets(std::string &snippets, bool all)
+{
+	if(_snippets_file == NULL || snippets.empty() || (!all && snippets.size() < SQLEXEC_REPORT_BUFFER_SIZE))
+		return;
+
+	fwrite(snippets.c_str(), 1, snippets.size(), (_snippets_shard_file != NULL) ? _snippets_shard_file : _snippets_file);
+
+	_snippets_size += snippets.size();
+	snippets.clear();
+}
+
+// Get the file name of the snippets shard for the next item, start a new shard when the current one is full
+const char* Report::GetSnippetsPath(std::string &snippets)
+{
+	if(_snippets_size + snippets.size() < SQLEXEC_REPORT_SNIPPETS_SHARD_SIZE)
+		return _snippets_shard_path.c_str();
+
+	FlushSnippets(snippets, true);
+
+	char path[64];
+	sprintf(path, SQLEXEC_REPORT_SNIPPETS_SHARD, _snippets_shard + 1);
+
+	FILE *file = fopen(path, "wb+");
+
+	// Continue writing to the current shard
+	if(file == NULL)
+	{
+		printf("\n\nError: Cannot create report snippets file %s", path);
+
+		_snippets_size = 0;
+		return _snippets_shard_path.c_str();
+	}
+
+	CloseSnippetsShard();
+
+	setvbuf(file, NULL, _IOFBF, SQLEXEC_REPORT_FILE_BUFFER);
+	fwrite(_snippets_shard_head.c_str(), 1, _snippets_shard_head.size(), file);
+
+	_snippets_shard++;
+	_snippets_shard_file = file;
+	_snippets_shard_path = path;
+	_snippets_size = 0;
+
+	return _snippets_shard_path.c_str();
+}
+
+// Close the current snippets shard unless it is the snippets file created by template
+void Report::CloseSnippetsShard()
+{
+	if(_snippets_shard_file == NULL)
+		return;
+
+	fprintf(_snippets_shard_file, "\n</body>\n</html>\n");
+	fclose(_snippets_shard_file);
+
+	_snippets_shard_file = NULL;
 }
 
 // Check if there is data in section by name
@@ -739,7 +850,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
         sprintf(num, "%d", row);
         data += num;
         data += "</td><td><a href=\"";
-		data += _report_snippets_path;
+		data += GetSnippetsPath(snippets);
 		data += "#";
 		data += section;
 		data += "_";
@@ -914,7 +1025,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 		// Get code snippets
 		for(std::list<StatsSnippetItem>::iterator s = item.snippets.begin(); s != item.snippets.end(); s++, srow++)
 		{
-			StatsSnippetItem sitem = *s;
+			StatsSnippetItem &sitem = *s;
 
 			snippets += "<tr><td>";
 			sprintf(num, "%d", srow);
@@ -931,9 +1042,14 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 			snippets += "</pre>";
 
 			snippets += "</td></tr>\n";
+
+			FlushSnippets(snippets);
 		}
 
 		snippets += "</table>";
+
+		Flush(data);
+		FlushSnippets(snippets);
     }
 
     if(distinct != NULL)
@@ -960,7 +1076,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
         sprintf(num, "%d", row);
         data += num;
         data += "</td><td><a href=\"";
-		data += _report_snippets_path;
+		data += GetSnippetsPath(snippets);
 		data += "#";
 		data += section;
 		data += "_";
@@ -1058,7 +1174,7 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 		// Get code snippets
 		for(std::list<StatsSnippetItem>::iterator s = item.snippets.begin(); s != item.snippets.end(); s++, srow++)
 		{
-			StatsSnippetItem sitem = *s;
+			StatsSnippetItem &sitem = *s;
 
 			snippets += "<tr><td>";
 			sprintf(num, "%d", srow);
@@ -1075,9 +1191,14 @@ void Report::GetReportSectionRows(std::string section, std::map<std::string, Sta
 			snippets += "</pre>";
 
 			snippets += "</td></tr>\n";
+
+			FlushSnippets(snippets);
 		}
 
 		snippets += "</table>";
+
+		Flush(data);
+		FlushSnippets(snippets);
     }
 
     if(distinct != NULL)
@@ -1156,6 +1277,8 @@ void Report::GetReportSectionRows(std::map<std::string, StatsItem> &values, std:
 
         dist++;
         occur += (*i).second.occurrences;        
+
+		Flush(data);
     }
 
     if(distinct != NULL)
@@ -1188,6 +1311,8 @@ void Report::GetReportSectionRows(std::map<std::string, int> &values, std::strin
 
         dist++;
         occur += (*i).second;        
+
+		Flush(data);
     }
 
     if(distinct != NULL)
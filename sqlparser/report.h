@@ -19,6 +19,7 @@
 #ifndef sqlexec_report_h
 #define sqlexec_report_h
 
+#include <stdio.h>
 #include <string>
 #include <map>
 #include "stats.h"
@@ -27,6 +28,14 @@
 #define SQLEXEC_REPORT_SNIPPETS     "sqlines_report_snippets.html"
 #define SQLEXEC_REPORT_TEMPLATE     "sqlines_report.tpl"
 
+// Snippets that do not fit into the snippets file are written to sqlines_report_snippets_2.html and so on
+#define SQLEXEC_REPORT_SNIPPETS_SHARD       "sqlines_report_snippets_%d.html"
+#define SQLEXEC_REPORT_SNIPPETS_SHARD_SIZE  (32*1024*1024)
+
+// Report content is written to files when the buffer exceeds this size
+#define SQLEXEC_REPORT_BUFFER_SIZE  (64*1024)
+#define SQLEXEC_REPORT_FILE_BUFFER  (256*1024)
+
 #define SUFFIX(int_value)				((int_value == 1) ? "" : "s")
 #define SUFFIX2(int_value, str1, str2)	((int_value == 1) ? str1 : str2)
 
@@ -42,6 +51,19 @@ class Report
 
     const char *_summary;
 
+	// Report and snippets files
+	FILE *_file;
+	FILE *_snippets_file;
+
+	// Current snippets shard, 1 is the snippets file created by template
+	int _snippets_shard;
+	FILE *_snippets_shard_file;
+	std::string _snippets_shard_path;
+	size_t _snippets_size;
+
+	// Template content before the body, used to start snippets shards
+	std::string _snippets_shard_head;
+
 	// Source and target databases
 	int _source;
 	int _target;
@@ -60,6 +82,14 @@ public:
     void CreateReport(Stats *stats, int source, int target, const char *summary);
 
 private:
+	// Write the buffered content to the report file or the current snippets shard
+	void Flush(std::string &data, bool all = false);
+	void FlushSnippets(std::string &snippets, bool all = false);
+
+	// Get the file name of the snippets shard for the next item, start a new shard when the current one is full
+	const char* GetSnippetsPath(std::string &snippets);
+	void CloseSnippetsShard();
+
     // Fill the specified report section
     void GetReportSection(Stats *stats, std::string &macro, std::string &data, std::string &snippets); 
     void GetReportSectionRows(std::map<std::string, int> &values, std::string &data, int *distinct, int *occurrences);
@@ -20,10 +20,30 @@
 #include <string.h>
 #include "sqlparser.h"
 #include "str.h"
+#include "file.h"
 #include "cobol.h"
 
 char *g_symbols = (char*)" _\"'.,;:(){}[]=+-*<>!$~|~`@#%^&/\\\n\r\t";
 
+// Lookup table for g_symbols characters, filled before main() so parsers in different threads can share it
+static char g_symbols_map[256];
+
+static bool InitSymbolsMap()
+{
+	for(const char *c = g_symbols; *c != '\x0'; c++)
+		g_symbols_map[(unsigned char)*c] = 1;
+
+	// strchr() also finds the terminating zero, keep the same behavior
+	g_symbols_map[0] = 1;
+
+	return true;
+}
+
+static bool g_symbols_map_init = InitSymbolsMap();
+
+// Check whether the character is a symbol (ends a word), replaces strchr(g_symbols, c) != NULL
+inline bool IsSymbol(char c) { return g_symbols_map[(unsigned char)c] != 0; }
+
 // Not valid words as an alias (all databases)
 const char *g_no_alias[] =      {  "END",  "GO",  "ORDER",  "SELECT",  "WHERE", NULL };
 const wchar_t *g_no_alias_w[] = { L"END", L"GO", L"ORDER", L"SELECT", L"WHERE", NULL };
@@ -47,6 +67,7 @@ SqlParser::SqlParser()
 	_size = 0;
 	_remain_size = 0;
 	_line = 1;
+	_converted_tokens = 0;
 
 	ClearSplScope();
 
@@ -59,13 +80,25 @@ SqlParser::SqlParser()
 
     _stats = NULL;
     _report = NULL;
+	_file_stats = NULL;
 	_java = NULL;
 	_cobol = NULL;
 
 	_option_eval_mode = false;
+	_option_file_stats = false;
+
+	_meta_cache = NULL;
+	_object_map_cache = NULL;
 }
 
-SqlParser::~SqlParser() {}
+SqlParser::~SqlParser()
+{
+	delete _meta_cache;
+	delete _object_map_cache;
+	delete _file_stats;
+	delete _stats;
+	delete _report;
+}
 
 // Set target programming language
 void SqlParser::SetLang(const char *value, bool source)
@@ -112,13 +145,17 @@ void SqlParser::SetOption(const char *option, const char *value)
 	if(_stricmp(option, "-smap") == 0 && value != NULL)
 		SetSchemaMapping(value);
 	else
-	// Object mapping file
+	// Object mapping file (loaded on the first lookup)
 	if(_stricmp(option, "-omapf") == 0 && value != NULL)
-		SetObjectMappingFromFile(value);
+		_object_map_file = value;
     else
-	// Meta information about table columns
+	// Meta information about table columns (loaded on the first lookup)
 	if(_stricmp(option, "-meta") == 0 && value != NULL)
-		SetMetaFromFile(value);
+		_meta_file = value;
+	else
+	// Directory for compiled mapping caches
+	if(_stricmp(option, "-cache") == 0 && value != NULL)
+		_option_cache_dir = value;
 	else
 	// Object mapping file
 	if(_stricmp(option, "-fspmapf") == 0 && value != NULL)
@@ -148,6 +185,10 @@ void SqlParser::SetOption(const char *option, const char *value)
 	else
 	if(_stricmp(option, "__eval_mode__") == 0 && value != NULL)
 		_option_eval_mode = true;
+	else
+	// Keep statistics of each file separately, they are merged by another parser in file order
+	if(_stricmp(option, "__file_stats__") == 0 && value != NULL)
+		_option_file_stats = true;
 }
 
 // Perform conversion
@@ -164,6 +205,22 @@ int SqlParser::Convert(const char *input, int size, const char **output, int *ou
 
 	ClearSplScope();
 
+	Stats *stats = _stats;
+
+	// Collect statistics for the file separately, so they can be saved to the cache or merged by another parser
+	if(_stats != NULL && (!_option_cache_dir.empty() || _option_file_stats))
+	{
+		delete _file_stats;
+
+		_file_stats = new Stats();
+		_file_stats->SetSourceFile(_option_cur_file.c_str());
+
+		// Function calls are logged when statistics are merged in file order, and saved to the cache with them
+		_file_stats->SetFuncCallsBuffered();
+
+		_stats = _file_stats;
+	}
+
 	// Byte order mark for Unicode
 	GetBomToken();
 
@@ -194,8 +251,18 @@ int SqlParser::Convert(const char *input, int size, const char **output, int *ou
 	_spl_obj_type_table.DeleteAll();
 
 	_bookmarks.DeleteAll();
+
+	_converted_tokens = _tokens.GetCount();
 	_tokens.DeleteAll();
 
+	if(_stats != stats)
+	{
+		if(!_option_file_stats)
+			stats->Merge(_stats);
+
+		_stats = stats;
+	}
+
 	if(lines != NULL)
 		*lines = _line;
 
@@ -753,7 +820,7 @@ bool SqlParser::GetSingleCharToken(Token *token)
 			break;
 
 		// Return if not a single char
-		if(strchr(g_symbols, *cur) == NULL)
+		if(!IsSymbol(*cur))
 			break;
 
 		_next_start++;
@@ -812,54 +879,21 @@ Token* SqlParser::GetVariable(Token *name)
 	if(name == NULL || _spl_variables.GetCount() == 0)
 		return NULL;
 
-	Token *token = NULL;
-
-	// Start from the end of list as the local block variables have priority
-	for(ListwItem *i = _spl_variables.GetLast(); i != NULL; i = i->prev)
-	{
-		// Local block boundary
-		if(i->value == (void*)-3)
-			continue;
-
-		if(Token::Compare((Token*)i->value, name) == true)
-		{
-			token = (Token*)i->value;
-			break;
-		}
-	}
-
-	return token;
+	// The local block variables have priority
+	return _spl_variables.FindLast(name);
 }
 
 // Enter a block with own local variables
 void SqlParser::EnterLocalVariablesBlock()
 {
-	// -3 block boundary
-	_spl_variables.Add((void*)-3);
+	_spl_variables.EnterBlock();
 }
 
 // Leave the block with own local variables
 void SqlParser::LeaveLocalVariablesBlock()
 {
-	ListwItem *boundary = NULL;
-
-	// Find the last boundary
-	for(ListwItem *i = _spl_variables.GetLast(); i != NULL; i = i->prev)
-	{
-		// Local block boundary
-		if(i->value == (void*)-3)
-		{
-			boundary = i;
-			break;
-		}
-	}
-
-	// No boundary found, only outer variable block set
-	if(boundary == NULL)
-		return;
-
 	// Remove local block variables
-	_spl_variables.DeleteSince(boundary);
+	_spl_variables.LeaveBlock();
 }
 
 // Get a procedure or function parameter by name
@@ -868,19 +902,7 @@ Token* SqlParser::GetParameter(Token *name)
 	if(name == NULL || _spl_parameters.GetCount() == 0)
 		return NULL;
 
-	Token *token = NULL;
-
-	// Find the parameter
-	for(ListwItem *i = _spl_parameters.GetFirst(); i != NULL; i = i->next)
-	{
-		if(Token::Compare((Token*)i->value, name) == true)
-		{
-			token = (Token*)i->value;
-			break;
-		}
-	}
-
-	return token;
+	return _spl_parameters.Find(name);
 }
 
 // Get variable or parameter
@@ -961,7 +983,7 @@ bool SqlParser::GetQuotedIdentifier(Token *token, bool starts_as_unquoted)
 			while(_remain_size > 0)
 			{
 				// Check whether we meet a special character allowed in identifiers (:NEW.name i.e.)
-				if(strchr(g_symbols, *cur) != NULL && *cur != '_' && *cur != ':')
+				if(IsSymbol(*cur) && *cur != '_' && *cur != ':')
 					break;
 		
 				cur++;
@@ -1481,112 +1503,124 @@ bool SqlParser::GetWordToken(Token *token)
 			continue;
 		}
 
-		// Check whether we meet a special character allowed in identifiers
-		if(strchr(g_symbols, *cur) != NULL)
+		// Consume the run of regular word characters at once
+		if(!IsSymbol(*cur))
 		{
-			// @variable in SQL Server and MySQL, :new in Oracle trigger, #temp table name in SQL Server
-			// * meaning all columns, - in COBOL identifier, label : label name in DB2
-            // $ or $$ often used as replacement markers, $ is also allowed in Oracle identifiers
-			if(*cur != '_' && *cur != '.' && *cur != '@' && *cur != ':' && *cur != '#' && *cur != '*' && 
-					*cur != '-' && *cur != '"' && *cur != '[' && *cur != ' ' && *cur != '&' && *cur != '$')
-				break;
+			const char *run = cur;
 
-			// Spaces are allowed between identifier parts: table . name 
-			if(*cur == ' ')
+			while(_remain_size > 0 && !IsSymbol(*cur))
 			{
-				int ident_len = 0;
-
-				for(int i = 0; i < _remain_size - 1; i++)
-				{
-					if(cur[i] == ' ' || cur[i] == '\t' || cur[i] == '\n' || cur[i] == '\r')
-						continue;
-
-					if(cur[i] == '.')
-						ident_len = i;
-
-					break;
-				}
+				_remain_size--;
+				cur++;
+			}
 
-				// Not a multi-part identifier
-				if(len == 0 || ident_len == 0)
-					break;
+			len += (size_t)(cur - run);
+			continue;
+		}
 
-				_remain_size -= ident_len;
-				cur += ident_len;
-				len += ident_len;
+		// Special character allowed in identifiers
+		// @variable in SQL Server and MySQL, :new in Oracle trigger, #temp table name in SQL Server
+		// * meaning all columns, - in COBOL identifier, label : label name in DB2
+        // $ or $$ often used as replacement markers, $ is also allowed in Oracle identifiers
+		if(*cur != '_' && *cur != '.' && *cur != '@' && *cur != ':' && *cur != '#' && *cur != '*' && 
+				*cur != '-' && *cur != '"' && *cur != '[' && *cur != ' ' && *cur != '&' && *cur != '$')
+			break;
 
-				continue;
-			}
+		// Spaces are allowed between identifier parts: table . name 
+		if(*cur == ' ')
+		{
+			int ident_len = 0;
 
-			// .. in numeric range 1..10 (FOR loop i.e)
-			if(!Source(SQL_SQL_SERVER, SQL_SYBASE) && *cur == '.')
+			for(int i = 0; i < _remain_size - 1; i++)
 			{
-				// first . followed by second
-				if(_remain_size > 1 && cur[1] == '.')
-					break;
-				else
-				// second . 
-				if(cur > _start && cur[-1] == '.')
-					break;
-			}
+				if(cur[i] == ' ' || cur[i] == '\t' || cur[i] == '\n' || cur[i] == '\r')
+					continue;
 
-			// * must be after . to not confuse with multiplication operator
-			if(*cur == '*' && (len == 0 || (len > 0 && cur > _start && cur[-1] != '.')))
-				break;
+				if(cur[i] == '.')
+					ident_len = i;
 
-			// Check for partially quoted identifier that starts as a word then quoted part follows
-			if(*cur == '"' || *cur == '[')
-			{
-				if(len > 0 && cur > _start && cur[-1] == '.')
-					partially_quoted_identifier = true;
-				
 				break;
 			}
 
-			if(*cur == ':')
-			{
-				// But := also means assigment in Oracle (space is not allowed between : and =)
-				if((_remain_size > 1 && cur[1] == '=') ||
-				  // In DB2, Teradata, MySQL : used in label, and label:BEGIN (without spaces) or 
-				  // label :BEGIN is correct, but :param can be also used in scripts
-				  (Source(SQL_DB2, SQL_TERADATA, SQL_MYSQL) == true && 
-						IsScope(SQL_SCOPE_SELECT_STMT) == false) ||
-				  // In Informix, PostgreSQL :: is data type cast operator
-				  (_remain_size > 1 && cur[1] == ':') || (cur > _start && cur[-1] == ':'))
+			// Not a multi-part identifier
+			if(len == 0 || ident_len == 0)
 				break;
-			}
 
-			// : can follow after label in DB2
-			//if(*cur == ':' && len == 0 && _remain_size > 1 && Str::IsSpace(cur[1]) == true)
-			//	break;
+			_remain_size -= ident_len;
+			cur += ident_len;
+			len += ident_len;
 
-			// & used as parameter marker in scripts i.e. SQL*Plus, must be at the first position
-			if(*cur == '&' && len != 0)
-				break;
+			continue;
+		}
 
-			// Allow - in COBOL only
-			if(*cur == '-' && _source_app != APP_COBOL && _level != LEVEL_APP)
+		// .. in numeric range 1..10 (FOR loop i.e)
+		if(!Source(SQL_SQL_SERVER, SQL_SYBASE) && *cur == '.')
+		{
+			// first . followed by second
+			if(_remain_size > 1 && cur[1] == '.')
+				break;
+			else
+			// second . 
+			if(cur > _start && cur[-1] == '.')
 				break;
+		}
 
-			bool right = true;
+		// * must be after . to not confuse with multiplication operator
+		if(*cur == '*' && (len == 0 || (len > 0 && cur > _start && cur[-1] != '.')))
+			break;
 
-			// @ must not be followed by a blank or delimiter
-			if(*cur == '@')
-			{
-				// Remain size not decremented yet
-				if(_remain_size == 1 || 
-					(_remain_size > 1 && (cur[1] == ' ' || cur[1] == '\r' || cur[1] == '\n' || cur[1] == '\t')))
-					right = false;
-			}
-			else
-			// . is the statement delimiter in COBOL
-			if(_source_app == APP_COBOL && _level == LEVEL_APP && *cur == '.')
-				right = false;
+		// Check for partially quoted identifier that starts as a word then quoted part follows
+		if(*cur == '"' || *cur == '[')
+		{
+			if(len > 0 && cur > _start && cur[-1] == '.')
+				partially_quoted_identifier = true;
+			
+			break;
+		}
 
-			if(right == false)
-				break;
+		if(*cur == ':')
+		{
+			// But := also means assigment in Oracle (space is not allowed between : and =)
+			if((_remain_size > 1 && cur[1] == '=') ||
+			  // In DB2, Teradata, MySQL : used in label, and label:BEGIN (without spaces) or 
+			  // label :BEGIN is correct, but :param can be also used in scripts
+			  (Source(SQL_DB2, SQL_TERADATA, SQL_MYSQL) == true && 
+					IsScope(SQL_SCOPE_SELECT_STMT) == false) ||
+			  // In Informix, PostgreSQL :: is data type cast operator
+			  (_remain_size > 1 && cur[1] == ':') || (cur > _start && cur[-1] == ':'))
+			break;
 		}
 
+		// : can follow after label in DB2
+		//if(*cur == ':' && len == 0 && _remain_size > 1 && Str::IsSpace(cur[1]) == true)
+		//	break;
+
+		// & used as parameter marker in scripts i.e. SQL*Plus, must be at the first position
+		if(*cur == '&' && len != 0)
+			break;
+
+		// Allow - in COBOL only
+		if(*cur == '-' && _source_app != APP_COBOL && _level != LEVEL_APP)
+			break;
+
+		bool right = true;
+
+		// @ must not be followed by a blank or delimiter
+		if(*cur == '@')
+		{
+			// Remain size not decremented yet
+			if(_remain_size == 1 || 
+				(_remain_size > 1 && (cur[1] == ' ' || cur[1] == '\r' || cur[1] == '\n' || cur[1] == '\t')))
+				right = false;
+		}
+		else
+		// . is the statement delimiter in COBOL
+		if(_source_app == APP_COBOL && _level == LEVEL_APP && *cur == '.')
+			right = false;
+
+		if(right == false)
+			break;
+
 		_remain_size--;
 		cur++;
 		len++;
@@ -1603,7 +1637,7 @@ bool SqlParser::GetWordToken(Token *token)
 	{
 		// If a single special character was selected in the right position, but no more characters followed
 		// do not return as word
-		if(len == 1 && (strchr(g_symbols, *_next_start) != NULL ||
+		if(len == 1 && (IsSymbol(*_next_start) ||
 			// Also skip N'literal' in SQL Server
 			(*_next_start == 'N' && _remain_size > 1 && *cur == '\'')))
 		{
@@ -2396,3 +2430,81 @@ int SqlParser::CreateReport(const char *summary)
 
     return -1;
 }
+
+// Save statistics of the last converted file to the cache
+int SqlParser::SaveFileStats(const char *key, int lines)
+{
+	if(_file_stats == NULL || key == NULL)
+		return -1;
+
+	std::string file;
+	GetFileStatsName(key, file);
+
+	return _file_stats->Write(file.c_str(), lines);
+}
+
+// Add statistics of an unchanged file from the cache
+int SqlParser::LoadFileStats(const char *key, int *lines)
+{
+	if(_stats == NULL || key == NULL || _option_cache_dir.empty())
+		return -1;
+
+	std::string file;
+	GetFileStatsName(key, file);
+
+	// Statistics are merged by another parser in file order
+	if(_option_file_stats)
+	{
+		delete _file_stats;
+		_file_stats = new Stats();
+
+		if(_file_stats->Read(file.c_str(), lines) == -1)
+		{
+			delete _file_stats;
+			_file_stats = NULL;
+
+			return -1;
+		}
+
+		return 0;
+	}
+
+	Stats stats;
+
+	if(stats.Read(file.c_str(), lines) == -1)
+		return -1;
+
+	_stats->Merge(&stats);
+	return 0;
+}
+
+// Get statistics of the last converted file, the caller owns them
+Stats* SqlParser::DetachFileStats()
+{
+	Stats *stats = _file_stats;
+	_file_stats = NULL;
+
+	return stats;
+}
+
+// Add statistics of a file converted by another parser
+int SqlParser::MergeFileStats(Stats *stats)
+{
+	if(_stats == NULL || stats == NULL)
+		return -1;
+
+	_stats->Merge(stats, true);
+	return 0;
+}
+
+// Get the cache file name for statistics
+void SqlParser::GetFileStatsName(const char *key, std::string &file)
+{
+	file = _option_cache_dir;
+
+	if(!file.empty() && file[file.size() - 1] != DIR_SEPARATOR_CHAR && file[file.size() - 1] != '/')
+		file += DIR_SEPARATOR_CHAR;
+
+	file += key;
+	file += SQLEXEC_STATS_EXT;
+}
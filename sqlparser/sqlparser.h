@@ -27,6 +27,8 @@
 #include "listt.h"
 #include "listw.h"
 #include "listwm.h"
+#include "listws.h"
+#include "mapcache.h"
 #include "doc.h"
 #include "java.h"
 
@@ -256,26 +258,6 @@ struct CopyPaste
 	CopyPaste() { scope = 0; type = 0; name = NULL; next = NULL; prev = NULL; }
 };
 
-// Metadata information
-class Meta
-{
-public:
-    // Table, view, procedure name
-    std::string object;
-    // Column or parameter
-	std::string column;
-    // Data type
-    std::string dtype;
-
-    Meta(std::string o, std::string c, std::string dt) 
-    { 
-        object = o; column = c; dtype = dt; prev = next = NULL; 
-    }
-
-    Meta *prev;
-	Meta *next;
-};
-
 class SqlParser
 {
 	// Source and target SQL dialects
@@ -303,14 +285,22 @@ class SqlParser
 
 	// Input tokens
 	ListT<Token> _tokens;
+	// Number of tokens in the last converted input, including spaces, comments and inserted tokens
+	int _converted_tokens;
 
 	// Bookmarks
 	ListT<Book> _bookmarks;
 	// Copy, Paste and Cut blocks
 	ListT<CopyPaste> _copypaste;
 
-    // Metadata information
-    std::map<std::string, ListT<Meta>*> _meta;
+    // Metadata information, data types by lower case object,column
+    StringMap _meta;
+	// Compiled metadata if loaded from the cache
+	MapCache *_meta_cache;
+	// Metadata file to load on the first lookup
+	std::string _meta_file;
+	// Key buffer for metadata and object name lookups
+	std::string _meta_key;
 
 	// Scope list
 	ListWM _scope;
@@ -327,8 +317,8 @@ class SqlParser
 	bool _spl_external;
 
 	// Current variables and parameters
-	ListW _spl_variables;
-	ListW _spl_parameters;
+	ListWS _spl_variables;
+	ListWS _spl_parameters;
 
 	// Outer BEGIN keyword
     Token *_spl_outer_begin;
@@ -383,7 +373,7 @@ class SqlParser
 	// Variables generated for Oracle PL/SQL parameters
 	ListWM _spl_cursor_vars;
 	// The names and definitions of declared cursors
-	ListW _spl_declared_cursors;
+	ListWS _spl_declared_cursors;
 	ListW _spl_declared_cursors_using_vars;
 	ListWM _spl_declared_cursors_stmts;
 	// Current declaring cursor
@@ -402,7 +392,7 @@ class SqlParser
 	Token *_spl_package_spec;
 	Token *_spl_package;
 	// Declared record variables %ROWTYPE
-	ListW _spl_rowtype_vars;
+	ListWS _spl_rowtype_vars;
 	// Referenced %ROWTYPE record fields
 	ListWM _spl_rowtype_fields;
 	// Fetch into record referenced
@@ -518,15 +508,21 @@ class SqlParser
 	std::string _option_set_explicit_schema;
 	std::string _option_cur_file;
 	bool _option_eval_mode;
+	std::string _option_cache_dir;
+	bool _option_file_stats;
 
 	// Mappings
 	StringMap _object_map;
+	MapCache *_object_map_cache;
+	std::string _object_map_file;
 	StringMap _schema_map;
 	StringMap _func_to_sp_map;
 
     // Statistics and report
     Stats *_stats;
     Report *_report;
+	// Statistics of the current file when they are saved to the cache or merged in file order (parallel assessment)
+	Stats *_file_stats;
 
 	// Application scope
 	Java *_java;
@@ -545,6 +541,8 @@ public:
 
 	// Perform conversion
 	int Convert(const char *input, int size, const char **output, int *out_size, int *lines);
+	// Get the number of tokens in the last converted input
+	int GetConvertedTokens() { return _converted_tokens; }
 
 	// Generate output
 	void CreateOutputString(const char **output, int *out_size);
@@ -1535,6 +1533,12 @@ public:
     void SetMetaFromFile(const char *file);
 	void SetFuncToSpMappingFromFile(const char *file);
 
+	// Load mapping files on the first lookup, use compiled caches if -cache is set
+	void LoadMeta();
+	void LoadObjectMapping();
+	MapCache* OpenMapCache(const char *file, const char *type);
+	void WriteMapCache(const char *file, const char *type, StringMap &map);
+
 	// Map object name for identifier
 	bool MapObjectName(Token *token);
 
@@ -1552,6 +1556,15 @@ public:
     // Create report file
     int CreateReport(const char *summary); 
 
+	// Save statistics of the last converted file to the cache, or add statistics of an unchanged file from the cache
+	int SaveFileStats(const char *key, int lines);
+	int LoadFileStats(const char *key, int *lines);
+	void GetFileStatsName(const char *key, std::string &file);
+
+	// Get statistics of the last converted file (the caller owns them), and add them to the statistics of all files
+	Stats* DetachFileStats();
+	int MergeFileStats(Stats *stats);
+
 	// Check if the conversion running in evaluation mode and add comment
 	void AddEvalModeComment(Token *token);
 };
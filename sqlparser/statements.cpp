@@ -3845,7 +3845,7 @@ bool SqlParser::ParseExecuteStatement(Token *execute)
 			// Check for procedure call
 			if(exp == exp_end && (exp->type == TOKEN_IDENT || exp->type == TOKEN_WORD))
 			{
-				if(Find(_spl_variables, exp) == NULL)
+				if(_spl_variables.Find(exp) == NULL)
 					exec_sp = true;
 			}
 		}
@@ -5507,7 +5507,7 @@ bool SqlParser::ParseFetchStatement(Token *fetch)
 			break;
 
 		// Check for a fetch into a record variable
-		Token *rec = Find(_spl_rowtype_vars, var);
+		Token *rec = _spl_rowtype_vars.Find(var);
 
 		if(rec != NULL)
 		{
@@ -5654,7 +5654,7 @@ bool SqlParser::ParseForStatement(Token *for_, int scope)
 	if(select == NULL && !range_loop)
 	{
 		// Check if a cursor with such name was declared
-		if(Find(_spl_declared_cursors, first) != NULL)
+		if(_spl_declared_cursors.Find(first) != NULL)
 		{
 			cursor = first;
 			cursor_loop = true;
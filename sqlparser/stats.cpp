@@ -15,8 +15,10 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <algorithm>
 #include "stats.h"
+#include "file.h"
 
 // Increment stats summary item
 void StatsSummaryItem::Inc(int conv_status) 
@@ -168,9 +170,19 @@ int StatsSummaryItem::GetMostCritical()
 }
 
 // Constructor/destructor
-Stats::Stats() {}
+Stats::Stats()
+{
+	_func_calls_file = NULL;
+	_func_calls_buffered = false;
+
+	RegisterMaps();
+}
 
-Stats::~Stats() {}
+Stats::~Stats()
+{
+	if(_func_calls_file != NULL)
+		fclose(_func_calls_file);
+}
 
 // Log function call with all nested expressions
 void Stats::LogFuncCall(Token *name, Token *end, std::string &cur_file)
@@ -178,101 +190,158 @@ void Stats::LogFuncCall(Token *name, Token *end, std::string &cur_file)
 	if(name == NULL || end == NULL)
 		return;
 
-	static bool first_call = true;
+	// Open the log once and write records through a large buffer
+	if(_func_calls_file == NULL && !_func_calls_buffered)
+	{
+		_func_calls_file = fopen(SQLEXEC_STAT_FILE, "w");
+
+		if(_func_calls_file == NULL)
+			return;
 
-	const char *openMode = first_call ? "w" : "a";
+		setvbuf(_func_calls_file, NULL, _IOFBF, SQLEXEC_STAT_FILE_BUFFER);
+	}
 
-	FILE *file = fopen(SQLEXEC_STAT_FILE, openMode);
+	FILE *file = _func_calls_file;
 
-	if(file != NULL)
+	// Line and source name
+	if(_func_calls_buffered)
 	{
-		// Line and source name
+		char line[12];
+		sprintf(line, "%d", name->line);
+
+		_func_calls_buffer += cur_file;
+		_func_calls_buffer += ',';
+		_func_calls_buffer += line;
+		_func_calls_buffer += ',';
+		_func_calls_buffer.append(name->str, name->len);
+		_func_calls_buffer += ',';
+	}
+	else
 		fprintf(file, "%s,%d,%.*s,", cur_file.c_str(), name->line, (int)name->len, name->str);
 
-		std::string src, src_meta;
-		std::string tgt, tgt_meta;
+	std::string &src = _func_call_src;
+	std::string &tgt = _func_call_tgt;
+	std::string &src_meta = _func_call_src_meta;
+	std::string &tgt_meta = _func_call_tgt_meta;
 
-		Token *cur = name;
+	src.clear();
+	tgt.clear();
+	src_meta.clear();
+	tgt_meta.clear();
 
-		// Build source and target strings
-		while(true)
-		{
-			const char *meta = GetMetaIdent(cur);
+	Token *cur = name;
 
-			// Source expression
-			if(!(cur->flags & TOKEN_INSERTED))
+	// Build source and target strings
+	while(true)
+	{
+		const char *meta = GetMetaIdent(cur);
+
+		// Source expression
+		if(!(cur->flags & TOKEN_INSERTED))
+		{
+			if(cur->str != NULL)
 			{
-				if(cur->str != NULL)
-				{
-					src.append(cur->str, cur->len);
-
-					if(meta != NULL)
-						src_meta.append(meta);
-					else
-						src_meta.append(cur->str, cur->len);
-				}
-				else
-				if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
-				{
-					src += ' ';
-					src_meta += ' ';
-				}
+				src.append(cur->str, cur->len);
+
+				if(meta != NULL)
+					src_meta.append(meta);
 				else
-				{
-					src += cur->chr;
-					src_meta += cur->chr;
-				}
+					src_meta.append(cur->str, cur->len);
+			}
+			else
+			if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
+			{
+				src += ' ';
+				src_meta += ' ';
+			}
+			else
+			{
+				src += cur->chr;
+				src_meta += cur->chr;
 			}
+		}
 
-			// Target expression
-			if(!(cur->flags & TOKEN_REMOVED))
+		// Target expression
+		if(!(cur->flags & TOKEN_REMOVED))
+		{
+			if(cur->t_str != NULL)
 			{
-				if(cur->t_str != NULL)
-				{
-					tgt.append(cur->t_str, cur->t_len);
-
-					if(meta != NULL)
-						tgt_meta.append(meta);
-					else
-						tgt_meta.append(cur->t_str, cur->t_len);
-				}
-				else
-				if(cur->str != NULL)
-				{
-					tgt.append(cur->str, cur->len);
-
-					if(meta != NULL)
-						tgt_meta.append(meta);
-					else
-						tgt_meta.append(cur->str, cur->len);
-				}
+				tgt.append(cur->t_str, cur->t_len);
+
+				if(meta != NULL)
+					tgt_meta.append(meta);
 				else
-				if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
-				{
-					tgt += ' ';
-					tgt_meta += ' ';
-				}
+					tgt_meta.append(cur->t_str, cur->t_len);
+			}
+			else
+			if(cur->str != NULL)
+			{
+				tgt.append(cur->str, cur->len);
+
+				if(meta != NULL)
+					tgt_meta.append(meta);
 				else
-				{
-					tgt += cur->chr;
-					tgt_meta += cur->chr;
-				}
+					tgt_meta.append(cur->str, cur->len);
 			}
+			else
+			if(cur->chr == '\r' || cur->chr == '\n' || cur->chr == '\t')
+			{
+				tgt += ' ';
+				tgt_meta += ' ';
+			}
+			else
+			{
+				tgt += cur->chr;
+				tgt_meta += cur->chr;
+			}
+		}
 
-			if(cur == end)
-				break;
+		if(cur == end)
+			break;
 
-			cur = cur->next;
-		}
-		
-		fprintf(file, "<sqlines>%s</sqlines>,<sqlines>%s</sqlines>,<sqlines>%s</sqlines>,<sqlines>%s</sqlines>", src.c_str(), tgt.c_str(), 
+		cur = cur->next;
+	}
+	
+	if(_func_calls_buffered)
+	{
+		_func_calls_buffer += "<sqlines>";
+		_func_calls_buffer += src;
+		_func_calls_buffer += "</sqlines>,<sqlines>";
+		_func_calls_buffer += tgt;
+		_func_calls_buffer += "</sqlines>,<sqlines>";
+		_func_calls_buffer += src_meta;
+		_func_calls_buffer += "</sqlines>,<sqlines>";
+		_func_calls_buffer += tgt_meta;
+		_func_calls_buffer += "</sqlines>\n";
+	}
+	else
+		fprintf(file, "<sqlines>%s</sqlines>,<sqlines>%s</sqlines>,<sqlines>%s</sqlines>,<sqlines>%s</sqlines>\n", src.c_str(), tgt.c_str(), 
 			src_meta.c_str(), tgt_meta.c_str());
+}
+
+// Write function call records to the log
+void Stats::LogFuncCalls(const char *records, size_t len)
+{
+	if(records == NULL || len == 0)
+		return;
 
-		fprintf(file, "\n");
-		fclose(file);
+	if(_func_calls_buffered)
+	{
+		_func_calls_buffer.append(records, len);
+		return;
+	}
+
+	if(_func_calls_file == NULL)
+	{
+		_func_calls_file = fopen(SQLEXEC_STAT_FILE, "w");
+
+		if(_func_calls_file == NULL)
+			return;
+
+		setvbuf(_func_calls_file, NULL, _IOFBF, SQLEXEC_STAT_FILE_BUFFER);
 	}
 
-	first_call = false;
+	fwrite(records, 1, len, _func_calls_file);
 }
 
 // Get meta type for the specified identificator
@@ -556,3 +625,474 @@ StatsSnippetItem::StatsSnippetItem(std::string &f, Token *start, Token *end)
 		snippet.assign(start->next_start - 1, (unsigned int)(1 + start->remain_size - end->remain_size));
 }
 
+// Register all collections, the order defines the layout of saved statistics
+void Stats::RegisterMaps()
+{
+	_summary_maps.push_back(&_data_types);
+	_summary_maps.push_back(&_udt_data_types);
+	_summary_maps.push_back(&_builtin_func);
+	_summary_maps.push_back(&_udf_func);
+	_summary_maps.push_back(&_sequences);
+	_summary_maps.push_back(&_system_proc);
+	_summary_maps.push_back(&_statements);
+	_summary_maps.push_back(&_pl_statements);
+	_summary_maps.push_back(&_packages);
+
+	_detail_maps.push_back(&_udt_data_types_dtl);
+	_detail_maps.push_back(&_builtin_func_dtl);
+	_detail_maps.push_back(&_sequences_dtl);
+	_detail_maps.push_back(&_sequences_opt_dtl);
+	_detail_maps.push_back(&_sequences_ref);
+	_detail_maps.push_back(&_sequences_ref_dtl);
+	_detail_maps.push_back(&_system_proc_dtl);
+	_detail_maps.push_back(&_select_statements_dtl);
+	_detail_maps.push_back(&_crproc_statements_dtl);
+	_detail_maps.push_back(&_pl_statements_exceptions);
+	_detail_maps.push_back(&_pkg_statements_items);
+
+	_item_maps.push_back(&_data_types_dtl);
+
+	_count_maps.push_back(&_crtab_statements);
+	_count_maps.push_back(&_alttab_statements);
+	_count_maps.push_back(&_quoted_idents);
+	_count_maps.push_back(&_non_7bit_ascii_idents);
+	_count_maps.push_back(&_strings);
+	_count_maps.push_back(&_numbers);
+	_count_maps.push_back(&_words);
+	_count_maps.push_back(&_delimiters);
+}
+
+// Add statistics collected for another file, the result is the same as if both files were processed by one object
+void Stats::Merge(Stats *stats, bool take)
+{
+	if(stats == NULL)
+		return;
+
+	// Function calls of the file follow the calls of previous files
+	LogFuncCalls(stats->_func_calls_buffer.c_str(), stats->_func_calls_buffer.size());
+
+	if(take)
+		stats->_func_calls_buffer.clear();
+
+	for(size_t m = 0; m < _summary_maps.size(); m++)
+	{
+		std::map<std::string, StatsSummaryItem> &map = *_summary_maps[m];
+		std::map<std::string, StatsSummaryItem> &from = *stats->_summary_maps[m];
+
+		for(std::map<std::string, StatsSummaryItem>::iterator i = from.begin(); i != from.end(); i++)
+		{
+			std::list<StatsSnippetItem> snippets;
+
+			if(take)
+				snippets.splice(snippets.end(), i->second.snippets);
+
+			std::map<std::string, StatsSummaryItem>::iterator e = map.find(i->first);
+
+			if(e == map.end())
+			{
+				StatsSummaryItem &item = (map[i->first] = i->second);
+				item.snippets.splice(item.snippets.end(), snippets);
+				continue;
+			}
+
+			StatsSummaryItem &item = e->second;
+
+			item.occurrences += i->second.occurrences;
+			item.conv_undef += i->second.conv_undef;
+			item.conv_no_need += i->second.conv_no_need;
+			item.conv_ok += i->second.conv_ok;
+			item.conv_warn += i->second.conv_warn;
+			item.conv_error += i->second.conv_error;
+			item.complexity_very_low += i->second.complexity_very_low;
+			item.complexity_low += i->second.complexity_low;
+			item.complexity_medium += i->second.complexity_medium;
+			item.complexity_high += i->second.complexity_high;
+			item.complexity_very_high += i->second.complexity_very_high;
+
+			if(take)
+				item.snippets.splice(item.snippets.end(), snippets);
+			else
+				item.snippets.insert(item.snippets.end(), i->second.snippets.begin(), i->second.snippets.end());
+		}
+	}
+
+	for(size_t m = 0; m < _detail_maps.size(); m++)
+	{
+		std::map<std::string, StatsDetailItem> &map = *_detail_maps[m];
+		std::map<std::string, StatsDetailItem> &from = *stats->_detail_maps[m];
+
+		for(std::map<std::string, StatsDetailItem>::iterator i = from.begin(); i != from.end(); i++)
+		{
+			std::list<StatsSnippetItem> snippets;
+
+			if(take)
+				snippets.splice(snippets.end(), i->second.snippets);
+
+			std::map<std::string, StatsDetailItem>::iterator e = map.find(i->first);
+
+			// Each detailed item has the same properties for all occurrences
+			if(e == map.end())
+			{
+				StatsDetailItem &item = (map[i->first] = i->second);
+				item.snippets.splice(item.snippets.end(), snippets);
+				continue;
+			}
+
+			e->second.count += i->second.count;
+
+			if(take)
+				e->second.snippets.splice(e->second.snippets.end(), snippets);
+			else
+				e->second.snippets.insert(e->second.snippets.end(), i->second.snippets.begin(), i->second.snippets.end());
+		}
+	}
+
+	for(size_t m = 0; m < _item_maps.size(); m++)
+	{
+		std::map<std::string, StatsItem> &map = *_item_maps[m];
+		std::map<std::string, StatsItem> &from = *stats->_item_maps[m];
+
+		for(std::map<std::string, StatsItem>::iterator i = from.begin(); i != from.end(); i++)
+		{
+			std::map<std::string, StatsItem>::iterator e = map.find(i->first);
+
+			if(e == map.end())
+				map[i->first] = i->second;
+			else
+				e->second.occurrences += i->second.occurrences;
+		}
+	}
+
+	for(size_t m = 0; m < _count_maps.size(); m++)
+	{
+		std::map<std::string, int> &map = *_count_maps[m];
+		std::map<std::string, int> &from = *stats->_count_maps[m];
+
+		for(std::map<std::string, int>::iterator i = from.begin(); i != from.end(); i++)
+			map[i->first] += i->second;
+	}
+}
+
+// Helpers to save and load statistics
+static void WriteInt(FILE *file, int value)
+{
+	fwrite(&value, sizeof(value), 1, file);
+}
+
+static void WriteString(FILE *file, const std::string &value)
+{
+	WriteInt(file, (int)value.size());
+	fwrite(value.c_str(), 1, value.size(), file);
+}
+
+static void WriteSnippets(FILE *file, std::list<StatsSnippetItem> &snippets)
+{
+	WriteInt(file, (int)snippets.size());
+
+	for(std::list<StatsSnippetItem>::iterator i = snippets.begin(); i != snippets.end(); i++)
+	{
+		WriteString(file, i->filename);
+		WriteInt(file, i->line);
+		WriteString(file, i->snippet);
+	}
+}
+
+static bool ReadInt(FILE *file, int *value)
+{
+	return fread(value, sizeof(int), 1, file) == 1;
+}
+
+static bool ReadString(FILE *file, std::string &value)
+{
+	int len = 0;
+
+	if(!ReadInt(file, &len) || len < 0)
+		return false;
+
+	value.resize((size_t)len);
+
+	return len == 0 || fread(&value[0], 1, (size_t)len, file) == (size_t)len;
+}
+
+static bool ReadSnippets(FILE *file, std::list<StatsSnippetItem> &snippets)
+{
+	int count = 0;
+
+	if(!ReadInt(file, &count) || count < 0)
+		return false;
+
+	for(int i = 0; i < count; i++)
+	{
+		snippets.push_back(StatsSnippetItem());
+		StatsSnippetItem &item = snippets.back();
+
+		if(!ReadString(file, item.filename) || !ReadInt(file, &item.line) || !ReadString(file, item.snippet))
+			return false;
+	}
+
+	return true;
+}
+
+// Save statistics to the file
+int Stats::Write(const char *file, int lines)
+{
+	if(file == NULL)
+		return -1;
+
+	// Write to a temporary file first, so concurrent runs never read partial statistics
+	std::string tmp;
+	File::GetTempName(file, tmp);
+
+	FILE *out = fopen(tmp.c_str(), "wb");
+
+	if(out == NULL)
+		return -1;
+
+	setvbuf(out, NULL, _IOFBF, SQLEXEC_STAT_FILE_BUFFER);
+
+	char magic[16];
+	memset(magic, 0, sizeof(magic));
+	strcpy(magic, SQLEXEC_STATS_MAGIC);
+
+	fwrite(magic, 1, sizeof(magic), out);
+	WriteInt(out, SQLEXEC_STATS_VERSION);
+	WriteInt(out, lines);
+
+	for(size_t m = 0; m < _summary_maps.size(); m++)
+	{
+		std::map<std::string, StatsSummaryItem> &map = *_summary_maps[m];
+		WriteInt(out, (int)map.size());
+
+		for(std::map<std::string, StatsSummaryItem>::iterator i = map.begin(); i != map.end(); i++)
+		{
+			StatsSummaryItem &item = i->second;
+
+			WriteString(out, i->first);
+			WriteString(out, item.desc);
+			WriteInt(out, item.occurrences);
+			WriteInt(out, item.conv_undef);
+			WriteInt(out, item.conv_no_need);
+			WriteInt(out, item.conv_ok);
+			WriteInt(out, item.conv_warn);
+			WriteInt(out, item.conv_error);
+			WriteInt(out, item.complexity_very_low);
+			WriteInt(out, item.complexity_low);
+			WriteInt(out, item.complexity_medium);
+			WriteInt(out, item.complexity_high);
+			WriteInt(out, item.complexity_very_high);
+			WriteSnippets(out, item.snippets);
+		}
+	}
+
+	for(size_t m = 0; m < _detail_maps.size(); m++)
+	{
+		std::map<std::string, StatsDetailItem> &map = *_detail_maps[m];
+		WriteInt(out, (int)map.size());
+
+		for(std::map<std::string, StatsDetailItem>::iterator i = map.begin(); i != map.end(); i++)
+		{
+			StatsDetailItem &item = i->second;
+
+			WriteString(out, i->first);
+			WriteInt(out, item.count);
+			WriteInt(out, item.conv_status);
+			WriteString(out, item.desc);
+			WriteString(out, item.note);
+			WriteString(out, item.link);
+			WriteInt(out, item.complexity);
+			WriteSnippets(out, item.snippets);
+		}
+	}
+
+	for(size_t m = 0; m < _item_maps.size(); m++)
+	{
+		std::map<std::string, StatsItem> &map = *_item_maps[m];
+		WriteInt(out, (int)map.size());
+
+		for(std::map<std::string, StatsItem>::iterator i = map.begin(); i != map.end(); i++)
+		{
+			WriteString(out, i->first);
+			WriteInt(out, i->second.occurrences);
+			WriteString(out, i->second.t_value);
+			WriteInt(out, i->second.conv_status);
+			WriteString(out, i->second.notes);
+		}
+	}
+
+	for(size_t m = 0; m < _count_maps.size(); m++)
+	{
+		std::map<std::string, int> &map = *_count_maps[m];
+		WriteInt(out, (int)map.size());
+
+		for(std::map<std::string, int>::iterator i = map.begin(); i != map.end(); i++)
+		{
+			WriteString(out, i->first);
+			WriteInt(out, i->second);
+		}
+	}
+
+	// Function calls are replayed to the log when the file is taken from the cache
+	WriteString(out, _func_calls_buffer);
+
+	// Terminating mark shows that statistics were written completely
+	fwrite(magic, 1, sizeof(magic), out);
+
+	bool failed = (ferror(out) != 0);
+
+	if(fclose(out) != 0 || failed)
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+#ifdef WIN32
+	// rename() does not replace an existing file on Windows
+	remove(file);
+#endif
+
+	if(rename(tmp.c_str(), file) != 0)
+	{
+		remove(tmp.c_str());
+		return -1;
+	}
+
+	return 0;
+}
+
+// Load statistics from the file
+int Stats::Read(const char *file, int *lines)
+{
+	if(file == NULL)
+		return -1;
+
+	FILE *in = fopen(file, "rb");
+
+	if(in == NULL)
+		return -1;
+
+	setvbuf(in, NULL, _IOFBF, SQLEXEC_STAT_FILE_BUFFER);
+
+	char magic[16];
+	char expected[16];
+
+	memset(expected, 0, sizeof(expected));
+	strcpy(expected, SQLEXEC_STATS_MAGIC);
+
+	int version = 0;
+	int num = 0;
+
+	bool valid = (fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, expected, sizeof(magic)) == 0 &&
+		ReadInt(in, &version) && version == SQLEXEC_STATS_VERSION && ReadInt(in, &num));
+
+	for(size_t m = 0; valid && m < _summary_maps.size(); m++)
+	{
+		std::map<std::string, StatsSummaryItem> &map = *_summary_maps[m];
+		int count = 0;
+
+		valid = ReadInt(in, &count);
+
+		for(int i = 0; valid && i < count; i++)
+		{
+			std::string key;
+
+			if(!ReadString(in, key))
+			{
+				valid = false;
+				break;
+			}
+
+			StatsSummaryItem &item = map[key];
+
+			valid = (ReadString(in, item.desc) && ReadInt(in, &item.occurrences) && ReadInt(in, &item.conv_undef) &&
+				ReadInt(in, &item.conv_no_need) && ReadInt(in, &item.conv_ok) && ReadInt(in, &item.conv_warn) &&
+				ReadInt(in, &item.conv_error) && ReadInt(in, &item.complexity_very_low) && ReadInt(in, &item.complexity_low) &&
+				ReadInt(in, &item.complexity_medium) && ReadInt(in, &item.complexity_high) && 
+				ReadInt(in, &item.complexity_very_high) && ReadSnippets(in, item.snippets));
+		}
+	}
+
+	for(size_t m = 0; valid && m < _detail_maps.size(); m++)
+	{
+		std::map<std::string, StatsDetailItem> &map = *_detail_maps[m];
+		int count = 0;
+
+		valid = ReadInt(in, &count);
+
+		for(int i = 0; valid && i < count; i++)
+		{
+			std::string key;
+
+			if(!ReadString(in, key))
+			{
+				valid = false;
+				break;
+			}
+
+			StatsDetailItem &item = map[key];
+
+			valid = (ReadInt(in, &item.count) && ReadInt(in, &item.conv_status) && ReadString(in, item.desc) &&
+				ReadString(in, item.note) && ReadString(in, item.link) && ReadInt(in, &item.complexity) &&
+				ReadSnippets(in, item.snippets));
+		}
+	}
+
+	for(size_t m = 0; valid && m < _item_maps.size(); m++)
+	{
+		std::map<std::string, StatsItem> &map = *_item_maps[m];
+		int count = 0;
+
+		valid = ReadInt(in, &count);
+
+		for(int i = 0; valid && i < count; i++)
+		{
+			std::string key;
+
+			if(!ReadString(in, key))
+			{
+				valid = false;
+				break;
+			}
+
+			StatsItem &item = map[key];
+
+			valid = (ReadInt(in, &item.occurrences) && ReadString(in, item.t_value) && ReadInt(in, &item.conv_status) &&
+				ReadString(in, item.notes));
+		}
+	}
+
+	for(size_t m = 0; valid && m < _count_maps.size(); m++)
+	{
+		std::map<std::string, int> &map = *_count_maps[m];
+		int count = 0;
+
+		valid = ReadInt(in, &count);
+
+		for(int i = 0; valid && i < count; i++)
+		{
+			std::string key;
+			int value = 0;
+
+			valid = (ReadString(in, key) && ReadInt(in, &value));
+
+			if(valid)
+				map[key] = value;
+		}
+	}
+
+	if(valid)
+		valid = ReadString(in, _func_calls_buffer);
+
+	// Check the terminating mark
+	if(valid)
+		valid = (fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, expected, sizeof(magic)) == 0);
+
+	fclose(in);
+
+	if(!valid)
+		return -1;
+
+	if(lines != NULL)
+		*lines = num;
+
+	return 0;
+}
@@ -19,9 +19,11 @@
 #ifndef sqlexec_stats_h
 #define sqlexec_stats_h
 
+#include <stdio.h>
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 #include "token.h"
 
 // Conversion status
@@ -108,6 +110,12 @@
 #define STATS_ITM_CONV_ERROR                          STATS_ITM_CONV(STATS_CONV_ERROR)
 
 #define SQLEXEC_STAT_FILE                             "sqlines_func_calls.txt"
+#define SQLEXEC_STAT_FILE_BUFFER                      (256*1024)
+
+// Statistics saved for a single file (incremental assessment)
+#define SQLEXEC_STATS_MAGIC                           "SQLINES_STATS"
+#define SQLEXEC_STATS_VERSION                         2
+#define SQLEXEC_STATS_EXT                             ".stats"
 
 struct StatsDetailItem;
 struct StatsSnippetItem;
@@ -194,6 +202,7 @@ struct StatsSnippetItem
 	// Source code snippet
 	std::string snippet;
 
+	StatsSnippetItem() { line = 0; }
 	StatsSnippetItem(std::string &f, Token *start, Token *end);
 };
 
@@ -266,6 +275,17 @@ public:
 	// Relative path to the current file
 	std::string _source_current_file;
 
+	// Function calls log, opened on the first call and kept open
+	FILE *_func_calls_file;
+	// Function calls kept in memory until the statistics are merged (parallel and incremental assessment)
+	bool _func_calls_buffered;
+	std::string _func_calls_buffer;
+	// Buffers reused for each logged function call
+	std::string _func_call_src;
+	std::string _func_call_tgt;
+	std::string _func_call_src_meta;
+	std::string _func_call_tgt_meta;
+
     // Constructor/destructor
     Stats();
     ~Stats();
@@ -355,6 +375,28 @@ public:
 
 	// Set the current source file
 	void SetSourceFile(const char *f) { _source_current_file = f; }
+
+	// Keep logged function calls in memory, they are written when the statistics are merged
+	void SetFuncCallsBuffered() { _func_calls_buffered = true; }
+
+	// Add statistics collected for another file, snippets are moved when the merged object is not used anymore
+	void Merge(Stats *stats, bool take = false);
+
+	// Save and load statistics (per-file results of incremental assessment)
+	int Write(const char *file, int lines);
+	int Read(const char *file, int *lines);
+
+private:
+	// All collections by item type, in the same order for every object
+	std::vector<std::map<std::string, StatsSummaryItem>*> _summary_maps;
+	std::vector<std::map<std::string, StatsDetailItem>*> _detail_maps;
+	std::vector<std::map<std::string, StatsItem>*> _item_maps;
+	std::vector<std::map<std::string, int>*> _count_maps;
+
+	void RegisterMaps();
+
+	// Write function call records to the log
+	void LogFuncCalls(const char *records, size_t len);
 };
 
 #endif // sqlexec_stats_h
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
 #include <string>
 #include "str.h"
 
@@ -225,6 +226,39 @@ char* Str::IntToString(int int_value, char *output)
 	return output;
 }
 
+// Get a field until one of delimiters or end of string, trailing spaces are not included
+char* Str::GetField(const char *input, const char *delimiters, std::string &output)
+{
+	if(input == NULL || delimiters == NULL)
+		return (char*)input;
+
+	size_t len = strcspn(input, delimiters);
+	size_t nlen = len;
+
+	while(nlen && input[nlen-1] == ' ')
+		nlen--;
+
+	// Copy the field at once
+	output.assign(input, nlen);
+
+	return (char*)input + len;
+}
+
+// Get 64-bit FNV-1a hash of the data, the previous hash can be passed to continue hashing
+unsigned long long Str::Hash(const char *input, size_t len, unsigned long long hash)
+{
+	if(input == NULL)
+		return hash;
+
+	for(size_t i = 0; i < len; i++)
+	{
+		hash ^= (unsigned char)input[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
 // Replace the first occurrence of a substring
 void Str::ReplaceFirst(std::string &str, std::string what, std::string with)
 {
@@ -235,6 +269,16 @@ void Str::ReplaceFirst(std::string &str, std::string what, std::string with)
 		str.replace(pos, what.size(), with);
 }
 
+// Append a substring converted to lower case
+void Str::AppendLower(std::string &output, const char *input, size_t len)
+{
+	if(input == NULL)
+		return;
+
+	for(size_t i = 0; i < len; i++)
+		output += (char)tolower((unsigned char)input[i]);
+}
+
 // Convert size in bytes to string with MB, GB
 char* Str::FormatByteSize(double bytes, char *output)
 {
@@ -58,9 +58,18 @@ public:
 	// Convert int to string
 	static char* IntToString(int int_value, char *output);
 
+	// Get a field until one of delimiters or end of string, trailing spaces are not included
+	static char* GetField(const char *input, const char *delimiters, std::string &output);
+
+	// Get 64-bit FNV-1a hash of the data, the previous hash can be passed to continue hashing
+	static unsigned long long Hash(const char *input, size_t len, unsigned long long hash = 14695981039346656037ULL);
+
 	// Replace the first occurrence of a substring
 	static void ReplaceFirst(std::string &str, std::string what, std::string with);
 
+	// Append a substring converted to lower case
+	static void AppendLower(std::string &output, const char *input, size_t len);
+
 	// Get next item in list
 	static char* GetNextInList(const char *input, std::string &output);
 